@@ -76,6 +76,10 @@ async function startServer(context: vscode.ExtensionContext): Promise<vscode.Dis
             ).fsPath,
             tlbLangWasmUri: vscode_uri.joinPath(context.extensionUri, "./dist/tree-sitter-tlb.wasm")
                 .fsPath,
+            tactLangNativeBindingPath: vscode_uri.joinPath(
+                context.extensionUri,
+                "./dist/tree_sitter_tact_binding.node",
+            ).fsPath,
         } as ClientOptions,
     }
 
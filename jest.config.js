@@ -7,6 +7,11 @@ module.exports = {
         "^.+\\.tsx?$": "ts-jest",
     },
     testPathIgnorePatterns: ["e2e/"],
+    setupFiles: ["<rootDir>/jest.setup.js"],
     testRegex: "(/__tests__/.*|(\\.|/)(test|spec))\\.tsx?$",
+    moduleNameMapper: {
+        "^@server/(.*)$": "<rootDir>/server/src/$1",
+        "^@shared/(.*)$": "<rootDir>/shared/src/$1",
+    },
     moduleFileExtensions: ["ts", "tsx", "js", "jsx", "json", "node"],
 }
@@ -0,0 +1,2 @@
+// Reads of deleted WASM trees throw in tests, see `guardDeletedTrees` in server/src/parser.ts.
+process.env["TACT_LS_CHECK_DELETED_TREES"] = "true"
@@ -0,0 +1,89 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import type * as lsp from "vscode-languageserver"
+import {AnalysisScheduler} from "./analysis-scheduler"
+
+const DELAY_MS = 20
+
+async function sleep(ms: number): Promise<void> {
+    return new Promise(resolve => setTimeout(resolve, ms))
+}
+
+function scheduler(): {
+    scheduler: AnalysisScheduler
+    updates: string[]
+    analyses: {version: number; token: lsp.CancellationToken}[]
+} {
+    const updates: string[] = []
+    const analyses: {version: number; token: lsp.CancellationToken}[] = []
+    const scheduler = new AnalysisScheduler(
+        DELAY_MS,
+        uri => updates.push(uri),
+        async (_uri, version, token) => {
+            analyses.push({version, token})
+        },
+    )
+    return {scheduler, updates, analyses}
+}
+
+describe("AnalysisScheduler", () => {
+    it("should coalesce changes made in a burst", async () => {
+        const {scheduler: s, updates, analyses} = scheduler()
+        s.changed("a.tact", 2)
+        s.changed("a.tact", 3)
+        s.changed("a.tact", 4)
+        await sleep(DELAY_MS * 3)
+
+        expect(updates).toEqual(["a.tact"])
+        expect(analyses.map(it => it.version)).toEqual([4])
+    })
+
+    it("should cancel the analysis of a superseded version", async () => {
+        const {scheduler: s, analyses} = scheduler()
+        s.changed("a.tact", 2)
+        await sleep(DELAY_MS * 3)
+        const token = s.token("a.tact")
+
+        s.changed("a.tact", 3)
+        expect(analyses[0].token.isCancellationRequested).toBe(true)
+        expect(token.isCancellationRequested).toBe(true)
+        expect(s.token("a.tact").isCancellationRequested).toBe(false)
+        s.closed("a.tact")
+    })
+
+    it("should apply pending changes on flush", () => {
+        const {scheduler: s, updates, analyses} = scheduler()
+        s.changed("a.tact", 2)
+        s.flush("a.tact")
+        s.flush("a.tact")
+
+        expect(updates).toEqual(["a.tact"])
+        expect(analyses.map(it => it.version)).toEqual([2])
+    })
+
+    it("should report a failed update and keep scheduling later changes", async () => {
+        const errors = jest.spyOn(console, "error").mockImplementation(() => {})
+        const analyses: number[] = []
+        let fail = true
+        const s = new AnalysisScheduler(
+            DELAY_MS,
+            () => {
+                if (fail) throw new Error("update failed")
+            },
+            async (_uri, version) => {
+                analyses.push(version)
+            },
+        )
+
+        s.changed("a.tact", 2)
+        await sleep(DELAY_MS * 3)
+        expect(errors).toHaveBeenCalledWith("Update of a.tact failed:", expect.any(Error))
+        expect(analyses).toEqual([])
+
+        fail = false
+        s.changed("a.tact", 3)
+        await sleep(DELAY_MS * 3)
+        expect(analyses).toEqual([3])
+        errors.mockRestore()
+    })
+})
@@ -0,0 +1,93 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import * as lsp from "vscode-languageserver"
+
+export const ANALYSIS_DELAY_MS = Number(process.env["TACT_LS_ANALYSIS_DELAY_MS"] ?? 150)
+
+interface DocumentState {
+    readonly version: number
+    readonly source: lsp.CancellationTokenSource
+    timer: NodeJS.Timeout | null
+}
+
+/**
+ * Coalesces changes of each open document made within `delayMs` of each other
+ * into a single update followed by an analysis of the resulting version.
+ *
+ * Work for a version is cancelled as soon as a newer version arrives, so while
+ * the user is typing, neither parsing nor inspections run for versions that are
+ * already stale. Requests that need the latest version call `flush` first.
+ */
+export class AnalysisScheduler {
+    private readonly documents: Map<string, DocumentState> = new Map()
+
+    public constructor(
+        private readonly delayMs: number,
+        /** Brings the parsed file and the index of the document up to date. */
+        private readonly update: (uri: string) => void,
+        /** Analyzes `version` of the document, giving up once `token` is cancelled. */
+        private readonly analyze: (
+            uri: string,
+            version: number,
+            token: lsp.CancellationToken,
+        ) => Promise<void>,
+    ) {}
+
+    public changed(uri: string, version: number): void {
+        this.cancel(uri)
+
+        const state: DocumentState = {
+            version,
+            source: new lsp.CancellationTokenSource(),
+            timer: null,
+        }
+        state.timer = setTimeout(() => {
+            this.run(uri, state)
+        }, this.delayMs)
+        this.documents.set(uri, state)
+    }
+
+    /** Applies pending changes of `uri` right away, its analysis follows as usual. */
+    public flush(uri: string): void {
+        const state = this.documents.get(uri)
+        if (state?.timer) {
+            clearTimeout(state.timer)
+            this.run(uri, state)
+        }
+    }
+
+    /** Token cancelled once a version of `uri` newer than the current one arrives. */
+    public token(uri: string): lsp.CancellationToken {
+        return this.documents.get(uri)?.source.token ?? lsp.CancellationToken.None
+    }
+
+    public closed(uri: string): void {
+        this.flush(uri)
+        this.cancel(uri)
+        this.documents.delete(uri)
+    }
+
+    private cancel(uri: string): void {
+        const state = this.documents.get(uri)
+        if (!state) return
+        if (state.timer) {
+            clearTimeout(state.timer)
+        }
+        state.source.cancel()
+        state.source.dispose()
+    }
+
+    private run(uri: string, state: DocumentState): void {
+        state.timer = null
+        try {
+            this.update(uri)
+        } catch (error) {
+            // thrown from a timer, it would take down the server
+            console.error(`Update of ${uri} failed:`, error)
+            return
+        }
+        this.analyze(uri, state.version, state.source.token).catch((error: unknown) => {
+            console.error(`Analysis of ${uri} failed:`, error)
+        })
+    }
+}
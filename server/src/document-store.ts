@@ -2,9 +2,12 @@
 //  Copyright © 2025 TON Studio
 import * as lsp from "vscode-languageserver"
 import {TextDocuments} from "vscode-languageserver"
-import {TextDocument} from "vscode-languageserver-textdocument"
+import type {TextDocument} from "vscode-languageserver-textdocument"
+import {Rope} from "@server/utils/Rope"
 
 export interface TextDocumentChange2 {
+    /** Version of the document the first of `changes` was applied to. */
+    readonly baseVersion: number
     readonly changes: {
         readonly range: lsp.Range
         readonly rangeOffset: number
@@ -13,50 +16,113 @@ export interface TextDocumentChange2 {
     }[]
 }
 
-export class DocumentStore extends TextDocuments<TextDocument> {
+/**
+ * A `TextDocument` kept as a {@link Rope}: an edit copies only the path to the
+ * changed chunk instead of the whole text, and every version shares the rest
+ * with the previous one. The flat text is built only if `getText()` is called.
+ */
+export class RopeDocument implements TextDocument {
+    public constructor(
+        public readonly uri: string,
+        public readonly languageId: string,
+        public readonly version: number,
+        public readonly text: Rope,
+    ) {}
+
+    public static create(
+        uri: string,
+        languageId: string,
+        version: number,
+        content: string,
+    ): RopeDocument {
+        return new RopeDocument(uri, languageId, version, Rope.fromString(content))
+    }
+
+    public get lineCount(): number {
+        return this.text.lineCount
+    }
+
+    public getText(range?: lsp.Range): string {
+        if (!range) return this.text.toString()
+        return this.text.slice(this.offsetAt(range.start), this.offsetAt(range.end))
+    }
+
+    public offsetAt(position: lsp.Position): number {
+        return this.text.offsetAt(position)
+    }
+
+    public positionAt(offset: number): lsp.Position {
+        return this.text.positionAt(offset)
+    }
+
+    public update(change: lsp.TextDocumentContentChangeEvent, version: number): RopeDocument {
+        if (!lsp.TextDocumentContentChangeEvent.isIncremental(change)) {
+            return RopeDocument.create(this.uri, this.languageId, version, change.text)
+        }
+        const start = this.offsetAt(change.range.start)
+        const end = this.offsetAt(change.range.end)
+        const text = this.text.replace(Math.min(start, end), Math.max(start, end), change.text)
+        return new RopeDocument(this.uri, this.languageId, version, text)
+    }
+}
+
+export class DocumentStore extends TextDocuments<RopeDocument> {
+    // Incremental changes applied to each document since they were last taken,
+    // see `takeChanges`. Dropped when a document gets replaced as a whole.
+    private readonly pendingChanges: Map<string, TextDocumentChange2> = new Map()
+
     public constructor(_connection: lsp.Connection) {
         super({
-            create: TextDocument.create,
+            create: (uri, languageId, version, content) =>
+                RopeDocument.create(uri, languageId, version, content),
             update: (doc, changes, version) => {
-                const event: TextDocumentChange2 = {changes: []}
+                let event: TextDocumentChange2 | undefined = this.pendingChanges.get(doc.uri) ?? {
+                    baseVersion: doc.version,
+                    changes: [],
+                }
 
+                // Offsets of every change are relative to the text after the previous
+                // ones, so apply them one by one.
+                let document = doc
                 for (const change of changes) {
                     if (!lsp.TextDocumentContentChangeEvent.isIncremental(change)) {
-                        break
+                        event = undefined
+                    } else if (event) {
+                        const rangeOffset = document.offsetAt(change.range.start)
+                        event.changes.push({
+                            text: change.text,
+                            range: change.range,
+                            rangeOffset,
+                            rangeLength:
+                                // eslint-disable-next-line @typescript-eslint/no-deprecated
+                                change.rangeLength ??
+                                document.offsetAt(change.range.end) - rangeOffset,
+                        })
                     }
-                    const rangeOffset = doc.offsetAt(change.range.start)
-                    event.changes.push({
-                        text: change.text,
-                        range: change.range,
-                        rangeOffset,
-                        rangeLength:
-                            // eslint-disable-next-line @typescript-eslint/no-deprecated
-                            change.rangeLength ?? doc.offsetAt(change.range.end) - rangeOffset,
-                    })
+                    document = document.update(change, version)
+                }
+
+                if (event) {
+                    this.pendingChanges.set(doc.uri, event)
+                } else {
+                    this.pendingChanges.delete(doc.uri)
                 }
-                return TextDocument.update(doc, changes, version)
+                return document
             },
         })
 
+        this.onDidClose(event => this.pendingChanges.delete(event.document.uri))
         super.listen(_connection)
     }
-}
-
-export function getOffsetFromPosition(fileContent: string, line: number, column: number): number {
-    const lines = fileContent.split("\n")
-    if (line < 0 || line > lines.length) {
-        return 0
-    }
-
-    const targetLine = lines[line]
-    if (column < 1 || column > targetLine.length + 1) {
-        return 0
-    }
 
-    let offset = 0
-    for (let i = 0; i < line; i++) {
-        offset += lines[i].length + 1 // +1 for '\n'
+    /**
+     * Returns the incremental changes made to `uri` since the last call, in the
+     * order they were applied, or `undefined` if the document was replaced as a
+     * whole in the meantime.
+     */
+    public takeChanges(uri: string): TextDocumentChange2 | undefined {
+        const changes = this.pendingChanges.get(uri)
+        this.pendingChanges.delete(uri)
+        return changes
     }
-    offset += column - 1
-    return offset
 }
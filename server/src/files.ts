@@ -2,13 +2,238 @@ import * as lsp from "vscode-languageserver"
 import {TextDocument} from "vscode-languageserver-textdocument"
 import {TactFile} from "@server/languages/tact/psi/TactFile"
 import {pathToFileURL} from "node:url"
-import {createTactParser} from "@server/parser"
+import {
+    TACT_PARSE_TIMEOUT_MS,
+    tactParseBatch,
+    tactParseInput,
+    tactParseOptions,
+    tactParsers,
+} from "@server/parser"
 import {readFileVFS, globalVFS} from "@server/vfs/files-adapter"
 import {URI} from "vscode-uri"
+import type {Edit} from "web-tree-sitter"
+import type {TextDocumentChange2} from "@server/document-store"
+import type {Rope} from "@server/utils/Rope"
+import {retainForRequest} from "@server/psi/File"
+import {createHash} from "node:crypto"
 
-export const PARSED_FILES_CACHE: Map<string, TactFile> = new Map()
+// web-tree-sitter doesn't report the memory used by a tree, so it is estimated
+// from the number of nodes.
+const ESTIMATED_TREE_BYTES_PER_NODE = 100
+
+const TREE_MEMORY_BUDGET_BYTES =
+    Number(process.env["TACT_LS_TREE_MEMORY_BUDGET_MB"] ?? 512) * 1024 * 1024
+
+/**
+ * Parsed files by URI, in least recently used order.
+ *
+ * The cache owns the first reference to every file it holds, see `File.retain`,
+ * and releases it when the file is replaced or removed, so the tree is deleted
+ * once requests that resolved into it are done too, see `retainForRequest`.
+ * Once the estimated size of the trees exceeds the budget, files that are
+ * neither open nor retained by someone else are evicted: only their text is
+ * kept, and they are parsed again the next time they are requested.
+ */
+export class ParsedFilesCache {
+    private readonly files: Map<string, {file: TactFile; bytes: number}> = new Map()
+    // Text of files that were evicted or not parsed yet.
+    private readonly evicted: Map<string, string | Rope> = new Map()
+    private readonly open: Set<string> = new Set()
+    // Hash of the text each file had when it didn't parse in time, see `timedOut`.
+    private readonly timedOutSources: Map<string, string> = new Map()
+    private bytes: number = 0
+    private trimScheduled: boolean = false
+
+    public constructor(private readonly budgetBytes: number) {}
+
+    /** Returns the file, parsing it again if it was evicted, and marks it as recently used. */
+    public get(uri: string): TactFile | undefined {
+        const entry = this.files.get(uri)
+        if (entry !== undefined) {
+            this.files.delete(uri)
+            this.files.set(uri, entry)
+            return retainForRequest(entry.file)
+        }
+
+        const source = this.evicted.get(uri)
+        if (source === undefined) return undefined
+        return reparseTactFile(uri, source)
+    }
+
+    /** Returns the file if its tree is in memory, without parsing or marking it. */
+    public peek(uri: string): TactFile | undefined {
+        return this.files.get(uri)?.file
+    }
+
+    public has(uri: string): boolean {
+        return this.files.has(uri) || this.evicted.has(uri)
+    }
+
+    public set(uri: string, file: TactFile): void {
+        const previous = this.files.get(uri)
+        if (previous?.file === file) return
+        if (previous !== undefined) {
+            this.bytes -= previous.bytes
+            this.files.delete(uri)
+            previous.file.release()
+        }
+        this.evicted.delete(uri)
+        if (this.timedOutSources.has(uri) && !this.timedOut(uri, file.source)) {
+            // the file changed since and parsed in time
+            this.timedOutSources.delete(uri)
+            reportParseTimeout(uri, false)
+        }
+
+        const bytes = file.rootNode.descendantCount * ESTIMATED_TREE_BYTES_PER_NODE
+        this.files.set(uri, {file, bytes})
+        this.bytes += bytes
+        this.scheduleTrim()
+    }
+
+    /** Keeps the text of a file that was not parsed yet, it is parsed when first requested. */
+    public setUnparsed(uri: string, source: string): void {
+        if (!this.files.has(uri)) {
+            this.evicted.set(uri, source)
+        }
+    }
+
+    public delete(uri: string): boolean {
+        const entry = this.files.get(uri)
+        if (entry !== undefined) {
+            this.bytes -= entry.bytes
+            this.files.delete(uri)
+            entry.file.release()
+        }
+        if (this.timedOutSources.delete(uri)) {
+            reportParseTimeout(uri, false)
+        }
+        return this.evicted.delete(uri) || entry !== undefined
+    }
+
+    /** Records that `source` of `uri` didn't parse within `TACT_PARSE_TIMEOUT_MS`. */
+    public markTimedOut(uri: string, source: string | Rope): void {
+        this.timedOutSources.set(uri, sourceHash(source))
+        reportParseTimeout(uri, true)
+    }
+
+    /**
+     * Whether `source` of `uri` already didn't parse in time. The mark outlives
+     * eviction of the file, so the same text isn't parsed, and the parser
+     * stalled, again every time the file is requested.
+     */
+    public timedOut(uri: string, source: string | Rope): boolean {
+        const hash = this.timedOutSources.get(uri)
+        return hash !== undefined && hash === sourceHash(source)
+    }
+
+    /** URIs of all files, parsed or not. */
+    public uris(): string[] {
+        return [...this.files.keys(), ...this.evicted.keys()]
+    }
+
+    /** Returns the text of the file without parsing it. */
+    public source(uri: string): string | Rope | undefined {
+        return this.files.get(uri)?.file.source ?? this.evicted.get(uri)
+    }
+
+    public *values(): Generator<TactFile> {
+        for (const [, file] of this.entries()) {
+            yield file
+        }
+    }
+
+    /** All files, parsing the evicted ones again. */
+    public *entries(): Generator<[string, TactFile]> {
+        for (const uri of this.uris()) {
+            const file = this.get(uri)
+            if (file !== undefined) {
+                yield [uri, file]
+            }
+        }
+    }
+
+    /** Marks `uri` as open in the editor, open files are never evicted. */
+    public opened(uri: string): void {
+        this.open.add(uri)
+    }
+
+    public closed(uri: string): void {
+        this.open.delete(uri)
+        this.scheduleTrim()
+    }
+
+    // Evicting right away could evict files an operation is still going through,
+    // like a search over all files parsing the evicted ones, which would then be
+    // parsed again, so the budget is enforced after the current operation.
+    private scheduleTrim(): void {
+        if (this.trimScheduled || this.bytes <= this.budgetBytes) return
+        this.trimScheduled = true
+        setImmediate(() => {
+            this.trimScheduled = false
+            this.trim()
+        })
+    }
+
+    private trim(): void {
+        for (const [uri, {file, bytes}] of this.files) {
+            if (this.bytes <= this.budgetBytes) break
+            if (this.open.has(uri) || file.shared) continue
+
+            this.files.delete(uri)
+            this.evicted.set(uri, file.source)
+            this.bytes -= bytes
+            file.release()
+        }
+    }
+}
+
+function sourceHash(source: string | Rope): string {
+    const hash = createHash("sha1")
+    if (typeof source === "string") {
+        hash.update(source)
+    } else {
+        for (const chunk of source.chunks()) {
+            hash.update(chunk)
+        }
+    }
+    return hash.digest("hex")
+}
+
+export const PARSED_FILES_CACHE: ParsedFilesCache = new ParsedFilesCache(TREE_MEMORY_BUDGET_BYTES)
+
+// Applies changes of an open document that are still waiting to be parsed, set
+// by the server, see `AnalysisScheduler`.
+let flushPendingChanges: (uri: string) => void = () => {}
+
+export function setPendingChangesFlusher(flush: (uri: string) => void): void {
+    flushPendingChanges = flush
+}
+
+// Shows or clears the warning on a file that didn't parse in time, set by the
+// server, see `parseTimeoutDiagnostic`.
+let reportParseTimeout: (uri: string, timedOut: boolean) => void = () => {}
+
+export function setParseTimeoutReporter(report: (uri: string, timedOut: boolean) => void): void {
+    reportParseTimeout = report
+}
+
+/**
+ * Warning shown on a file that didn't parse within `TACT_PARSE_TIMEOUT_MS`: the
+ * file is treated as empty until it changes, so without it the file would
+ * silently have no completion, navigation or inspections.
+ */
+export function parseTimeoutDiagnostic(): lsp.Diagnostic {
+    return {
+        severity: lsp.DiagnosticSeverity.Warning,
+        range: lsp.Range.create(0, 0, 0, 0),
+        message: `Parsing this file took longer than ${TACT_PARSE_TIMEOUT_MS}ms, so it is treated as empty until it changes. The limit can be raised with the TACT_LS_PARSE_TIMEOUT_MS environment variable.`,
+        source: "tact",
+    }
+}
 
 export async function findTactFile(uri: string, changed: boolean = false): Promise<TactFile> {
+    flushPendingChanges(uri)
+
     const cached = PARSED_FILES_CACHE.get(uri)
     if (cached !== undefined && !changed) {
         return cached
@@ -23,16 +248,146 @@ export async function findTactFile(uri: string, changed: boolean = false): Promi
     return reparseTactFile(uri, content)
 }
 
-export function reparseTactFile(uri: string, content: string): TactFile {
-    const parser = createTactParser()
-    const tree = parser.parse(content)
+/**
+ * Reads and parses all files that are not cached yet. With the native parser,
+ * the files are parsed in parallel off the main thread.
+ */
+export async function findTactFiles(uris: readonly string[]): Promise<TactFile[]> {
+    const parseBatch = tactParseBatch()
+    const missing = uris.filter(uri => !PARSED_FILES_CACHE.has(uri))
+    if (parseBatch === undefined || missing.length === 0) {
+        const files: TactFile[] = []
+        for (const uri of uris) {
+            files.push(await findTactFile(uri))
+        }
+        return files
+    }
+
+    const contents = await Promise.all(
+        missing.map(async uri => {
+            const content = await readOrUndefined(uri)
+            if (content === undefined) {
+                console.error(`cannot read ${uri} file`)
+            }
+            return content ?? ""
+        }),
+    )
+
+    const trees = await parseBatch(contents, {timeoutMicros: TACT_PARSE_TIMEOUT_MS * 1000})
+    for (const [i, uri] of missing.entries()) {
+        const tree = trees[i]
+        const file = tree
+            ? new TactFile(uri, tree, contents[i])
+            : timedOutTactFile(uri, contents[i])
+        PARSED_FILES_CACHE.set(uri, file)
+    }
+
+    return Promise.all(uris.map(async uri => findTactFile(uri)))
+}
+
+/**
+ * Parses `content` of `uri` and caches the file. A rope is read by the parser
+ * chunk by chunk, without flattening it.
+ */
+export function reparseTactFile(
+    uri: string,
+    content: string | Rope,
+    version: number | undefined = undefined,
+): TactFile {
+    if (PARSED_FILES_CACHE.timedOut(uri, content)) {
+        const file = emptyTactFile(uri, content)
+        PARSED_FILES_CACHE.set(uri, file)
+        return retainForRequest(file)
+    }
+
+    const input = tactParseInput(content)
+    const tree = tactParsers.use(parser => parser.parse(input, null, tactParseOptions()))
+    const file = tree
+        ? new TactFile(uri, tree, content, undefined, version)
+        : timedOutTactFile(uri, content)
+    PARSED_FILES_CACHE.set(uri, file)
+    return retainForRequest(file)
+}
+
+/**
+ * Reparses version `version` of the open document `uri` after `changes` were
+ * applied to its cached version: the changes
+ * are applied to a copy of the cached tree with `Tree.edit`, so the parser only
+ * redoes the edited parts, and the returned file has the resulting
+ * `changedRanges`. Falls back to a full parse when there is nothing to reuse.
+ */
+export function editTactFile(
+    uri: string,
+    content: string | Rope,
+    version: number,
+    changes: TextDocumentChange2 | undefined,
+): TactFile {
+    const cached = PARSED_FILES_CACHE.get(uri)
+    // The cached file must be the version the changes were made to, it isn't if
+    // it was reread from disk in the meantime.
+    if (
+        cached === undefined ||
+        changes === undefined ||
+        changes.changes.length === 0 ||
+        cached.version !== changes.baseVersion
+    ) {
+        return reparseTactFile(uri, content, version)
+    }
+
+    // Edit a copy, the cached tree may still be in use by pending requests.
+    const oldTree = cached.tree.copy()
+    for (const change of changes.changes) {
+        oldTree.edit(treeEdit(change))
+    }
+
+    const input = tactParseInput(content)
+    const tree = tactParsers.use(parser => parser.parse(input, oldTree, tactParseOptions()))
     if (!tree) {
-        throw new Error(`FATAL ERROR: cannot parse ${uri} file`)
+        oldTree.delete()
+        const file = timedOutTactFile(uri, content)
+        PARSED_FILES_CACHE.set(uri, file)
+        return retainForRequest(file)
     }
 
-    const file = new TactFile(uri, tree, content)
+    const file = new TactFile(uri, tree, content, oldTree.getChangedRanges(tree), version)
+    oldTree.delete()
     PARSED_FILES_CACHE.set(uri, file)
-    return file
+    return retainForRequest(file)
+}
+
+function treeEdit(change: TextDocumentChange2["changes"][number]): Edit {
+    const {start, end} = change.range
+    const lines = change.text.split("\n")
+    const lastLine = lines[lines.length - 1]
+    return {
+        startIndex: change.rangeOffset,
+        oldEndIndex: change.rangeOffset + change.rangeLength,
+        newEndIndex: change.rangeOffset + change.text.length,
+        startPosition: {row: start.line, column: start.character},
+        oldEndPosition: {row: end.line, column: end.character},
+        newEndPosition: {
+            row: start.line + lines.length - 1,
+            column: lines.length === 1 ? start.character + lastLine.length : lastLine.length,
+        },
+    }
+}
+
+// A file that didn't parse within TACT_PARSE_TIMEOUT_MS is indexed as empty. It
+// keeps its text, which is not parsed again until it changes, see
+// `ParsedFilesCache.timedOut`, and has no document version, so its next change
+// is parsed from scratch.
+function timedOutTactFile(uri: string, content: string | Rope): TactFile {
+    console.warn(`Parsing ${uri} took longer than ${TACT_PARSE_TIMEOUT_MS}ms, treating it as empty`)
+    PARSED_FILES_CACHE.markTimedOut(uri, content)
+    return emptyTactFile(uri, content)
+}
+
+function emptyTactFile(uri: string, content: string | Rope): TactFile {
+    const tree = tactParsers.use(parser => parser.parse(""))
+    if (!tree) {
+        throw new Error(`FATAL ERROR: cannot parse ${uri} file`)
+    }
+    return new TactFile(uri, tree, content)
 }
 
 async function readOrUndefined(uri: string): Promise<string | undefined> {
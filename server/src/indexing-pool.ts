@@ -0,0 +1,154 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {Worker} from "node:worker_threads"
+import {existsSync} from "node:fs"
+import * as os from "node:os"
+import type {FileSummary} from "@server/languages/tact/indexes"
+
+// Files are handed out to workers in batches of this size, small enough to keep
+// all workers busy until the end and to report progress often.
+const BATCH_SIZE = 32
+
+/** Arguments of `initParser` in each worker. */
+export interface IndexingWorkerData {
+    readonly treeSitterUri: string
+    readonly tactLangUri: string
+    readonly tlbLangUri: string
+    readonly tactNativeBindingPath: string
+}
+
+/** A file read and summarized by an indexing worker. */
+export interface IndexedFile {
+    readonly uri: string
+    readonly content: string
+    readonly summary: FileSummary
+    // Whether the file didn't parse within `TACT_PARSE_TIMEOUT_MS`.
+    readonly timedOut: boolean
+}
+
+export type IndexingResponse =
+    | {readonly files: readonly IndexedFile[]}
+    | {readonly error: string; readonly files?: undefined}
+
+/**
+ * Worker threads that read, parse and summarize files for the initial indexing,
+ * see `indexing-worker.ts`. Trees can't leave the thread they were parsed on, so
+ * workers send back only the text and the summary of the declarations of each
+ * file, see `FileSummary`, and the main thread parses a file only once something
+ * needs its tree rather than its declarations.
+ */
+export class IndexingPool {
+    private constructor(private readonly workers: Worker[]) {
+        // a worker that crashed can't take batches anymore
+        for (const worker of workers) {
+            worker.once("exit", () => {
+                const index = this.workers.indexOf(worker)
+                if (index !== -1) {
+                    this.workers.splice(index, 1)
+                }
+            })
+        }
+    }
+
+    /**
+     * Starts `size` workers running `scriptPath`, or returns `null` if the script
+     * is missing, like when the server runs from sources.
+     */
+    public static create(
+        scriptPath: string,
+        data: IndexingWorkerData,
+        size: number = Math.max(1, os.cpus().length - 1),
+    ): IndexingPool | null {
+        if (!existsSync(scriptPath)) {
+            return null
+        }
+
+        const workers: Worker[] = []
+        for (let i = 0; i < size; i++) {
+            workers.push(new Worker(scriptPath, {workerData: data}))
+        }
+        return new IndexingPool(workers)
+    }
+
+    public get size(): number {
+        return this.workers.length
+    }
+
+    /**
+     * Indexes `uris` on all workers, calling `onBatch` on the main thread with
+     * every batch of indexed files as soon as it is ready.
+     */
+    public async index(
+        uris: readonly string[],
+        onBatch: (files: readonly IndexedFile[]) => void,
+    ): Promise<void> {
+        const batches: (readonly string[])[] = []
+        for (let i = 0; i < uris.length; i += BATCH_SIZE) {
+            batches.push(uris.slice(i, i + BATCH_SIZE))
+        }
+
+        // After a failure, the other workers stop taking new batches, and the
+        // batches they are working on are awaited so `onBatch` isn't called after
+        // this returns.
+        let next = 0
+        let failed = false
+        const results = await Promise.allSettled(
+            [...this.workers].map(async worker => {
+                while (!failed && next < batches.length) {
+                    const batch = batches[next++]
+                    try {
+                        onBatch(await IndexingPool.request(worker, batch))
+                    } catch (error) {
+                        failed = true
+                        throw error
+                    }
+                }
+            }),
+        )
+
+        for (const result of results) {
+            if (result.status === "rejected") {
+                throw result.reason
+            }
+        }
+        if (next < batches.length) {
+            throw new Error("No indexing workers left")
+        }
+    }
+
+    public async terminate(): Promise<void> {
+        await Promise.all(this.workers.map(async worker => worker.terminate()))
+    }
+
+    private static async request(
+        worker: Worker,
+        uris: readonly string[],
+    ): Promise<readonly IndexedFile[]> {
+        return new Promise((resolve, reject) => {
+            const onMessage = (response: IndexingResponse): void => {
+                worker.off("error", onError)
+                worker.off("exit", onExit)
+                if (response.files === undefined) {
+                    reject(new Error(response.error))
+                } else {
+                    resolve(response.files)
+                }
+            }
+            const onError = (error: Error): void => {
+                worker.off("message", onMessage)
+                worker.off("exit", onExit)
+                reject(error)
+            }
+            const onExit = (code: number): void => {
+                worker.off("message", onMessage)
+                worker.off("error", onError)
+                reject(new Error(`Indexing worker exited with code ${code}`))
+            }
+
+            worker.once("message", onMessage)
+            worker.once("error", onError)
+            worker.once("exit", onExit)
+            worker.postMessage(uris)
+        })
+    }
+}
@@ -4,7 +4,9 @@ import {glob} from "glob"
 import {index} from "@server/languages/tact/indexes"
 import {fileURLToPath} from "node:url"
 import * as path from "node:path"
-import {filePathToUri, findTactFile} from "@server/files"
+import {filePathToUri, findTactFiles, PARSED_FILES_CACHE} from "@server/files"
+import type {IndexingPool} from "@server/indexing-pool"
+import {retainingFiles} from "@server/psi/File"
 
 export enum IndexingRootKind {
     Stdlib = "stdlib",
@@ -17,7 +19,14 @@ export class IndexingRoot {
         public kind: IndexingRootKind,
     ) {}
 
-    public async index(): Promise<void> {
+    /**
+     * Indexes all files of the root, on the workers of `pool` if there is one.
+     * `onProgress` is called with the number of files indexed so far.
+     */
+    public async index(
+        pool: IndexingPool | null,
+        onProgress: (indexed: number, total: number) => void = () => {},
+    ): Promise<void> {
         const ignore =
             this.kind === IndexingRootKind.Stdlib
                 ? []
@@ -54,12 +63,40 @@ export class IndexingRoot {
         if (files.length === 0) {
             console.warn(`No file to index in ${this.root}`)
         }
-        for (const filePath of files) {
-            console.info("Indexing:", filePath)
-            const absPath = path.join(rootDir, filePath)
-            const uri = filePathToUri(absPath)
-            const file = await findTactFile(uri)
-            index.addFile(uri, file, false)
+
+        const uris = files.map(filePath => filePathToUri(path.join(rootDir, filePath)))
+        const start = Date.now()
+        let indexed = 0
+
+        if (pool) {
+            try {
+                await pool.index(uris, batch => {
+                    for (const {uri, content, summary, timedOut} of batch) {
+                        PARSED_FILES_CACHE.setUnparsed(uri, content)
+                        if (timedOut) {
+                            // not parsed again, and blocking the main thread, until it changes
+                            PARSED_FILES_CACHE.markTimedOut(uri, content)
+                        }
+                        index.addSummary(uri, summary)
+                    }
+                    indexed += batch.length
+                    onProgress(indexed, uris.length)
+                })
+            } catch (error) {
+                console.warn(`Cannot index ${this.root} on workers, using the main thread:`, error)
+            }
         }
+
+        // without workers, or the files left when they failed
+        const rest = uris.filter(uri => index.findFile(uri) === undefined)
+        await retainingFiles(async () => {
+            const parsed = await findTactFiles(rest)
+            for (const [i, file] of parsed.entries()) {
+                index.addFile(rest[i], file, false)
+                onProgress(++indexed, uris.length)
+            }
+        })()
+
+        console.info(`Indexed ${uris.length} files of ${this.root} in ${Date.now() - start}ms`)
     }
 }
@@ -0,0 +1,68 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+/**
+ * Entry point of the indexing workers, see `IndexingPool`. Each message is a
+ * batch of file URIs, answered with the text and the declaration summary of
+ * every file.
+ */
+import {parentPort, workerData} from "node:worker_threads"
+import {initParser, TACT_PARSE_TIMEOUT_MS, tactParseOptions, tactParsers} from "@server/parser"
+import {readFileVFS, globalVFS} from "@server/vfs/files-adapter"
+import {TactFile} from "@server/languages/tact/psi/TactFile"
+import {FileIndex} from "@server/languages/tact/indexes"
+import type {FileSummary} from "@server/languages/tact/indexes"
+import type {IndexedFile, IndexingResponse, IndexingWorkerData} from "@server/indexing-pool"
+
+const EMPTY_SUMMARY: FileSummary = {declarations: [], receivers: []}
+
+async function indexFile(uri: string): Promise<IndexedFile> {
+    const content = await readFileVFS(globalVFS, uri)
+    if (content === undefined) {
+        console.error(`cannot read ${uri} file`)
+        return {uri, content: "", summary: EMPTY_SUMMARY, timedOut: false}
+    }
+
+    const tree = tactParsers.use(parser => parser.parse(content, null, tactParseOptions()))
+    if (!tree) {
+        // treated as empty on the main thread, without parsing it again
+        console.warn(`Parsing ${uri} took longer than ${TACT_PARSE_TIMEOUT_MS}ms`)
+        return {uri, content, summary: EMPTY_SUMMARY, timedOut: true}
+    }
+
+    const file = new TactFile(uri, tree, content)
+    const summary = FileIndex.create(file).summary()
+    file.release()
+    return {uri, content, summary, timedOut: false}
+}
+
+async function main(): Promise<void> {
+    const port = parentPort
+    if (!port) return
+
+    const data = workerData as IndexingWorkerData
+    const ready = initParser(
+        data.treeSitterUri,
+        data.tactLangUri,
+        data.tlbLangUri,
+        data.tactNativeBindingPath,
+    )
+
+    port.on("message", (uris: readonly string[]) => {
+        void (async () => {
+            let response: IndexingResponse
+            try {
+                await ready
+                const files: IndexedFile[] = []
+                for (const uri of uris) {
+                    files.push(await indexFile(uri))
+                }
+                response = {files}
+            } catch (error) {
+                response = {error: error instanceof Error ? error.message : String(error)}
+            }
+            port.postMessage(response)
+        })()
+    })
+}
+
+void main()
@@ -1,17 +1,13 @@
 //  SPDX-License-Identifier: MIT
 //  Copyright © 2025 TON Studio
 import {
-    BouncedTy,
-    ContractTy,
     MapTy,
-    MessageTy,
     NullTy,
     OptionTy,
     PlaceholderTy,
     PrimitiveTy,
-    StructTy,
-    TraitTy,
     Ty,
+    TYPES,
 } from "@server/languages/tact/types/BaseTy"
 import {CallLike, Expression, NamedNode, TactNode} from "@server/languages/tact/psi/TactNode"
 import {Reference} from "@server/languages/tact/psi/Reference"
@@ -27,7 +23,7 @@ export class TypeInferer {
     }
 
     public inferType(node: TactNode): Ty | null {
-        return CACHE.typeCache.cached(node.node.id, () => this.inferTypeImpl(node))
+        return CACHE.typeCache.cached(node.file, node.node.id, () => this.inferTypeImpl(node))
     }
 
     private inferTypeImpl(node: TactNode): Ty | null {
@@ -52,7 +48,7 @@ export class TypeInferer {
                     node.node.text === "S" ||
                     node.node.text === "M"
                 ) {
-                    return new PlaceholderTy(node.node.text, new NamedNode(node.node, node.file))
+                    return TYPES.placeholder(new NamedNode(node.node, node.file))
                 }
                 return null
             }
@@ -63,7 +59,7 @@ export class TypeInferer {
                 !(inferred instanceof OptionTy) &&
                 node.node.nextSibling?.text === "?"
             ) {
-                return new OptionTy(inferred)
+                return TYPES.option(inferred)
             }
             return inferred
         }
@@ -128,7 +124,7 @@ export class TypeInferer {
         if (node.node.type === "bounced_type") {
             const innerTy = this.inferChildFieldType(node, "message")
             if (innerTy === null) return null
-            return new BouncedTy(innerTy)
+            return TYPES.bounced(innerTy)
         }
 
         if (node.node.type === "map_type") {
@@ -138,23 +134,10 @@ export class TypeInferer {
             const valueTy = this.inferChildFieldType(node, "value")
             if (valueTy === null) return null
 
-            if (keyTy instanceof PrimitiveTy) {
-                const tlb = node.node.childForFieldName("tlb_key")
-                const tlbType = tlb?.childForFieldName("type")
-                if (tlbType) {
-                    keyTy.tlb = tlbType.text
-                }
-            }
-
-            if (valueTy instanceof PrimitiveTy) {
-                const tlb = node.node.childForFieldName("tlb_value")
-                const tlbType = tlb?.childForFieldName("type")
-                if (tlbType) {
-                    valueTy.tlb = tlbType.text
-                }
-            }
-
-            return new MapTy(keyTy, valueTy)
+            return TYPES.map(
+                this.withTlb(keyTy, node.node.childForFieldName("tlb_key")),
+                this.withTlb(valueTy, node.node.childForFieldName("tlb_value")),
+            )
         }
 
         if (node.node.type === "instance_expression") {
@@ -178,13 +161,13 @@ export class TypeInferer {
         if (node.node.type === "initOf") {
             const stateInit = index.elementByName(IndexKey.Structs, "StateInit")
             if (!stateInit) return null
-            return new StructTy("StateInit", stateInit)
+            return TYPES.struct(stateInit)
         }
 
         if (node.node.type === "codeOf") {
             const cell = index.elementByName(IndexKey.Primitives, "Cell")
             if (!cell) return null
-            return new PrimitiveTy("Cell", cell, null)
+            return TYPES.primitive(cell)
         }
 
         if (node.node.type === "parenthesized_expression") {
@@ -295,7 +278,7 @@ export class TypeInferer {
                 if (!resultType) return type
 
                 if (type instanceof OptionTy) {
-                    return new OptionTy(resultType)
+                    return TYPES.option(resultType)
                 }
                 return resultType
             }
@@ -304,7 +287,7 @@ export class TypeInferer {
         }
 
         if (node.node.type === "null") {
-            return new NullTy()
+            return TYPES.nullTy
         }
 
         if (node.node.type === "unary_expression") {
@@ -367,11 +350,11 @@ export class TypeInferer {
             if (!trueType) return falseType
 
             if (trueType instanceof NullTy) {
-                return new OptionTy(falseType)
+                return TYPES.option(falseType)
             }
 
             if (falseType instanceof NullTy) {
-                return new OptionTy(trueType)
+                return TYPES.option(trueType)
             }
 
             return trueType
@@ -393,44 +376,45 @@ export class TypeInferer {
     private primitiveType(name: string): PrimitiveTy | null {
         const node = index.elementByName(IndexKey.Primitives, name)
         if (!node) return null
-        return new PrimitiveTy(name, node, null)
+        return TYPES.primitive(node)
     }
 
     private inferTypeMaybeOption(typeNode: SyntaxNode, resolved: TactNode): Ty | null {
         const inferred = this.inferType(new Expression(typeNode, resolved.file))
         if (inferred && !(inferred instanceof OptionTy) && typeNode.nextSibling?.text === "?") {
-            return new OptionTy(inferred)
+            return TYPES.option(inferred)
         }
         return inferred
     }
 
     private inferTypeMaybeTlB(typeNode: SyntaxNode, resolved: TactNode): Ty | null {
         const inferredType = this.inferTypeMaybeOption(typeNode, resolved)
-        if (inferredType instanceof PrimitiveTy) {
-            const tlb = resolved.node.childForFieldName("tlb")
-            const tlbType = tlb?.childForFieldName("type")
-            if (tlbType) {
-                inferredType.tlb = tlbType.text
-            }
-        }
-        return inferredType
+        if (inferredType === null) return null
+        return this.withTlb(inferredType, resolved.node.childForFieldName("tlb"))
+    }
+
+    // `ty` with the serialization of `as uint8` in `tlb`, if it is a primitive type
+    private withTlb(ty: Ty, tlb: SyntaxNode | null): Ty {
+        const tlbType = tlb?.childForFieldName("type")
+        if (!(ty instanceof PrimitiveTy) || !tlbType) return ty
+        return TYPES.withTlb(ty, tlbType.text)
     }
 
     private inferTypeFromResolved(resolved: NamedNode): Ty | null {
         if (resolved instanceof Primitive) {
-            return new PrimitiveTy(resolved.name(), resolved, null)
+            return TYPES.primitive(resolved)
         }
         if (resolved instanceof Struct) {
-            return new StructTy(resolved.name(), resolved)
+            return TYPES.struct(resolved)
         }
         if (resolved instanceof Message) {
-            return new MessageTy(resolved.name(), resolved)
+            return TYPES.message(resolved)
         }
         if (resolved instanceof Trait) {
-            return new TraitTy(resolved.name(), resolved)
+            return TYPES.trait(resolved)
         }
         if (resolved instanceof Contract) {
-            return new ContractTy(resolved.name(), resolved)
+            return TYPES.contract(resolved)
         }
         return null
     }
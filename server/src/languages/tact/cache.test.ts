@@ -0,0 +1,109 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import type {Ty} from "@server/languages/tact/types/BaseTy"
+import type {File} from "@server/psi/File"
+import {CacheManager, TreeTable} from "./cache"
+
+function file(uri: string, generation: number = 1): File {
+    return {uri, generation} as File
+}
+
+function ty(...sources: File[]): Ty {
+    return {
+        name: () => "T",
+        qualifiedName: () => "T",
+        sizeOf: () => ({fixed: 0, floating: 0, valid: true}),
+        sources: () => sources,
+    }
+}
+
+describe("CacheManager", () => {
+    it("should keep results of files that don't depend on a changed file", () => {
+        const cache = new CacheManager()
+        cache.typeCache.cached(file("a.tact"), 1, () => ty(file("b.tact")))
+        cache.typeCache.cached(file("c.tact"), 1, () => ty())
+
+        cache.invalidate("b.tact")
+        expect(cache.typeCache.size).toBe(1)
+        cache.invalidate("c.tact")
+        expect(cache.typeCache.size).toBe(0)
+    })
+
+    it("should record files read while computing a result", () => {
+        const cache = new CacheManager()
+        cache.resolveCache.cached(file("a.tact"), 1, () => {
+            cache.dependsOn("b.tact")
+            return null
+        })
+
+        cache.invalidate("b.tact")
+        expect(cache.resolveCache.size).toBe(0)
+    })
+
+    it("should record dependencies of nested results, cached or not", () => {
+        const cache = new CacheManager()
+        cache.typeCache.cached(file("b.tact"), 1, () => ty(file("c.tact")))
+        cache.typeCache.cached(file("a.tact"), 1, () =>
+            cache.typeCache.cached(file("b.tact"), 1, () => ty()),
+        )
+        cache.typeCache.cached(file("d.tact"), 1, () => {
+            cache.typeCache.cached(file("e.tact"), 1, () => {
+                cache.dependsOn("f.tact")
+                return null
+            })
+            return null
+        })
+
+        cache.invalidate("c.tact")
+        expect(cache.typeCache.size).toBe(2)
+        cache.invalidate("f.tact")
+        expect(cache.typeCache.size).toBe(0)
+    })
+
+    it("should not share results between trees of a file", () => {
+        const cache = new CacheManager()
+        const old = file("a.tact", 1)
+        const current = file("a.tact", 2)
+        cache.typeCache.cached(old, 1, () => ty())
+        expect(cache.typeCache.cached(current, 1, () => null)).toBe(null)
+
+        cache.typeCache.cached(file("b.tact"), 1, () => ty(old))
+        cache.released(old)
+        expect(cache.typeCache.size).toBe(1)
+        expect(cache.typeCache.cached(current, 1, () => ty())).toBe(null)
+    })
+
+    it("should keep results that don't refer to nodes of a released tree", () => {
+        const cache = new CacheManager()
+        const old = file("a.tact", 1)
+        const current = file("a.tact", 2)
+        cache.typeCache.cached(file("b.tact"), 1, () => ty(current))
+        cache.resolveCache.cached(file("c.tact"), 1, () => {
+            cache.dependsOn("a.tact")
+            return null
+        })
+
+        cache.released(old)
+        expect(cache.typeCache.size).toBe(1)
+        expect(cache.resolveCache.size).toBe(1)
+        cache.released(current)
+        expect(cache.typeCache.size).toBe(0)
+        expect(cache.resolveCache.size).toBe(1)
+    })
+})
+
+describe("TreeTable", () => {
+    it("should find values by node id after growing", () => {
+        const table: TreeTable<number> = new TreeTable()
+        const ids = Array.from({length: 1000}, (_, i) => (i + 1) * 48 + 0x1_0000_0000 * (i % 3))
+        ids.forEach((id, i) => {
+            table.set(id, i)
+        })
+        table.set(ids[0], -1)
+
+        expect(table.size).toBe(1000)
+        expect(table.get(ids[0])).toBe(-1)
+        expect(ids.slice(1).every((id, i) => table.get(id) === i + 1)).toBe(true)
+        expect(table.get(7)).toBe(undefined)
+    })
+})
@@ -2,41 +2,270 @@
 //  Copyright © 2025 TON Studio
 import type {Ty} from "@server/languages/tact/types/BaseTy"
 import type {NamedNode} from "@server/languages/tact/psi/TactNode"
+import type {File} from "@server/psi/File"
+import type {ScopeTable} from "@server/languages/tact/psi/ScopeTable"
 
-export class Cache<TKey, TValue> {
-    private readonly data: Map<TKey, TValue>
+const EMPTY_ID = 0
 
-    public constructor() {
-        this.data = new Map()
+/**
+ * Values cached for the nodes of a single tree, in an open addressing table with
+ * node ids and values kept in parallel arrays. Node ids are addresses of nodes,
+ * so they are never 0, which marks an empty slot.
+ */
+export class TreeTable<TValue> {
+    private ids: Float64Array = new Float64Array(16)
+    private values: (TValue | undefined)[] = new Array<TValue | undefined>(16)
+    private count: number = 0
+
+    public get(id: number): TValue | undefined {
+        return this.values[this.slot(id)]
+    }
+
+    public set(id: number, value: TValue): void {
+        let slot = this.slot(id)
+        if (this.ids[slot] === EMPTY_ID) {
+            if ((this.count + 1) * 2 > this.ids.length) {
+                this.grow()
+                slot = this.slot(id)
+            }
+            this.ids[slot] = id
+            this.count++
+        }
+        this.values[slot] = value
+    }
+
+    public get size(): number {
+        return this.count
+    }
+
+    // Slot holding `id`, or the empty slot where it belongs.
+    private slot(id: number): number {
+        const mask = this.ids.length - 1
+        // ids of native trees may not fit into 32 bits, so both halves are mixed in
+        const high = (id / 0x1_0000_0000) >>> 0
+        let slot = Math.imul((id >>> 0) ^ Math.imul(high, 0x85eb_ca6b), 0x9e37_79b1) & mask
+        while (this.ids[slot] !== EMPTY_ID && this.ids[slot] !== id) {
+            slot = (slot + 1) & mask
+        }
+        return slot
     }
 
-    public cached(key: TKey, cb: () => TValue): TValue {
-        const cached = this.data.get(key)
-        if (cached !== undefined) {
+    private grow(): void {
+        const ids = this.ids
+        const values = this.values
+        this.ids = new Float64Array(ids.length * 2)
+        this.values = new Array<TValue | undefined>(ids.length * 2)
+        for (let i = 0; i < ids.length; i++) {
+            if (ids[i] === EMPTY_ID) continue
+            const slot = this.slot(ids[i])
+            this.ids[slot] = ids[i]
+            this.values[slot] = values[i]
+        }
+    }
+}
+
+/** Results cached for the nodes of a single file, by the generation of its tree. */
+class FilePartition<TValue> {
+    public readonly trees: Map<number, TreeTable<TValue>> = new Map()
+    // Other files whose declarations the results were computed from, directly or
+    // through other cached results.
+    public readonly dependencies: Set<string> = new Set()
+}
+
+export class Cache<TValue> {
+    private readonly partitions: Map<string, FilePartition<TValue>> = new Map()
+
+    public constructor(
+        private readonly manager: CacheManager,
+        /** Files declaring the nodes `value` refers to. */
+        private readonly sources: (value: TValue) => readonly File[],
+    ) {}
+
+    /** Returns the result cached for node `id` of the tree of `file`, computing it on a miss. */
+    public cached(file: File, id: number, cb: () => TValue): TValue {
+        const uri = file.uri
+        const partition = this.partitions.get(uri)
+        const cached = partition?.trees.get(file.generation)?.get(id)
+        if (partition && cached !== undefined) {
+            this.manager.dependsOn(uri, partition.dependencies)
             return cached
         }
 
-        const value = cb()
-        this.data.set(key, value)
+        const dependencies = this.manager.record(cb)
+        const value = dependencies.value
+        for (const source of this.sources(value)) {
+            if (source.uri === uri) continue
+            dependencies.files.add(source.uri)
+            this.manager.addReferrer(source, uri)
+        }
+        dependencies.files.delete(uri)
+
+        const target = this.partition(uri)
+        this.table(target, file.generation).set(id, value)
+        for (const dependency of dependencies.files) {
+            target.dependencies.add(dependency)
+            this.manager.addDependent(dependency, uri)
+        }
+
+        this.manager.dependsOn(uri, dependencies.files)
         return value
     }
 
+    /** Drops results cached for `file`, returns the files they depended on. */
+    public invalidate(file: string): ReadonlySet<string> {
+        const partition = this.partitions.get(file)
+        if (!partition) return new Set()
+        this.partitions.delete(file)
+        return partition.dependencies
+    }
+
+    /** Drops results cached for the nodes of the deleted tree of `file`. */
+    public released(file: File): void {
+        this.partitions.get(file.uri)?.trees.delete(file.generation)
+    }
+
     public clear(): void {
-        this.data.clear()
+        this.partitions.clear()
     }
 
     public get size(): number {
-        return this.data.size
+        let size = 0
+        for (const partition of this.partitions.values()) {
+            for (const table of partition.trees.values()) {
+                size += table.size
+            }
+        }
+        return size
+    }
+
+    private partition(file: string): FilePartition<TValue> {
+        const partition = this.partitions.get(file)
+        if (partition) return partition
+        const created: FilePartition<TValue> = new FilePartition()
+        this.partitions.set(file, created)
+        return created
+    }
+
+    private table(partition: FilePartition<TValue>, generation: number): TreeTable<TValue> {
+        const table = partition.trees.get(generation)
+        if (table) return table
+        const created: TreeTable<TValue> = new TreeTable()
+        partition.trees.set(generation, created)
+        return created
     }
 }
 
+/**
+ * Caches of results computed for tree nodes, partitioned by the file of the node
+ * and keyed by the generation of its tree and its id, so ids of deleted trees
+ * reused by new trees never find stale results.
+ *
+ * While a result is computed, every file whose declarations it reads is recorded:
+ * files of index elements it looks at (see `dependsOn`), files of nodes other
+ * cached results refer to, and everything those results depended on. A change of
+ * a file then drops only its own results and the results of files that depended
+ * on it, see `invalidate`.
+ *
+ * Results that found nothing don't depend on any file, so a change that adds or
+ * removes declarations must clear everything.
+ */
 export class CacheManager {
-    public readonly typeCache: Cache<number, Ty | null>
-    public readonly resolveCache: Cache<number, NamedNode | null>
+    public readonly typeCache: Cache<Ty | null>
+    public readonly resolveCache: Cache<NamedNode | null>
+    public readonly scopeCache: Cache<ScopeTable>
+
+    // Files whose cached results depend on each file.
+    private readonly dependents: Map<string, Set<string>> = new Map()
+    // Files whose cached results refer to the nodes of each tree, by its generation.
+    private readonly referrers: Map<number, Set<string>> = new Map()
+    // Files read by each computation in progress, the innermost one last.
+    private readonly frames: Set<string>[] = []
 
     public constructor() {
-        this.typeCache = new Cache()
-        this.resolveCache = new Cache()
+        this.typeCache = new Cache(this, ty => ty?.sources() ?? [])
+        this.resolveCache = new Cache(this, node => (node ? [node.file] : []))
+        this.scopeCache = new Cache(this, () => [])
+    }
+
+    /** Records that the computation in progress reads declarations of `file`. */
+    public dependsOn(file: string, transitive: Iterable<string> = []): void {
+        const frame = this.frames.at(-1)
+        if (!frame) return
+        frame.add(file)
+        for (const dependency of transitive) {
+            frame.add(dependency)
+        }
+    }
+
+    public record<T>(cb: () => T): {value: T; files: Set<string>} {
+        const files: Set<string> = new Set()
+        this.frames.push(files)
+        try {
+            return {value: cb(), files}
+        } finally {
+            this.frames.pop()
+        }
+    }
+
+    public addDependent(file: string, dependent: string): void {
+        const dependents = this.dependents.get(file)
+        if (dependents) {
+            dependents.add(dependent)
+        } else {
+            this.dependents.set(file, new Set([dependent]))
+        }
+    }
+
+    public addReferrer(source: File, referrer: string): void {
+        const referrers = this.referrers.get(source.generation)
+        if (referrers) {
+            referrers.add(referrer)
+        } else {
+            this.referrers.set(source.generation, new Set([referrer]))
+        }
+    }
+
+    /**
+     * Drops results cached for the nodes of `file` and all results computed from
+     * its declarations. Callers clear everything instead when the set of
+     * declarations of `file` changed.
+     */
+    public invalidate(file: string): void {
+        const queue = [file]
+        const visited: Set<string> = new Set()
+        while (queue.length > 0) {
+            const current = queue.pop()
+            if (current === undefined || visited.has(current)) continue
+            visited.add(current)
+
+            const dependencies = [
+                ...this.typeCache.invalidate(current),
+                ...this.resolveCache.invalidate(current),
+                ...this.scopeCache.invalidate(current),
+            ]
+            for (const dependency of dependencies) {
+                this.dependents.get(dependency)?.delete(current)
+            }
+
+            queue.push(...(this.dependents.get(current) ?? []))
+            this.dependents.delete(current)
+        }
+    }
+
+    /**
+     * Drops results cached for the nodes of the deleted tree of `file`, and results
+     * of other files referring to its nodes. Results that only read declarations
+     * of the file, or refer to nodes of its other trees, are kept.
+     */
+    public released(file: File): void {
+        this.typeCache.released(file)
+        this.resolveCache.released(file)
+        this.scopeCache.released(file)
+        const referrers = this.referrers.get(file.generation)
+        this.referrers.delete(file.generation)
+        for (const referrer of referrers ?? []) {
+            this.invalidate(referrer)
+        }
     }
 
     public clear(): void {
@@ -45,6 +274,9 @@ export class CacheManager {
         )
         this.typeCache.clear()
         this.resolveCache.clear()
+        this.scopeCache.clear()
+        this.dependents.clear()
+        this.referrers.clear()
     }
 }
 
@@ -3,7 +3,7 @@
 import {Expression, TactNode} from "@server/languages/tact/psi/TactNode"
 import type * as lsp from "vscode-languageserver/node"
 import {parentOfType} from "@server/languages/tact/psi/utils"
-import {MapTy, NullTy, OptionTy, Ty} from "@server/languages/tact/types/BaseTy"
+import {MapTy, NullTy, OptionTy, sameTy, Ty} from "@server/languages/tact/types/BaseTy"
 import {TypeInferer} from "@server/languages/tact/TypeInferer"
 import type {TactSettings} from "@server/settings/settings"
 
@@ -42,7 +42,6 @@ export class CompletionContext {
     public settings: TactSettings
 
     public constructor(
-        content: string,
         element: TactNode,
         position: lsp.Position,
         triggerKind: lsp.CompletionTriggerKind,
@@ -53,8 +52,7 @@ export class CompletionContext {
         this.triggerKind = triggerKind
         this.settings = settings
 
-        const lines = content.split(/\n/g)
-        const currentLine = lines[position.line]
+        const currentLine = element.file.lineText(position.line)
         if (currentLine && currentLine[position.character - 1]) {
             const symbolAfter = currentLine[position.character - 1]
             this.afterDot = symbolAfter === "."
@@ -288,7 +286,7 @@ export class CompletionContext {
         if (!type) return false
 
         if (this.contextTy instanceof OptionTy && type instanceof OptionTy) {
-            return this.contextTy.innerTy.qualifiedName() === type.innerTy.qualifiedName()
+            return sameTy(this.contextTy.innerTy, type.innerTy)
         }
 
         if (this.contextTy instanceof MapTy && type instanceof MapTy) {
@@ -301,15 +299,15 @@ export class CompletionContext {
 
         if (type instanceof OptionTy) {
             // Int and Int?
-            return type.innerTy.qualifiedName() === this.contextTy.qualifiedName()
+            return sameTy(type.innerTy, this.contextTy)
         }
 
         if (this.contextTy instanceof OptionTy) {
             // Int? and Int
-            return this.contextTy.innerTy.qualifiedName() === type.qualifiedName()
+            return sameTy(this.contextTy.innerTy, type)
         }
 
-        return this.contextTy.qualifiedName() === type.qualifiedName()
+        return sameTy(this.contextTy, type)
     }
 
     public expression(): boolean {
@@ -20,16 +20,62 @@ import {
     contextWeight,
     WeightedCompletionItem,
 } from "@server/languages/tact/completion/WeightedCompletionItem"
-import {MessageTy, StructTy} from "@server/languages/tact/types/BaseTy"
+import {TYPES} from "@server/languages/tact/types/BaseTy"
+import type {Ty} from "@server/languages/tact/types/BaseTy"
 import {tactCodeBlock} from "@server/languages/tact/documentation/documentation"
 import {trimPrefix} from "@server/utils/strings"
 import {TactFile} from "@server/languages/tact/psi/TactFile"
 import {ResolveState} from "@server/psi/ResolveState"
+import {IndexKey} from "@server/languages/tact/indexes"
+import type {DeclarationSummary, FileIndex} from "@server/languages/tact/indexes"
 
 export interface CompletionItemAdditionalInformation {
     readonly name: string | undefined
     readonly file: TactFile | undefined
-    readonly elementFile: TactFile | undefined
+    // only the URI, the file may not be parsed
+    readonly elementFile: {readonly uri: string} | undefined
+}
+
+// Kind of a completed element, as far as the context it is allowed in goes.
+type ElementKind = IndexKey | "field" | "other"
+
+function elementKind(node: TactNode): ElementKind {
+    if (node instanceof Fun) return IndexKey.Funs
+    if (node instanceof Struct) return IndexKey.Structs
+    if (node instanceof Message) return IndexKey.Messages
+    if (node instanceof Trait) return IndexKey.Traits
+    if (node instanceof Contract) return IndexKey.Contracts
+    if (node instanceof Primitive) return IndexKey.Primitives
+    if (node instanceof Constant) return IndexKey.Constants
+    if (node instanceof Field) return "field"
+    return "other"
+}
+
+// Type that decides whether a function, constant, struct or message fits the
+// context, the same for items completed from elements and from summaries.
+function completedTy(node: TactNode): Ty | null | undefined {
+    if (node instanceof Fun) return node.returnType()?.type()
+    if (node instanceof Struct) return TYPES.struct(node)
+    if (node instanceof Message) return TYPES.message(node)
+    if (node instanceof Constant) return node.typeNode()?.type()
+    return null
+}
+
+// Name to complete, or `null` for names that are never completed.
+function completionName(fullName: string): string | null {
+    const name = trimPrefix(
+        trimPrefix(trimPrefix(fullName, "AnyMessage_"), "AnyContract_"),
+        "AnyStruct_",
+    )
+    if (
+        name.endsWith("DummyIdentifier") ||
+        name === "AnyStruct" ||
+        name === "AnyMessage" ||
+        name === "AnyContract"
+    ) {
+        return null
+    }
+    return name
 }
 
 export class ReferenceCompletionProcessor implements ScopeProcessor {
@@ -37,45 +83,120 @@ export class ReferenceCompletionProcessor implements ScopeProcessor {
 
     public result: Map<string, CompletionItem> = new Map()
 
-    private allowedInContext(node: TactNode): boolean {
-        if (node instanceof NamedNode && node.name() === "BaseTrait") return false
+    private allowedInContext(kind: ElementKind, name: string): boolean {
+        if (name === "BaseTrait") return false
 
         if (this.ctx.isType) {
             if (this.ctx.isMessageContext) {
                 // in `receive(msg: <caret>)` allow only messages
-                return node instanceof Message
+                return kind === IndexKey.Messages
             }
 
             if (this.ctx.inTraitList) {
                 // for trait list allow only traits
-                return node instanceof Trait
+                return kind === IndexKey.Traits
             }
 
             if (this.ctx.isInitOfName || this.ctx.isCodeOfName) {
                 // only contracts can be used in `initOf Name()` or in `codeOf Name`
-                return node instanceof Contract
+                return kind === IndexKey.Contracts
             }
 
             // for types, we want to complete only types
             return (
-                node instanceof Trait ||
-                node instanceof Contract ||
-                node instanceof Struct ||
-                node instanceof Message ||
-                node instanceof Primitive
+                kind === IndexKey.Traits ||
+                kind === IndexKey.Contracts ||
+                kind === IndexKey.Structs ||
+                kind === IndexKey.Messages ||
+                kind === IndexKey.Primitives
             )
         }
 
         if (this.ctx.inDestruct) {
-            return node instanceof Field
+            return kind === "field"
         }
 
         // for non-types context things like traits and primitives are prohibited
-        if (node instanceof Trait || node instanceof Primitive) return false
+        if (kind === IndexKey.Traits || kind === IndexKey.Primitives) return false
         // but since structs and messages can be created like `Foo{}` we allow them
-        if (node instanceof Struct || node instanceof Message) return true
-        if (node instanceof Contract) return false // filter contracts for now
+        if (kind === IndexKey.Structs || kind === IndexKey.Messages) return true
+        if (kind === IndexKey.Contracts) return false // filter contracts for now
+
+        return true
+    }
+
+    /**
+     * Completes a top-level declaration of a file from its summary, the same way
+     * as `execute` completes its element. Weighing an item by the type the context
+     * expects needs the element, so only then is the file parsed.
+     */
+    public executeDeclaration(
+        declaration: DeclarationSummary,
+        file: FileIndex,
+        _state: ResolveState,
+    ): boolean {
+        const name = completionName(declaration.name)
+        if (name === null || !this.allowedInContext(declaration.key, declaration.name)) {
+            return true
+        }
+
+        const additionalData = {
+            elementFile: {uri: file.uri},
+            file: this.ctx.element.file,
+            name: name,
+        }
+        const matchesContextTy = (): boolean =>
+            this.ctx.matchContextTy(() => {
+                const element = file.elementOf(declaration)
+                return element && completedTy(element)
+            })
 
+        switch (declaration.key) {
+            case IndexKey.Funs: {
+                this.addFunction(
+                    "",
+                    name,
+                    declaration.signature,
+                    declaration.parameterCount === 0,
+                    matchesContextTy(),
+                    additionalData,
+                )
+                break
+            }
+            case IndexKey.Structs:
+            case IndexKey.Messages: {
+                this.addStruct(name, matchesContextTy(), additionalData)
+                break
+            }
+            case IndexKey.Traits: {
+                this.addTrait(name, additionalData)
+                break
+            }
+            case IndexKey.Contracts: {
+                this.addContract(
+                    name,
+                    declaration.signature,
+                    declaration.parameterCount > 0,
+                    additionalData,
+                )
+                break
+            }
+            case IndexKey.Primitives: {
+                this.addPrimitive(name, additionalData)
+                break
+            }
+            case IndexKey.Constants: {
+                this.addConstant(
+                    "",
+                    name,
+                    declaration.type ?? "",
+                    declaration.value,
+                    matchesContextTy(),
+                    additionalData,
+                )
+                break
+            }
+        }
         return true
     }
 
@@ -83,25 +204,13 @@ export class ReferenceCompletionProcessor implements ScopeProcessor {
         if (!(node instanceof NamedNode)) return true
 
         const prefix = state.get("prefix") ?? ""
-        const name = trimPrefix(
-            trimPrefix(trimPrefix(node.name(), "AnyMessage_"), "AnyContract_"),
-            "AnyStruct_",
-        )
-        if (
-            name.endsWith("DummyIdentifier") ||
-            name === "AnyStruct" ||
-            name === "AnyMessage" ||
-            name === "AnyContract"
-        ) {
-            return true
-        }
-
-        if (!this.allowedInContext(node)) {
+        const name = completionName(node.name())
+        if (name === null || !this.allowedInContext(elementKind(node), node.name())) {
             return true
         }
 
         const additionalData = {
-            elementFile: node.file,
+            elementFile: {uri: node.file.uri},
             file: this.ctx.element.file,
             name: name,
         }
@@ -109,116 +218,44 @@ export class ReferenceCompletionProcessor implements ScopeProcessor {
         if (node instanceof Fun) {
             // don't add `self.` prefix for global functions
             const thisPrefix = prefix !== "" && node.owner() === null ? "" : prefix
-
-            const signature = node.signaturePresentation()
             const hasNoParams =
                 node.parameters().length === 0 || (node.withSelf() && node.parameters().length == 1)
 
-            const needSemicolon = this.ctx.isStatement && !this.ctx.beforeSemicolon
-
-            // We want to place cursor in parens only if there are any parameters to write.
-            // and add brackets only if they are not there yet
-            const parensPart = this.ctx.beforeParen ? "" : hasNoParams ? "()" : "($1)"
-            const semicolonPart = needSemicolon ? "$2;$0" : ""
-            const insertText = thisPrefix + name + parensPart + semicolonPart
-
-            this.addItem({
-                label: thisPrefix + name,
-                kind: CompletionItemKind.Function,
-                labelDetails: {
-                    detail: signature,
-                },
-                documentation: tactCodeBlock(`fun ${name}${signature}`),
-                insertText: insertText,
-                insertTextFormat: InsertTextFormat.Snippet,
-                weight: contextWeight(
-                    CompletionWeight.FUNCTION,
-                    this.ctx.matchContextTy(() => node.returnType()?.type()),
-                ),
-                data: additionalData,
-            })
+            this.addFunction(
+                thisPrefix,
+                name,
+                node.signaturePresentation(),
+                hasNoParams,
+                this.ctx.matchContextTy(() => completedTy(node)),
+                additionalData,
+            )
         } else if (node instanceof Struct || node instanceof Message) {
-            // we don't want to add `{}` for type completion
-            const bracesSnippet = this.ctx.isType ? "" : " {$1}"
-            const braces = this.ctx.isType ? "" : " {}"
-
-            this.addItem({
-                label: name,
-                labelDetails: {
-                    detail: braces,
-                },
-                kind: CompletionItemKind.Struct,
-                insertText: `${name}${bracesSnippet}$0`,
-                insertTextFormat: InsertTextFormat.Snippet,
-                weight: contextWeight(
-                    CompletionWeight.STRUCT,
-                    this.ctx.matchContextTy(() =>
-                        node instanceof Struct
-                            ? new StructTy(node.name(), node)
-                            : new MessageTy(node.name(), node),
-                    ),
-                ),
-                data: additionalData,
-            })
+            this.addStruct(name, this.ctx.matchContextTy(() => completedTy(node)), additionalData)
         } else if (node instanceof Trait) {
-            this.addItem({
-                label: name,
-                kind: CompletionItemKind.TypeParameter,
-                insertText: `${name}$0`,
-                insertTextFormat: InsertTextFormat.Snippet,
-                weight: CompletionWeight.TRAIT,
-                data: additionalData,
-            })
+            this.addTrait(name, additionalData)
         } else if (node instanceof Contract) {
-            const parameters = node.initFunction()?.parametersPresentation() ?? "()"
-            const suffix = this.ctx.isInitOfName ? parameters : ""
             const initFunction = node.initFunction()
-            const needParens = this.ctx.isInitOfName && !this.ctx.beforeParen
-            const hasParameters = initFunction !== null && initFunction.parameters().length > 0
-
-            const insertSuffix = needParens ? (hasParameters ? "($1)" : "()") : ""
-
-            this.addItem({
-                label: name,
-                labelDetails: {
-                    detail: suffix,
-                },
-                kind: CompletionItemKind.Constructor,
-                insertText: `${name}${insertSuffix}$0`,
-                insertTextFormat: InsertTextFormat.Snippet,
-                weight: CompletionWeight.CONTRACT,
-                data: additionalData,
-            })
+            this.addContract(
+                name,
+                initFunction?.parametersPresentation() ?? "()",
+                initFunction !== null && initFunction.parameters().length > 0,
+                additionalData,
+            )
         } else if (node instanceof Primitive) {
-            this.addItem({
-                label: name,
-                kind: CompletionItemKind.Property,
-                insertText: name,
-                insertTextFormat: InsertTextFormat.Snippet,
-                weight: CompletionWeight.PRIMITIVE,
-                data: additionalData,
-            })
+            this.addPrimitive(name, additionalData)
         } else if (node instanceof Constant) {
             // don't add `self.` prefix for global constants
             const thisPrefix = prefix !== "" && node.owner() === null ? "" : prefix
 
             const typeNode = node.typeNode()
-            const value = node.value()
-            const valueType = typeNode?.type()?.qualifiedName() ?? ""
-            this.addItem({
-                label: thisPrefix + name,
-                kind: CompletionItemKind.Constant,
-                labelDetails: {
-                    detail: ": " + valueType + " = " + (value?.node.text ?? "unknown"),
-                },
-                insertText: thisPrefix + name,
-                insertTextFormat: InsertTextFormat.Snippet,
-                weight: contextWeight(
-                    CompletionWeight.CONSTANT,
-                    this.ctx.matchContextTy(() => typeNode?.type()),
-                ),
-                data: additionalData,
-            })
+            this.addConstant(
+                thisPrefix,
+                name,
+                typeNode?.type()?.qualifiedName() ?? "",
+                node.value()?.node.text ?? null,
+                this.ctx.matchContextTy(() => completedTy(node)),
+                additionalData,
+            )
         } else if (node instanceof Field) {
             const owner = node.dataOwner()?.name() ?? ""
 
@@ -305,6 +342,124 @@ export class ReferenceCompletionProcessor implements ScopeProcessor {
         return true
     }
 
+    private addFunction(
+        thisPrefix: string,
+        name: string,
+        signature: string,
+        hasNoParams: boolean,
+        matchesContextTy: boolean,
+        data: CompletionItemAdditionalInformation,
+    ): void {
+        const needSemicolon = this.ctx.isStatement && !this.ctx.beforeSemicolon
+
+        // We want to place cursor in parens only if there are any parameters to write.
+        // and add brackets only if they are not there yet
+        const parensPart = this.ctx.beforeParen ? "" : hasNoParams ? "()" : "($1)"
+        const semicolonPart = needSemicolon ? "$2;$0" : ""
+        const insertText = thisPrefix + name + parensPart + semicolonPart
+
+        this.addItem({
+            label: thisPrefix + name,
+            kind: CompletionItemKind.Function,
+            labelDetails: {
+                detail: signature,
+            },
+            documentation: tactCodeBlock(`fun ${name}${signature}`),
+            insertText: insertText,
+            insertTextFormat: InsertTextFormat.Snippet,
+            weight: contextWeight(CompletionWeight.FUNCTION, matchesContextTy),
+            data,
+        })
+    }
+
+    private addStruct(
+        name: string,
+        matchesContextTy: boolean,
+        data: CompletionItemAdditionalInformation,
+    ): void {
+        // we don't want to add `{}` for type completion
+        const bracesSnippet = this.ctx.isType ? "" : " {$1}"
+        const braces = this.ctx.isType ? "" : " {}"
+
+        this.addItem({
+            label: name,
+            labelDetails: {
+                detail: braces,
+            },
+            kind: CompletionItemKind.Struct,
+            insertText: `${name}${bracesSnippet}$0`,
+            insertTextFormat: InsertTextFormat.Snippet,
+            weight: contextWeight(CompletionWeight.STRUCT, matchesContextTy),
+            data,
+        })
+    }
+
+    private addTrait(name: string, data: CompletionItemAdditionalInformation): void {
+        this.addItem({
+            label: name,
+            kind: CompletionItemKind.TypeParameter,
+            insertText: `${name}$0`,
+            insertTextFormat: InsertTextFormat.Snippet,
+            weight: CompletionWeight.TRAIT,
+            data,
+        })
+    }
+
+    private addContract(
+        name: string,
+        parameters: string,
+        hasParameters: boolean,
+        data: CompletionItemAdditionalInformation,
+    ): void {
+        const suffix = this.ctx.isInitOfName ? parameters : ""
+        const needParens = this.ctx.isInitOfName && !this.ctx.beforeParen
+        const insertSuffix = needParens ? (hasParameters ? "($1)" : "()") : ""
+
+        this.addItem({
+            label: name,
+            labelDetails: {
+                detail: suffix,
+            },
+            kind: CompletionItemKind.Constructor,
+            insertText: `${name}${insertSuffix}$0`,
+            insertTextFormat: InsertTextFormat.Snippet,
+            weight: CompletionWeight.CONTRACT,
+            data,
+        })
+    }
+
+    private addPrimitive(name: string, data: CompletionItemAdditionalInformation): void {
+        this.addItem({
+            label: name,
+            kind: CompletionItemKind.Property,
+            insertText: name,
+            insertTextFormat: InsertTextFormat.Snippet,
+            weight: CompletionWeight.PRIMITIVE,
+            data,
+        })
+    }
+
+    private addConstant(
+        thisPrefix: string,
+        name: string,
+        valueType: string,
+        value: string | null,
+        matchesContextTy: boolean,
+        data: CompletionItemAdditionalInformation,
+    ): void {
+        this.addItem({
+            label: thisPrefix + name,
+            kind: CompletionItemKind.Constant,
+            labelDetails: {
+                detail: ": " + valueType + " = " + (value ?? "unknown"),
+            },
+            insertText: thisPrefix + name,
+            insertTextFormat: InsertTextFormat.Snippet,
+            weight: contextWeight(CompletionWeight.CONSTANT, matchesContextTy),
+            data,
+        })
+    }
+
     public addItem(node: WeightedCompletionItem): void {
         if (node.label === "") return
         const lookup = this.lookupString(node)
@@ -0,0 +1,105 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {existsSync} from "node:fs"
+import * as path from "node:path"
+import {pathToFileURL} from "node:url"
+import {initParser, tactParsers} from "@server/parser"
+import {PARSED_FILES_CACHE, reparseTactFile} from "@server/files"
+import {FileIndex, index, IndexRoot} from "@server/languages/tact/indexes"
+import {TactFile} from "@server/languages/tact/psi/TactFile"
+import {retainingFiles} from "@server/psi/File"
+import {provideTactCompletion} from "./index"
+import {CompletionWeight} from "./WeightedCompletionItem"
+import type {WeightedCompletionItem} from "./WeightedCompletionItem"
+
+// settings are read from the client, the defaults are used without one
+jest.mock("@server/connection", () => ({
+    connection: {workspace: {getConfiguration: async () => undefined}},
+}))
+
+// Runs once the WASM grammar is built (`yarn grammar:tact:wasm`), as it is in CI.
+const grammarWasmPath = path.join(__dirname, "../tree-sitter-tact/tree-sitter-tact.wasm")
+const runtimeWasmPath = path.join(
+    __dirname,
+    "../../../../../node_modules/web-tree-sitter/tree-sitter.wasm",
+)
+const describeWasm = [grammarWasmPath, runtimeWasmPath].every(file => existsSync(file))
+    ? describe
+    : describe.skip
+
+const ROOT = `${pathToFileURL(path.resolve("/workspace")).href}/`
+// declarations of stubs resolve from every file, without imports
+const STUBS = `${pathToFileURL(path.resolve("/stubs")).href}/`
+
+const MAIN = "fun main() {\n    \n}\n"
+const TYPED = "fun main() {\n    let p: Point = ;\n}\n"
+
+const UNOPENED: Record<string, string> = {
+    [`${STUBS}types.tact`]: "struct Point { x: Int; y: Int }\n",
+    [`${ROOT}helpers.tact`]:
+        "fun helper(a: Int): Int { return a }\n" +
+        "fun origin(): Point { return Point { x: 0, y: 0 } }\n" +
+        "extends fun double(self: Int): Int { return self * 2 }\n",
+    [`${ROOT}constants.tact`]: "const LIMIT: Int = 100;\nmessage Ping {}\n",
+}
+
+async function complete(
+    uri: string,
+    text: string,
+    position: {line: number; character: number},
+): Promise<Map<string, WeightedCompletionItem>> {
+    const items = await retainingFiles(async () => {
+        const file = reparseTactFile(uri, text)
+        PARSED_FILES_CACHE.opened(uri)
+        index.addFile(uri, file)
+        return provideTactCompletion(file, {textDocument: {uri}, position}, uri)
+    })()
+    return new Map(items.map(item => [item.label, item]))
+}
+
+describeWasm("completion after indexing", () => {
+    beforeAll(async () => {
+        // the TL-B grammar isn't needed, any language will do
+        await initParser(runtimeWasmPath, grammarWasmPath, grammarWasmPath)
+
+        index.withRoots([new IndexRoot("workspace", ROOT)])
+        index.withStubsRoot(new IndexRoot("stubs", STUBS))
+
+        // what `IndexingRoot.index` does with the results of indexing workers
+        for (const [uri, content] of Object.entries(UNOPENED)) {
+            const tree = tactParsers.use(parser => parser.parse(content))
+            if (!tree) throw new Error("parse failed")
+            const file = new TactFile(uri, tree, content)
+            const summary = structuredClone(FileIndex.create(file).summary())
+            file.release()
+
+            PARSED_FILES_CACHE.setUnparsed(uri, content)
+            index.addSummary(uri, summary)
+        }
+    })
+
+    it("should complete declarations of unopened files without parsing them", async () => {
+        const byLabel = await complete(`${ROOT}main.tact`, MAIN, {line: 1, character: 4})
+        expect(byLabel.get("helper")?.labelDetails?.detail).toBe("(a: Int): Int")
+        expect(byLabel.get("Point")?.insertText).toBe("Point {$1}$0")
+        expect(byLabel.get("Ping")).toBeDefined()
+        expect(byLabel.get("LIMIT")?.labelDetails?.detail).toBe(": Int = 100")
+        // methods are not completed without a qualifier
+        expect(byLabel.has("double")).toBe(false)
+
+        for (const uri of Object.keys(UNOPENED)) {
+            expect(PARSED_FILES_CACHE.peek(uri)).toBeUndefined()
+        }
+    })
+
+    // runs after the test above, as it parses the files to weigh their declarations
+    it("should weigh declarations of unopened files by their types", async () => {
+        const byLabel = await complete(`${ROOT}typed.tact`, TYPED, {line: 1, character: 19})
+        // the same weights as for parsed files, see `contextWeight`
+        expect(byLabel.get("origin")?.weight).toBe(CompletionWeight.FUNCTION)
+        expect(byLabel.get("Point")?.weight).toBe(CompletionWeight.STRUCT)
+        expect(byLabel.get("helper")?.weight).toBe(CompletionWeight.FUNCTION + 500)
+        expect(byLabel.get("Ping")?.weight).toBe(CompletionWeight.STRUCT + 500)
+        expect(byLabel.get("LIMIT")?.weight).toBe(CompletionWeight.CONSTANT + 500)
+    })
+})
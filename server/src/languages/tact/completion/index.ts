@@ -1,7 +1,6 @@
 import {TactFile} from "@server/languages/tact/psi/TactFile"
 import * as lsp from "vscode-languageserver"
-import {createTactParser} from "@server/parser"
-import {getOffsetFromPosition} from "@server/document-store"
+import {tactParseInput, tactParseOptions, tactParsers} from "@server/parser"
 import {asParserPoint} from "@server/utils/position"
 import {NamedNode} from "@server/languages/tact/psi/TactNode"
 import {Reference} from "@server/languages/tact/psi/Reference"
@@ -36,24 +35,24 @@ import {PostfixCompletionProvider} from "@server/languages/tact/completion/provi
 import {TypeTlbSerializationCompletionProvider} from "@server/languages/tact/completion/providers/TypeTlbSerializationCompletionProvider"
 import {CompletionItemAdditionalInformation} from "@server/languages/tact/completion/ReferenceCompletionProcessor"
 import {findTactFile} from "@server/files"
+import {retainForRequest} from "@server/psi/File"
 import {index} from "@server/languages/tact/indexes"
 import {FileDiff} from "@server/utils/FileDiff"
 
+// Last copy of a file with `DummyIdentifier` inserted, see `provideTactCompletion`.
+// Every version of a document is parsed into a new `TactFile`, so repeated
+// completion requests at the same spot of the same version reuse it. The copy
+// owns its tree, which is released once the next copy replaces it.
+let lastCompletionFile: {original: TactFile; offset: number; file: TactFile | null} | null = null
+
+const DUMMY_IDENTIFIER = "DummyIdentifier"
+
 export async function provideTactCompletion(
     file: TactFile,
     params: lsp.CompletionParams,
     uri: string,
 ): Promise<lsp.CompletionItem[]> {
-    const content = file.content
-    const parser = createTactParser()
-
-    const offset = getOffsetFromPosition(
-        content,
-        params.position.line,
-        params.position.character + 1,
-    )
-    const start = content.slice(0, offset)
-    const end = content.slice(offset)
+    const offset = file.lines.offsetAt(params.position)
 
     // Let's say we want to get autocompletion in the following code:
     //
@@ -78,9 +77,12 @@ export async function provideTactCompletion(
     // Now that we have valid code, we can use `Reference.processResolveVariants`
     // to resolve `DummyIdentifier` into a list of possible variants, which will
     // become the autocompletion list. See `Reference` class documentation.
-    const newContent = `${start}DummyIdentifier${end}`
-    const tree = parser.parse(newContent)
-    if (!tree) return []
+    //
+    // The identifier is inserted into a copy of the already parsed tree, so only
+    // the region around the caret is parsed again.
+    const completionFile = completionFileAt(file, uri, offset)
+    if (!completionFile) return []
+    const tree = completionFile.tree
 
     const cursorPosition = asParserPoint(params.position)
     const cursorNode = tree.rootNode.descendantForPosition(cursorPosition)
@@ -94,11 +96,10 @@ export async function provideTactCompletion(
         return []
     }
 
-    const element = new NamedNode(cursorNode, new TactFile(uri, tree, newContent))
+    const element = new NamedNode(cursorNode, completionFile)
     const ref = new Reference(element)
 
     const ctx = new CompletionContext(
-        newContent,
         element,
         params.position,
         params.context?.triggerKind ?? lsp.CompletionTriggerKind.Invoked,
@@ -146,6 +147,44 @@ export async function provideTactCompletion(
     return result.sorted()
 }
 
+function completionFileAt(file: TactFile, uri: string, offset: number): TactFile | null {
+    if (lastCompletionFile?.original === file && lastCompletionFile.offset === offset) {
+        const cached = lastCompletionFile.file
+        return cached ? retainForRequest(cached) : null
+    }
+
+    const source = file.source
+    const newSource =
+        typeof source === "string"
+            ? `${source.slice(0, offset)}${DUMMY_IDENTIFIER}${source.slice(offset)}`
+            : source.replace(offset, offset, DUMMY_IDENTIFIER)
+
+    // the requested position may be past the end of its line, the offset is not
+    const position = file.lines.positionAt(offset)
+    const oldTree = file.tree.copy()
+    oldTree.edit({
+        startIndex: offset,
+        oldEndIndex: offset,
+        newEndIndex: offset + DUMMY_IDENTIFIER.length,
+        startPosition: asParserPoint(position),
+        oldEndPosition: asParserPoint(position),
+        newEndPosition: {
+            row: position.line,
+            column: position.character + DUMMY_IDENTIFIER.length,
+        },
+    })
+
+    const input = tactParseInput(newSource)
+    const tree = tactParsers.use(parser => parser.parse(input, oldTree, tactParseOptions()))
+    oldTree.delete()
+
+    const result = tree ? new TactFile(uri, tree, newSource) : null
+    // the copy is released once it's replaced and requests using it are done
+    lastCompletionFile?.file?.release()
+    lastCompletionFile = {original: file, offset, file: result}
+    return result ? retainForRequest(result) : null
+}
+
 export async function provideTactCompletionResolve(
     item: lsp.CompletionItem,
 ): Promise<lsp.CompletionItem> {
@@ -8,19 +8,20 @@ import {
     CompletionWeight,
     contextWeight,
 } from "@server/languages/tact/completion/WeightedCompletionItem"
-import {NullTy, PrimitiveTy} from "@server/languages/tact/types/BaseTy"
+import {TYPES} from "@server/languages/tact/types/BaseTy"
+import {index, IndexKey} from "@server/languages/tact/indexes"
 
 export class KeywordsCompletionProvider implements CompletionProvider {
-    private readonly boolTy: PrimitiveTy = new PrimitiveTy("Bool", null, null)
-    private readonly nullTy: NullTy = new NullTy()
-
     public isAvailable(ctx: CompletionContext): boolean {
         return ctx.expression() && !ctx.inNameOfFieldInit
     }
 
     public addCompletion(ctx: CompletionContext, result: CompletionResult): void {
-        const expectedBool = ctx.matchContextTy(() => this.boolTy)
-        const expectedNull = ctx.matchContextTy(() => this.nullTy)
+        const expectedBool = ctx.matchContextTy(() => {
+            const bool = index.elementByName(IndexKey.Primitives, "Bool")
+            return bool ? TYPES.primitive(bool) : null
+        })
+        const expectedNull = ctx.matchContextTy(() => TYPES.nullTy)
 
         result.add({
             label: "true",
@@ -19,14 +19,7 @@ import {trimPrefix} from "@server/utils/strings"
 import * as compiler from "@server/languages/tact/compiler/utils"
 import {getDocumentSettings, TactSettings} from "@server/settings/settings"
 import {TactFile} from "@server/languages/tact/psi/TactFile"
-import {
-    ContractTy,
-    FieldsOwnerTy,
-    MessageTy,
-    sizeOfPresentation,
-    StructTy,
-    Ty,
-} from "@server/languages/tact/types/BaseTy"
+import {FieldsOwnerTy, sizeOfPresentation, Ty, TYPES} from "@server/languages/tact/types/BaseTy"
 import {generateTlb} from "@server/languages/tact/compiler/tlb/tlb"
 
 const CODE_FENCE = "```"
@@ -143,7 +136,7 @@ export async function generateDocFor(node: NamedNode, place: SyntaxNode): Promis
 
             const body = members === "" ? "{}" : `{\n${members}\n}`
 
-            const tlb = genTlb(new ContractTy(contract.name(), contract))
+            const tlb = genTlb(TYPES.contract(contract))
 
             return defaultResult(`contract ${node.name()}${inheritedString} ${body}`, tlb + doc)
         }
@@ -170,8 +163,9 @@ export async function generateDocFor(node: NamedNode, place: SyntaxNode): Promis
             const doc = node.documentation()
             const struct = new Struct(node.node, node.file)
             const body = struct.body()?.text ?? ""
-            const sizeDoc = documentationSizeOf(struct)
-            const tlb = genTlb(new StructTy(struct.name(), struct))
+            const ty = TYPES.struct(struct)
+            const sizeDoc = documentationSizeOf(ty)
+            const tlb = genTlb(ty)
 
             return defaultResult(`struct ${node.name()} ${body}`, tlb + sizeDoc + doc)
         }
@@ -181,8 +175,9 @@ export async function generateDocFor(node: NamedNode, place: SyntaxNode): Promis
             const body = message.body()?.text ?? ""
             const opcode = message.opcode()
             const opcodePresentation = opcode ? `(${opcode})` : ""
-            const sizeDoc = documentationSizeOf(message)
-            const tlb = genTlb(new MessageTy(message.name(), message))
+            const ty = TYPES.message(message)
+            const sizeDoc = documentationSizeOf(ty)
+            const tlb = genTlb(ty)
 
             return defaultResult(
                 `message${opcodePresentation} ${node.name()} ${body}`,
@@ -383,8 +378,7 @@ function requireFunctionDoc(
     return `Exit code: **${exitCode.value}**.\n\n`
 }
 
-function documentationSizeOf(fieldsOwner: FieldsOwner): string {
-    const ty = new FieldsOwnerTy(fieldsOwner.name(), fieldsOwner)
+function documentationSizeOf(ty: FieldsOwnerTy<FieldsOwner>): string {
     const sizeOf = ty.sizeOf()
     if (!sizeOf.valid) return ""
     const sizeOfPres = sizeOfPresentation(sizeOf)
@@ -17,6 +17,9 @@ import {CACHE} from "@server/languages/tact/cache"
 import {fileURLToPath} from "node:url"
 import {PARSED_FILES_CACHE} from "@server/files"
 import {ResolveState} from "@server/psi/ResolveState"
+import {retainForRequest} from "@server/psi/File"
+import {asLspRange} from "@server/utils/position"
+import type * as lsp from "vscode-languageserver"
 
 export interface IndexKeyToType {
     readonly [IndexKey.Contracts]: Contract
@@ -42,19 +45,216 @@ export enum IndexKey {
 
 export interface IndexFinder {
     processElementsByKey: (key: IndexKey, processor: ScopeProcessor, state: ResolveState) => boolean
+    processElementsByName: (
+        key: IndexKey,
+        name: string,
+        processor: ScopeProcessor,
+        state: ResolveState,
+    ) => boolean
 }
 
-export class FileIndex {
-    private readonly elements: {
-        [IndexKey.Contracts]: Contract[]
-        [IndexKey.Funs]: Fun[]
-        [IndexKey.Methods]: Fun[]
-        [IndexKey.Messages]: Message[]
-        [IndexKey.Structs]: Struct[]
-        [IndexKey.Traits]: Trait[]
-        [IndexKey.Primitives]: Primitive[]
-        [IndexKey.Constants]: Constant[]
-    } = {
+type FileElements = {readonly [K in IndexKey]: IndexKeyToType[K][]}
+
+type FileElementsByName = {readonly [K in IndexKey]: Map<string, IndexKeyToType[K][]>}
+
+function groupByName<T extends NamedNode>(elements: readonly T[]): Map<string, T[]> {
+    const result: Map<string, T[]> = new Map()
+    for (const element of elements) {
+        const name = element.name()
+        const named = result.get(name)
+        if (named) {
+            named.push(element)
+        } else {
+            result.set(name, [element])
+        }
+    }
+    return result
+}
+
+interface RootFile {
+    readonly root: IndexRoot
+    readonly index: FileIndex
+}
+
+// Order of lookups among roots, see `GlobalIndex.allRoots`.
+const ROOT_ORDER: readonly IndexRoot["name"][] = ["workspace", "stdlib", "stubs"]
+
+function addToTable(table: Map<string, RootFile[]>, keys: Iterable<string>, file: RootFile): void {
+    const order = ROOT_ORDER.indexOf(file.root.name)
+    for (const key of keys) {
+        const files = table.get(key)
+        if (!files) {
+            table.set(key, [file])
+            continue
+        }
+        // after the files of the same and earlier roots
+        const before = files.findIndex(it => ROOT_ORDER.indexOf(it.root.name) > order)
+        if (before === -1) {
+            files.push(file)
+        } else {
+            files.splice(before, 0, file)
+        }
+    }
+}
+
+function removeFromTable(
+    table: Map<string, RootFile[]>,
+    keys: Iterable<string>,
+    index: FileIndex,
+): void {
+    for (const key of keys) {
+        const files = table.get(key)?.filter(it => it.index !== index) ?? []
+        if (files.length > 0) {
+            table.set(key, files)
+        } else {
+            table.delete(key)
+        }
+    }
+}
+
+/**
+ * Files declaring each name and files declaring methods for each receiver, see
+ * `FileIndex.receiverOf`, across all roots of `GlobalIndex`, so a lookup by name
+ * is one table lookup rather than one per root. Files of earlier roots come
+ * first, files of a root are in the order they were added.
+ */
+class DeclarationTable {
+    private readonly declarations: Map<string, RootFile[]> = new Map()
+    private readonly receivers: Map<string, RootFile[]> = new Map()
+
+    public add(root: IndexRoot, index: FileIndex): void {
+        addToTable(this.declarations, index.declaredNames(), {root, index})
+        addToTable(this.receivers, index.methodReceivers(), {root, index})
+    }
+
+    public remove(index: FileIndex): void {
+        removeFromTable(this.declarations, index.declaredNames(), index)
+        removeFromTable(this.receivers, index.methodReceivers(), index)
+    }
+
+    public declaring(name: string): readonly RootFile[] {
+        return this.declarations.get(name) ?? []
+    }
+
+    public receiving(receiver: string): readonly RootFile[] {
+        return this.receivers.get(receiver) ?? []
+    }
+}
+
+function sameKeys(a: ReadonlySet<string>, b: ReadonlySet<string>): boolean {
+    if (a.size !== b.size) return false
+    for (const key of a) {
+        if (!b.has(key)) return false
+    }
+    return true
+}
+
+/**
+ * Top-level declaration of a file, or an own method of a contract or trait, with
+ * what lookups over all files read from it, so they don't need the tree of the
+ * file, see `ScopeProcessor.executeDeclaration`.
+ */
+export interface DeclarationSummary {
+    // `IndexKey.Funs` for all functions, methods have `withSelf`
+    readonly key: IndexKey
+    readonly name: string
+    // Range of the name, `null` if the declaration has none.
+    readonly nameRange: lsp.Range | null
+    readonly deprecated: boolean
+    /**
+     * Parameters and return type of functions, see `Fun.signaturePresentation`,
+     * and parameters of the `init` of contracts, `"()"` without one.
+     */
+    readonly signature: string
+    // Parameters of functions besides `self`, and of the `init` of contracts.
+    readonly parameterCount: number
+    readonly withSelf: boolean
+    readonly getter: boolean
+    /**
+     * Text of the return type of functions, with `?` of optional types, of the
+     * type of constants, and the name of structs and messages.
+     */
+    readonly type: string | null
+    // Text of the value of constants.
+    readonly value: string | null
+    // Names of the traits contracts and traits inherit, see `inheritTraitsList`.
+    readonly traits: readonly string[]
+    // Own methods of contracts and traits.
+    readonly methods: readonly DeclarationSummary[]
+}
+
+function summarizeDeclaration(key: IndexKey, element: NamedNode): DeclarationSummary {
+    const nameIdentifier = element.nameIdentifier()
+    let summary: DeclarationSummary = {
+        key,
+        name: element.name(),
+        nameRange: nameIdentifier ? asLspRange(nameIdentifier) : null,
+        // primitive type cannot be deprecated
+        deprecated: key !== IndexKey.Primitives && element.isDeprecatedNoIndex(),
+        signature: "",
+        parameterCount: 0,
+        withSelf: false,
+        getter: false,
+        type: null,
+        value: null,
+        traits: [],
+        methods: [],
+    }
+
+    if (element instanceof Fun) {
+        const result = element.returnType()
+        const optional = result?.node.nextSibling?.text === "?" ? "?" : ""
+        const withSelf = element.withSelf()
+        summary = {
+            ...summary,
+            signature: element.signaturePresentation(),
+            parameterCount: element.parameters().length - (withSelf ? 1 : 0),
+            withSelf,
+            getter: element.isGetMethod,
+            type: result ? result.node.text + optional : null,
+        }
+    } else if (element instanceof Contract || element instanceof Trait) {
+        const init = element.initFunction()
+        summary = {
+            ...summary,
+            signature: init?.parametersPresentation() ?? "()",
+            parameterCount: init?.parameters().length ?? 0,
+            traits: element.inheritTraitsList().map(trait => trait.name()),
+            methods: element
+                .ownMethods()
+                .map(method => summarizeDeclaration(IndexKey.Funs, method)),
+        }
+    } else if (element instanceof Struct || element instanceof Message) {
+        summary = {...summary, type: summary.name}
+    } else if (element instanceof Constant) {
+        summary = {
+            ...summary,
+            type: element.typeNode()?.node.text ?? null,
+            value: element.value()?.node.text ?? null,
+        }
+    }
+    return summary
+}
+
+/**
+ * Declarations of a file and receivers of its methods, enough to look the file
+ * up without its tree, see `FileIndex.fromSummary`. Built by indexing workers,
+ * so it must stay structured-cloneable.
+ */
+export interface FileSummary {
+    readonly declarations: readonly DeclarationSummary[]
+    readonly receivers: readonly string[]
+}
+
+interface FileContents {
+    readonly elements: FileElements
+    readonly byName: FileElementsByName
+    // Methods by the key of the type of their `self`, see `FileIndex.receiverOf`.
+    readonly byReceiver: Map<string, Fun[]>
+}
+
+const NO_CONTENTS: FileContents = {
+    elements: {
         [IndexKey.Contracts]: [],
         [IndexKey.Funs]: [],
         [IndexKey.Methods]: [],
@@ -63,58 +263,208 @@ export class FileIndex {
         [IndexKey.Traits]: [],
         [IndexKey.Primitives]: [],
         [IndexKey.Constants]: [],
-    }
+    },
+    byName: {
+        [IndexKey.Contracts]: new Map(),
+        [IndexKey.Funs]: new Map(),
+        [IndexKey.Methods]: new Map(),
+        [IndexKey.Messages]: new Map(),
+        [IndexKey.Structs]: new Map(),
+        [IndexKey.Traits]: new Map(),
+        [IndexKey.Primitives]: new Map(),
+        [IndexKey.Constants]: new Map(),
+    },
+    byReceiver: new Map(),
+}
 
+export class FileIndex {
+    private file: TactFile | null = null
+    private loaded: FileContents = NO_CONTENTS
     private readonly deprecated: Map<string, string> = new Map()
+    // Names of all top-level declarations, survives eviction of the tree, so
+    // lookups of names the file doesn't declare don't parse it again. Both sets
+    // are registered in the tables of `IndexRoot`, so they never change once the
+    // index is created.
+    private readonly declared: Set<string> = new Set()
+    private readonly receivers: Set<string> = new Set()
+    // Summaries of the declarations, also kept once the tree is evicted.
+    private declarations: readonly DeclarationSummary[] = []
+    // Imports of the file, `null` until it is parsed.
+    private imports: readonly string[] | null = null
+
+    private constructor(public readonly uri: string) {}
 
     public static create(file: TactFile): FileIndex {
-        const index = new FileIndex()
+        const index = new FileIndex(file.uri)
+        index.file = file
+        index.loaded = index.collect(file)
+        for (const named of Object.values(index.loaded.byName)) {
+            for (const name of named.keys()) {
+                index.declared.add(name)
+            }
+        }
+        for (const receiver of index.loaded.byReceiver.keys()) {
+            index.receivers.add(receiver)
+        }
+        index.declarations = FileIndex.summarize(index.loaded.elements)
+        return index
+    }
+
+    private static summarize(elements: FileElements): DeclarationSummary[] {
+        const result: DeclarationSummary[] = []
+        for (const key of Object.values(IndexKey)) {
+            // methods are among functions
+            if (key === IndexKey.Methods) continue
+            for (const element of elements[key]) {
+                result.push(summarizeDeclaration(key, element))
+            }
+        }
+        return result
+    }
+
+    /**
+     * Creates an index of a file from the summary of its declarations. The file is
+     * parsed from `PARSED_FILES_CACHE` once its elements are needed, lookups that
+     * take declarations, see `ScopeProcessor.executeDeclaration`, never parse it.
+     */
+    public static fromSummary(uri: string, summary: FileSummary): FileIndex {
+        const index = new FileIndex(uri)
+        for (const declaration of summary.declarations) {
+            index.declared.add(declaration.name)
+            if (declaration.deprecated) {
+                index.deprecated.set(declaration.name, "")
+            }
+        }
+        for (const receiver of summary.receivers) {
+            index.receivers.add(receiver)
+        }
+        index.declarations = summary.declarations
+        return index
+    }
+
+    public summary(): FileSummary {
+        return {
+            declarations: this.declarations,
+            receivers: [...this.receivers],
+        }
+    }
+
+    // The tree of a file that is not open can be evicted from `PARSED_FILES_CACHE`
+    // and parsed again later, the elements of the old tree are then rebuilt from
+    // the new one.
+    private get current(): FileContents {
+        const uri = this.uri
+        const stale = PARSED_FILES_CACHE.peek(uri) !== this.file && PARSED_FILES_CACHE.has(uri)
+        if (this.file === null || stale) {
+            const file = PARSED_FILES_CACHE.get(uri)
+            if (file) {
+                this.file = file
+                this.loaded = this.collect(file)
+            }
+        }
+        if (this.file !== null) {
+            retainForRequest(this.file)
+        }
+        return this.loaded
+    }
+
+    private collect(file: TactFile): FileContents {
+        const elements: FileElements = {
+            [IndexKey.Contracts]: [],
+            [IndexKey.Funs]: [],
+            [IndexKey.Methods]: [],
+            [IndexKey.Messages]: [],
+            [IndexKey.Structs]: [],
+            [IndexKey.Traits]: [],
+            [IndexKey.Primitives]: [],
+            [IndexKey.Constants]: [],
+        }
+
+        this.imports = file.imports().map(node => node.text)
 
         for (const node of file.rootNode.children) {
             if (!node) continue
 
             if (isNamedFunNode(node)) {
                 const fun = new Fun(node, file)
-                index.elements[IndexKey.Funs].push(fun)
+                elements[IndexKey.Funs].push(fun)
 
                 if (fun.withSelf()) {
-                    index.elements[IndexKey.Methods].push(fun)
+                    elements[IndexKey.Methods].push(fun)
                 }
 
-                FileIndex.processDeprecated(index, fun)
+                FileIndex.processDeprecated(this, fun)
             }
             if (node.type === "struct") {
                 const struct = new Struct(node, file)
-                FileIndex.processDeprecated(index, struct)
-                index.elements[IndexKey.Structs].push(struct)
+                FileIndex.processDeprecated(this, struct)
+                elements[IndexKey.Structs].push(struct)
             }
             if (node.type === "contract") {
                 const contract = new Contract(node, file)
-                FileIndex.processDeprecated(index, contract)
-                index.elements[IndexKey.Contracts].push(contract)
+                FileIndex.processDeprecated(this, contract)
+                elements[IndexKey.Contracts].push(contract)
             }
             if (node.type === "message") {
                 const message = new Message(node, file)
-                FileIndex.processDeprecated(index, message)
-                index.elements[IndexKey.Messages].push(message)
+                FileIndex.processDeprecated(this, message)
+                elements[IndexKey.Messages].push(message)
             }
             if (node.type === "trait") {
                 const trait = new Trait(node, file)
-                FileIndex.processDeprecated(index, trait)
-                index.elements[IndexKey.Traits].push(trait)
+                FileIndex.processDeprecated(this, trait)
+                elements[IndexKey.Traits].push(trait)
             }
             if (node.type === "primitive") {
                 // primitive type cannot be deprecated
-                index.elements[IndexKey.Primitives].push(new Primitive(node, file))
+                elements[IndexKey.Primitives].push(new Primitive(node, file))
             }
             if (node.type === "global_constant") {
                 const constant = new Constant(node, file)
-                FileIndex.processDeprecated(index, constant)
-                index.elements[IndexKey.Constants].push(constant)
+                FileIndex.processDeprecated(this, constant)
+                elements[IndexKey.Constants].push(constant)
             }
         }
 
-        return index
+        // `name()` reads the tree, so every name is read once here
+        const byName: FileElementsByName = {
+            [IndexKey.Contracts]: groupByName(elements[IndexKey.Contracts]),
+            [IndexKey.Funs]: groupByName(elements[IndexKey.Funs]),
+            [IndexKey.Methods]: groupByName(elements[IndexKey.Methods]),
+            [IndexKey.Messages]: groupByName(elements[IndexKey.Messages]),
+            [IndexKey.Structs]: groupByName(elements[IndexKey.Structs]),
+            [IndexKey.Traits]: groupByName(elements[IndexKey.Traits]),
+            [IndexKey.Primitives]: groupByName(elements[IndexKey.Primitives]),
+            [IndexKey.Constants]: groupByName(elements[IndexKey.Constants]),
+        }
+
+        const byReceiver: Map<string, Fun[]> = new Map()
+        for (const method of elements[IndexKey.Methods]) {
+            const receiver = FileIndex.receiverOf(method)
+            if (receiver === null) continue
+            const methods = byReceiver.get(receiver)
+            if (methods) {
+                methods.push(method)
+            } else {
+                byReceiver.set(receiver, [method])
+            }
+        }
+
+        return {elements, byName, byReceiver}
+    }
+
+    /**
+     * Key of the type of `self` of `method`, matching `Reference.receiverOf` of the
+     * types the method applies to. Methods of maps take any `map<K, V>`, so they
+     * all share one key.
+     */
+    public static receiverOf(method: Fun): string | null {
+        const typeNode = method.parameters()[0].node.childForFieldName("type")
+        if (typeNode === null) return null
+        if (typeNode.type === "map_type") return "map"
+
+        const isOptional = typeNode.nextSibling?.text === "?"
+        return isOptional ? `${typeNode.text}?` : typeNode.text
     }
 
     public static processDeprecated(index: FileIndex, symbol: NamedNode): void {
@@ -123,125 +473,123 @@ export class FileIndex {
         }
     }
 
+    /**
+     * Processes elements with `key`. Processors that take declarations get their
+     * summaries instead, so the file is not parsed.
+     */
     public processElementsByKey(
         key: IndexKey,
         processor: ScopeProcessor,
         state: ResolveState,
     ): boolean {
-        const elements = this.elements[key]
+        if (processor.executeDeclaration !== undefined) {
+            const declarations = this.declarationsByKey(key)
+            if (declarations.length > 0) {
+                CACHE.dependsOn(this.uri)
+            }
+            for (const declaration of declarations) {
+                if (!processor.executeDeclaration(declaration, this, state)) return false
+            }
+            return true
+        }
+
+        const elements = this.current.elements[key]
+        if (elements.length > 0) {
+            CACHE.dependsOn(this.uri)
+        }
         for (const node of elements) {
             if (!processor.execute(node, state)) return false
         }
         return true
     }
 
-    public elementByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K] | null {
-        switch (key) {
-            case IndexKey.Contracts: {
-                return this.findElement(this.elements[IndexKey.Contracts], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Funs: {
-                return this.findElement(this.elements[IndexKey.Funs], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Methods: {
-                return this.findElement(this.elements[IndexKey.Methods], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Messages: {
-                return this.findElement(this.elements[IndexKey.Messages], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Structs: {
-                return this.findElement(this.elements[IndexKey.Structs], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Traits: {
-                return this.findElement(this.elements[IndexKey.Traits], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Primitives: {
-                return this.findElement(this.elements[IndexKey.Primitives], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            case IndexKey.Constants: {
-                return this.findElement(this.elements[IndexKey.Constants], name) as
-                    | IndexKeyToType[K]
-                    | null
-            }
-            default: {
-                return null
-            }
+    public processElementsByName(
+        key: IndexKey,
+        name: string,
+        processor: ScopeProcessor,
+        state: ResolveState,
+    ): boolean {
+        for (const node of this.elementsByName(key, name)) {
+            if (!processor.execute(node, state)) return false
         }
+        return true
     }
 
-    public elementsByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K][] {
-        switch (key) {
-            case IndexKey.Contracts: {
-                return this.findElements(
-                    this.elements[IndexKey.Contracts],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            case IndexKey.Funs: {
-                return this.findElements(this.elements[IndexKey.Funs], name) as IndexKeyToType[K][]
-            }
-            case IndexKey.Methods: {
-                return this.findElements(
-                    this.elements[IndexKey.Methods],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            case IndexKey.Messages: {
-                return this.findElements(
-                    this.elements[IndexKey.Messages],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            case IndexKey.Structs: {
-                return this.findElements(
-                    this.elements[IndexKey.Structs],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            case IndexKey.Traits: {
-                return this.findElements(
-                    this.elements[IndexKey.Traits],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            case IndexKey.Primitives: {
-                return this.findElements(
-                    this.elements[IndexKey.Primitives],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            case IndexKey.Constants: {
-                return this.findElements(
-                    this.elements[IndexKey.Constants],
-                    name,
-                ) as IndexKeyToType[K][]
-            }
-            default: {
-                return []
-            }
+    public processMethodsByReceiver(
+        receiver: string,
+        processor: ScopeProcessor,
+        state: ResolveState,
+    ): boolean {
+        if (!this.receivers.has(receiver)) return true
+        const methods = this.current.byReceiver.get(receiver) ?? []
+        if (methods.length > 0) {
+            CACHE.dependsOn(this.uri)
+        }
+        for (const method of methods) {
+            if (!processor.execute(method, state)) return false
+        }
+        return true
+    }
+
+    /** Element of `declaration` of this file, the file is parsed if it isn't yet. */
+    public elementOf(declaration: DeclarationSummary): IndexKeyToType[IndexKey] | null {
+        const start = declaration.nameRange?.start
+        const elements: IndexKeyToType[IndexKey][] = this.elementsByName(
+            declaration.key,
+            declaration.name,
+        )
+        return (
+            elements.find(element => {
+                const position = element.nameIdentifier()?.startPosition
+                return (
+                    start === undefined ||
+                    (position?.row === start.line && position.column === start.character)
+                )
+            }) ?? null
+        )
+    }
+
+    private declarationsByKey(key: IndexKey): readonly DeclarationSummary[] {
+        if (key === IndexKey.Methods) {
+            return this.declarations.filter(it => it.key === IndexKey.Funs && it.withSelf)
         }
+        return this.declarations.filter(it => it.key === key)
     }
 
-    private findElement<T extends NamedNode>(elements: T[], name: string): T | null {
-        return elements.find(value => value.name() === name) ?? null
+    /** Names of the top-level declarations of the file. */
+    public declaredNames(): ReadonlySet<string> {
+        return this.declared
     }
 
-    private findElements<T extends NamedNode>(elements: T[], name: string): T[] {
-        return elements.filter(value => value.name() === name)
+    /** Keys of the types of `self` of the methods of the file, see `receiverOf`. */
+    public methodReceivers(): ReadonlySet<string> {
+        return this.receivers
+    }
+
+    public elementByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K] | null {
+        return this.elementsByName(key, name).at(0) ?? null
+    }
+
+    public elementsByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K][] {
+        if (!this.declared.has(name)) return []
+        const byName: FileElementsByName[K] = this.current.byName[key]
+        const elements = byName.get(name) ?? []
+        if (elements.length > 0) {
+            CACHE.dependsOn(this.uri)
+        }
+        return elements
+    }
+
+    /**
+     * Whether `other` declares the same names, methods for the same receivers and
+     * has the same imports, so that lookups which found nothing in the old version
+     * of the file still do.
+     */
+    public sameDeclarations(other: FileIndex): boolean {
+        if (this.imports === null || other.imports === null) return false
+        if (this.imports.length !== other.imports.length) return false
+        if (this.imports.some((it, i) => it !== other.imports?.[i])) return false
+        return sameKeys(this.declared, other.declared) && sameKeys(this.receivers, other.receivers)
     }
 
     public isDeprecated(name: string): boolean {
@@ -253,12 +601,30 @@ export class IndexRoot {
     public readonly name: "stdlib" | "stubs" | "workspace"
     public readonly root: string
     public readonly files: Map<string, FileIndex> = new Map()
+    // Shared by all roots of `GlobalIndex` once the root is added to it.
+    private table: DeclarationTable = new DeclarationTable()
+    // Indexes of files that changed and are not indexed again yet.
+    private readonly changed: Map<string, FileIndex> = new Map()
 
     public constructor(name: "stdlib" | "stubs" | "workspace", root: string) {
         this.name = name
         this.root = root
     }
 
+    /** Moves the files of the root to `table`, see `GlobalIndex`. */
+    public useTable(table: DeclarationTable): void {
+        for (const index of this.files.values()) {
+            this.table.remove(index)
+            table.add(this, index)
+        }
+        this.table = table
+    }
+
+    /** Removes the files of the root from the table, once the root is replaced. */
+    public detach(): void {
+        this.useTable(new DeclarationTable())
+    }
+
     public contains(file: string): boolean {
         if (!file.startsWith("file:")) {
             // most likely VS Code temp file can be only in the workspace
@@ -274,31 +640,63 @@ export class IndexRoot {
             return
         }
 
-        if (clearCache) {
+        const index = FileIndex.create(file)
+        const previous = this.changed.get(uri)
+        this.changed.delete(uri)
+
+        // Results cached for the old version of the file are already dropped by
+        // `fileChanged`, but lookups that found nothing may now find something.
+        const declarationsChanged = previous ? !previous.sameDeclarations(index) : clearCache
+        if (declarationsChanged) {
             CACHE.clear()
         }
 
-        const index = FileIndex.create(file)
-        this.files.set(uri, index)
+        this.addIndex(uri, index)
+    }
 
-        console.info(`added ${uri} to index`)
+    /** Adds a file indexed by an indexing worker, it is parsed once its elements are needed. */
+    public addSummary(uri: string, summary: FileSummary): void {
+        if (this.files.has(uri)) {
+            return
+        }
+        this.addIndex(uri, FileIndex.fromSummary(uri, summary))
+    }
+
+    private addIndex(uri: string, index: FileIndex): void {
+        this.files.set(uri, index)
+        this.table.add(this, index)
     }
 
     public removeFile(uri: string): void {
         CACHE.clear()
 
-        this.files.delete(uri)
+        this.forgetFile(uri)
+        this.changed.delete(uri)
         PARSED_FILES_CACHE.delete(uri)
 
         console.info(`removed ${uri} from index`)
     }
 
     public fileChanged(uri: string): void {
-        CACHE.clear()
-        this.files.delete(uri)
+        const index = this.forgetFile(uri)
+        if (index) {
+            CACHE.invalidate(uri)
+            this.changed.set(uri, index)
+        } else {
+            CACHE.clear()
+        }
         console.info(`found changes in ${uri}`)
     }
 
+    private forgetFile(uri: string): FileIndex | undefined {
+        const index = this.files.get(uri)
+        if (!index) return undefined
+
+        this.files.delete(uri)
+        this.table.remove(index)
+        return index
+    }
+
     public findFile(uri: string): FileIndex | undefined {
         return this.files.get(uri)
     }
@@ -333,8 +731,9 @@ export class IndexRoot {
     }
 
     public elementByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K] | null {
-        for (const value of this.files.values()) {
-            const result = value.elementByName(key, name)
+        for (const {root, index} of this.table.declaring(name)) {
+            if (root !== this) continue
+            const result = index.elementByName(key, name)
             if (result) {
                 return result
             }
@@ -343,72 +742,43 @@ export class IndexRoot {
     }
 
     public elementsByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K][] {
-        for (const value of this.files.values()) {
-            const result = value.elementsByName(key, name)
+        for (const {root, index} of this.table.declaring(name)) {
+            if (root !== this) continue
+            const result = index.elementsByName(key, name)
             if (result.length > 0) {
                 return result
             }
         }
         return []
     }
-
-    public hasDeclaration(name: string): boolean {
-        for (const value of this.files.values()) {
-            const element =
-                value.elementByName(IndexKey.Funs, name) ??
-                value.elementByName(IndexKey.Contracts, name) ??
-                value.elementByName(IndexKey.Constants, name) ??
-                value.elementByName(IndexKey.Structs, name) ??
-                value.elementByName(IndexKey.Messages, name) ??
-                value.elementByName(IndexKey.Traits, name) ??
-                value.elementByName(IndexKey.Primitives, name)
-
-            if (element) {
-                return true
-            }
-        }
-        return false
-    }
-
-    public hasSeveralDeclarations(name: string): boolean {
-        let seen = false
-        for (const value of this.files.values()) {
-            const element =
-                value.elementByName(IndexKey.Funs, name) ??
-                value.elementByName(IndexKey.Contracts, name) ??
-                value.elementByName(IndexKey.Constants, name) ??
-                value.elementByName(IndexKey.Structs, name) ??
-                value.elementByName(IndexKey.Messages, name) ??
-                value.elementByName(IndexKey.Traits, name) ??
-                value.elementByName(IndexKey.Primitives, name)
-
-            if (element && seen) {
-                return true
-            }
-
-            if (element) {
-                seen = true
-            }
-        }
-        return false
-    }
 }
 
 export class GlobalIndex {
     public stdlibRoot: IndexRoot | undefined = undefined
     public stubsRoot: IndexRoot | undefined = undefined
     public roots: IndexRoot[] = []
+    private readonly table: DeclarationTable = new DeclarationTable()
 
     public withStdlibRoot(root: IndexRoot): void {
+        this.stdlibRoot?.detach()
         this.stdlibRoot = root
+        root.useTable(this.table)
     }
 
     public withStubsRoot(root: IndexRoot): void {
+        this.stubsRoot?.detach()
         this.stubsRoot = root
+        root.useTable(this.table)
     }
 
     public withRoots(roots: IndexRoot[]): void {
+        for (const root of this.roots) {
+            root.detach()
+        }
         this.roots = roots
+        for (const root of roots) {
+            root.useTable(this.table)
+        }
     }
 
     public allRoots(): IndexRoot[] {
@@ -440,6 +810,13 @@ export class GlobalIndex {
         indexRoot.addFile(uri, file, clearCache)
     }
 
+    public addSummary(uri: string, summary: FileSummary): void {
+        const indexRoot = this.findRootFor(uri)
+        if (!indexRoot) return
+
+        indexRoot.addSummary(uri, summary)
+    }
+
     public removeFile(uri: string): void {
         const indexRoot = this.findRootFor(uri)
         if (!indexRoot) return
@@ -486,30 +863,42 @@ export class GlobalIndex {
         return true
     }
 
+    public processElementsByName(
+        key: IndexKey,
+        name: string,
+        processor: ScopeProcessor,
+        state: ResolveState,
+    ): boolean {
+        for (const {index} of this.table.declaring(name)) {
+            if (!index.processElementsByName(key, name, processor, state)) return false
+        }
+
+        return true
+    }
+
+    /** Processes methods of the type with key `receiver`, see `FileIndex.receiverOf`. */
+    public processMethodsByReceiver(
+        receiver: string,
+        processor: ScopeProcessor,
+        state: ResolveState,
+    ): boolean {
+        for (const {index} of this.table.receiving(receiver)) {
+            if (!index.processMethodsByReceiver(receiver, processor, state)) return false
+        }
+
+        return true
+    }
+
     public elementByName<K extends IndexKey>(key: K, name: string): IndexKeyToType[K] | null {
-        for (const root of this.allRoots()) {
-            const element = root.elementByName(key, name)
+        for (const {index} of this.table.declaring(name)) {
+            const element = index.elementByName(key, name)
             if (element) return element
         }
         return null
     }
 
     public hasSeveralDeclarations(name: string): boolean {
-        let seen = false
-        for (const root of this.allRoots()) {
-            const decl = root.hasDeclaration(name)
-            if (decl && seen) {
-                return true
-            }
-            if (decl) {
-                const hasSeveralDecls = root.hasSeveralDeclarations(name)
-                if (hasSeveralDecls) return true
-
-                seen = true
-            }
-        }
-
-        return false
+        return this.table.declaring(name).length > 1
     }
 }
 
@@ -25,12 +25,21 @@ import {OptimalMathFunctionsInspection} from "@server/languages/tact/inspections
 import {NamingConventionInspection} from "@server/languages/tact/inspections/NamingConventionInspection"
 import {CompilerInspection} from "@server/languages/tact/inspections/CompilerInspection"
 import {MistiInspection} from "@server/languages/tact/inspections/MistInspection"
+import {PARSED_FILES_CACHE, parseTimeoutDiagnostic} from "@server/files"
 
 export async function runInspections(
     uri: string,
     file: TactFile,
     includeLinters: boolean,
+    token: lsp.CancellationToken = lsp.CancellationToken.None,
+    version?: number,
 ): Promise<void> {
+    if (PARSED_FILES_CACHE.timedOut(uri, file.source)) {
+        // the file is treated as empty, there is nothing to inspect
+        await connection.sendDiagnostics({uri, version, diagnostics: [parseTimeoutDiagnostic()]})
+        return
+    }
+
     const inspections = [
         new UnusedParameterInspection(),
         new EmptyBlockInspection(),
@@ -62,6 +71,9 @@ export async function runInspections(
         if (settings.inspections.disabled.includes(inspection.id)) {
             continue
         }
+        // let newer changes of the document come in and cancel the rest
+        await new Promise(resolve => setImmediate(resolve))
+        if (token.isCancellationRequested) return
         diagnostics.push(...inspection.inspect(file))
     }
 
@@ -78,13 +90,21 @@ export async function runInspections(
 
             const allDiagnostics = diagnostics
 
-            void inspection.inspect(file).then(diagnostics => {
-                if (diagnostics.length === 0) return
-                allDiagnostics.push(...diagnostics)
-                void connection.sendDiagnostics({uri, diagnostics: allDiagnostics})
-            })
+            // linters can run longer than the request that started them
+            file.retain()
+            void inspection
+                .inspect(file)
+                .then(diagnostics => {
+                    if (diagnostics.length === 0 || token.isCancellationRequested) return
+                    allDiagnostics.push(...diagnostics)
+                    void connection.sendDiagnostics({uri, version, diagnostics: allDiagnostics})
+                })
+                .finally(() => {
+                    file.release()
+                })
         }
     }
 
-    await connection.sendDiagnostics({uri, diagnostics})
+    if (token.isCancellationRequested) return
+    await connection.sendDiagnostics({uri, version, diagnostics})
 }
@@ -80,8 +80,7 @@ export class FillStructInitBase implements Intention {
     }
 
     private static findIndent(ctx: IntentionContext, instance: SyntaxNode): number {
-        const lines = ctx.file.content.split(/\r?\n/)
-        const line = lines[instance.startPosition.row]
+        const line = ctx.file.lineText(instance.startPosition.row)
         const lineTrim = line.trimStart()
         return line.indexOf(lineTrim)
     }
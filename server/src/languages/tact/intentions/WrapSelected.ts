@@ -77,8 +77,7 @@ export class WrapSelected implements Intention {
     }
 
     private static findIndent(ctx: IntentionContext, node: SyntaxNode): number {
-        const lines = ctx.file.content.split(/\r?\n/)
-        const line = lines[node.startPosition.row]
+        const line = ctx.file.lineText(node.startPosition.row)
         const lineTrim = line.trimStart()
         return line.indexOf(lineTrim)
     }
@@ -9,7 +9,7 @@ import {Position} from "vscode-languageclient"
 import {asLspPosition} from "@server/utils/position"
 import {computeGasConsumption, GasConsumption} from "@server/languages/tact/asm/gas"
 import {messageOpcode} from "@server/languages/tact/compiler/tlb/compiler-tlb"
-import {MessageTy} from "@server/languages/tact/types/BaseTy"
+import {TYPES} from "@server/languages/tact/types/BaseTy"
 import {normalizeIndentation} from "@server/utils/strings"
 
 export class FieldsOwner extends NamedNode {
@@ -79,7 +79,7 @@ export class Message extends FieldsOwner {
             return undefined
         }
 
-        const opcode = messageOpcode(new MessageTy(this.name(), this))
+        const opcode = messageOpcode(TYPES.message(this))
         if (opcode === undefined) return undefined
         return "0x" + opcode.toString(16)
     }
@@ -12,8 +12,10 @@ import {
     StructTy,
     TraitTy,
     Ty,
+    TYPES,
 } from "@server/languages/tact/types/BaseTy"
 import {index, IndexFinder, IndexKey} from "@server/languages/tact/indexes"
+import type {DeclarationSummary, FileIndex} from "@server/languages/tact/indexes"
 import {CallLike, Expression, NamedNode, TactNode} from "./TactNode"
 import type {TactFile} from "./TactFile"
 import {Contract, Field, FieldsOwner, Fun, Message, Struct, Trait} from "./Decls"
@@ -23,9 +25,21 @@ import {TypeInferer} from "@server/languages/tact/TypeInferer"
 import {ImportResolver} from "@server/languages/tact/psi/ImportResolver"
 import {filePathToUri} from "@server/files"
 import {ResolveState} from "@server/psi/ResolveState"
+import {ScopeTable} from "@server/languages/tact/psi/ScopeTable"
 
 export interface ScopeProcessor {
     execute(node: TactNode, state: ResolveState): boolean
+
+    /**
+     * Processes a declaration found by `IndexFinder.processElementsByKey` from the
+     * summary of its file, see `DeclarationSummary`, so going through all files
+     * doesn't parse them. Processors without it get the elements instead.
+     */
+    executeDeclaration?(
+        declaration: DeclarationSummary,
+        file: FileIndex,
+        state: ResolveState,
+    ): boolean
 }
 
 /**
@@ -59,7 +73,8 @@ export class Reference {
     }
 
     public resolve(): NamedNode | null {
-        return CACHE.resolveCache.cached(this.element.node.id, () => this.resolveImpl())
+        const element = this.element
+        return CACHE.resolveCache.cached(element.file, element.node.id, () => this.resolveImpl())
     }
 
     private resolveImpl(): NamedNode | null {
@@ -217,12 +232,12 @@ export class Reference {
 
             const nodeStruct = index.elementByName(IndexKey.Primitives, "AnyStruct")
             if (nodeStruct && (methodRef || state.get("completion"))) {
-                const structPrimitiveTy = new PrimitiveTy("AnyStruct", nodeStruct, null)
+                const structPrimitiveTy = TYPES.primitive(nodeStruct)
                 if (!this.processType(qualifier, structPrimitiveTy, proc, state)) return false
             }
             const nodeMessage = index.elementByName(IndexKey.Primitives, "AnyMessage")
             if (nodeMessage && (methodRef || state.get("completion"))) {
-                const messagePrimitiveTy = new PrimitiveTy("AnyMessage", nodeMessage, null)
+                const messagePrimitiveTy = TYPES.primitive(nodeMessage)
                 if (!this.processType(qualifier, messagePrimitiveTy, proc, state)) return false
             }
         }
@@ -258,7 +273,7 @@ export class Reference {
 
             const nodeContract = index.elementByName(IndexKey.Primitives, "AnyContract")
             if (nodeContract && (methodRef || state.get("completion"))) {
-                const contractPrimitiveTy = new PrimitiveTy("AnyContract", nodeContract, null)
+                const contractPrimitiveTy = TYPES.primitive(nodeContract)
                 if (!this.processType(qualifier, contractPrimitiveTy, proc, state)) return false
             }
         }
@@ -276,7 +291,7 @@ export class Reference {
         }
 
         // last resort, trying to find methods of T?
-        return this.processType(qualifier, new OptionTy(qualifierType), proc, state)
+        return this.processType(qualifier, TYPES.option(qualifierType), proc, state)
     }
 
     private processType(
@@ -314,40 +329,14 @@ export class Reference {
     }
 
     private processTypeMethods(ty: Ty, proc: ScopeProcessor, state: ResolveState): boolean {
-        const tyName = ty.qualifiedName()
-        return index.processElementsByKey(
-            IndexKey.Methods,
-            new (class implements ScopeProcessor {
-                public execute(fun: Fun, state: ResolveState): boolean {
-                    const selfParam = fun.parameters()[0]
-                    const typeNode = selfParam.node.childForFieldName("type")
-                    if (typeNode === null) return true
-
-                    const isOptional = typeNode.nextSibling?.text === "?"
-                    if (Reference.typeMatches(ty, tyName, isOptional, typeNode)) {
-                        return proc.execute(fun, state)
-                    }
-
-                    return true
-                }
-            })(),
-            state,
-        )
+        return index.processMethodsByReceiver(Reference.receiverOf(ty), proc, state)
     }
 
-    private static typeMatches(
-        ty: Ty,
-        tyName: string,
-        isOptional: boolean,
-        typeNode: SyntaxNode,
-    ): boolean {
-        if (typeNode.type === "map_type") {
-            return ty instanceof MapTy
-        }
-        if (isOptional) {
-            return ty instanceof OptionTy && ty.innerTy.name() === typeNode.text
-        }
-        return tyName === typeNode.text
+    // Key of the methods of `ty` in the index, see `FileIndex.receiverOf`.
+    private static receiverOf(ty: Ty): string {
+        if (ty instanceof MapTy) return "map"
+        if (ty instanceof OptionTy) return `${ty.innerTy.name()}?`
+        return ty.qualifiedName()
     }
 
     private processUnqualifiedResolve(proc: ScopeProcessor, state: ResolveState): boolean {
@@ -423,7 +412,11 @@ export class Reference {
             return this.processAllEntities(proc, state)
         }
 
-        if (!this.processBlock(proc, state)) return false
+        // outside of completion, only variables with the name we search for can match
+        const name = state.get("completion")
+            ? undefined
+            : (state.get("search-name") ?? this.element.name())
+        if (!this.processBlock(proc, state, name)) return false
 
         return this.processAllEntities(proc, state)
     }
@@ -605,21 +598,28 @@ export class Reference {
         const file = this.element.file
 
         if (state.get("completion")) {
-            const processor = new (class implements ScopeProcessor {
-                public execute(node: TactNode, state: ResolveState): boolean {
+            // this functions in fact static methods
+            const isStaticMethod = (name: string): boolean =>
+                name.startsWith("AnyStruct_") ||
+                name.startsWith("AnyMessage_") ||
+                name.startsWith("AnyContract_")
+
+            const executeDeclaration = proc.executeDeclaration?.bind(proc)
+            // don't add methods to unqualified completion
+            const processor: ScopeProcessor = {
+                execute(node: TactNode, state: ResolveState): boolean {
                     if (!(node instanceof Fun)) return true
-                    if (node.withSelf()) return true // don't add methods to unqualified completion
-                    if (
-                        node.name().startsWith("AnyStruct_") ||
-                        node.name().startsWith("AnyMessage_") ||
-                        node.name().startsWith("AnyContract_")
-                    ) {
-                        // this functions in fact static methods
-                        return true
-                    }
+                    if (node.withSelf() || isStaticMethod(node.name())) return true
                     return proc.execute(node, state)
-                }
-            })()
+                },
+                executeDeclaration:
+                    executeDeclaration &&
+                    ((declaration, file, state) => {
+                        if (declaration.key !== IndexKey.Funs) return true
+                        if (declaration.withSelf || isStaticMethod(declaration.name)) return true
+                        return executeDeclaration(declaration, file, state)
+                    }),
+            }
 
             if (!index.processElsByKeyAndFile(IndexKey.Funs, file, processor, state)) return false
             if (!index.processElsByKeyAndFile(IndexKey.Primitives, file, proc, state)) return false
@@ -749,73 +749,47 @@ export class Reference {
         return undefined
     }
 
+    // Outside of completion only declarations named like the element can match,
+    // so only those are processed.
     private processElsInIndex(
         proc: ScopeProcessor,
         state: ResolveState,
         fileIndex: IndexFinder,
     ): boolean {
-        if (!fileIndex.processElementsByKey(IndexKey.Funs, proc, state)) return false
-        if (!fileIndex.processElementsByKey(IndexKey.Primitives, proc, state)) return false
-        if (!fileIndex.processElementsByKey(IndexKey.Structs, proc, state)) return false
-        if (!fileIndex.processElementsByKey(IndexKey.Messages, proc, state)) return false
-        if (!fileIndex.processElementsByKey(IndexKey.Traits, proc, state)) return false
-        if (!fileIndex.processElementsByKey(IndexKey.Constants, proc, state)) return false
-        return fileIndex.processElementsByKey(IndexKey.Contracts, proc, state)
+        const name = this.element.name()
+        if (!fileIndex.processElementsByName(IndexKey.Funs, name, proc, state)) return false
+        if (!fileIndex.processElementsByName(IndexKey.Primitives, name, proc, state)) return false
+        if (!fileIndex.processElementsByName(IndexKey.Structs, name, proc, state)) return false
+        if (!fileIndex.processElementsByName(IndexKey.Messages, name, proc, state)) return false
+        if (!fileIndex.processElementsByName(IndexKey.Traits, name, proc, state)) return false
+        if (!fileIndex.processElementsByName(IndexKey.Constants, name, proc, state)) return false
+        return fileIndex.processElementsByName(IndexKey.Contracts, name, proc, state)
     }
 
-    public processBlock(proc: ScopeProcessor, state: ResolveState): boolean {
+    /**
+     * Processes local variables and parameters visible at the element. With `name`,
+     * only variables with this name are processed.
+     */
+    public processBlock(proc: ScopeProcessor, state: ResolveState, name?: string): boolean {
         const file = this.element.file
         let descendant: SyntaxNode | null = this.element.node
+        let scopes: ScopeTable | null = null
 
         let startStatement: SyntaxNode | null = null
 
         while (descendant) {
             // walk all variables inside block
             if (descendant.type === "block_statement" || descendant.type === "function_body") {
-                const statements = descendant.children
-                for (const stmt of statements) {
-                    if (!stmt) break
-
-                    // reached the starting statement, look no further
-                    if (startStatement && stmt.equals(startStatement)) break
-                    if (stmt.type === "let_statement") {
-                        // let name = expr;
-                        //     ^^^^ this
-                        const name = stmt.childForFieldName("name")
-                        if (name === null) break
-                        if (!proc.execute(new NamedNode(name, file), state)) return false
-                    }
-
-                    if (stmt.type === "destruct_statement") {
-                        // let Foo { name, other: value } = foo()
-                        //         ^^^^^^^^^^^^^^^^^^^^^^ this
-                        const bindList = stmt.childForFieldName("binds")
-                        if (!bindList) break
-
-                        // let Foo { name, other: value } = foo()
-                        //           ^^^^^ ^^^^^^^^^^^^ this
-                        const bindings = bindList.children
-                            .filter(it => it?.type === "destruct_bind")
-                            .filter(it => it !== null)
-
-                        for (const bind of bindings) {
-                            // let Foo { name, other: value } = foo()
-                            //                        ^^^^^
-                            // or
-                            // let Foo { name, other: value } = foo()
-                            //           ^^^^
-                            const actualName =
-                                bind.childForFieldName("bind") ?? bind.childForFieldName("name")
-
-                            if (
-                                actualName &&
-                                !proc.execute(new NamedNode(actualName, file), state)
-                            ) {
-                                return false
-                            }
-                        }
-                    }
+                if (!scopes?.has(descendant)) {
+                    scopes = ScopeTable.containing(descendant, file)
                 }
+
+                // reached the starting statement, look no further
+                const before =
+                    startStatement?.parent?.equals(descendant) === true
+                        ? startStatement.startIndex
+                        : Infinity
+                if (!scopes.processBlock(descendant, before, name, proc, state)) return false
             }
 
             if (descendant.type === "foreach_statement") {
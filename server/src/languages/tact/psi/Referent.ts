@@ -36,15 +36,38 @@ export class LocalSearchScope implements SearchScope {
  * For example, the scope of a global function from the standard library is all project files.
  */
 export class GlobalSearchScope implements SearchScope {
-    public static allFiles(): GlobalSearchScope {
-        const files = [...PARSED_FILES_CACHE.values()]
-        return new GlobalSearchScope(files)
+    /**
+     * All files containing one of `words`. Other files can't refer to the searched
+     * element, so they are skipped without being parsed.
+     */
+    public static allFiles(words: readonly string[] = []): GlobalSearchScope {
+        return new GlobalSearchScope(PARSED_FILES_CACHE.uris(), words)
     }
 
-    public constructor(public files: TactFile[]) {}
+    public constructor(
+        public readonly uris: readonly string[],
+        private readonly words: readonly string[] = [],
+    ) {}
+
+    /** Files of the scope, evicted files are parsed again only once they are reached. */
+    public *files(): Generator<TactFile> {
+        for (const uri of this.uris) {
+            const source = PARSED_FILES_CACHE.source(uri)
+            if (source === undefined) continue
+            if (this.words.length > 0) {
+                const text = source.toString()
+                if (!this.words.some(word => text.includes(word))) continue
+            }
+
+            const file = PARSED_FILES_CACHE.get(uri)
+            if (file !== undefined) {
+                yield file
+            }
+        }
+    }
 
     public toString(): string {
-        return `GlobalSearchScope:\n${this.files.map(f => `- ${f.uri}`).join("\n")}`
+        return `GlobalSearchScope:\n${this.uris.map(uri => `- ${uri}`).join("\n")}`
     }
 }
 
@@ -141,7 +164,7 @@ export class Referent {
                 return
             }
 
-            for (const file of scope.files) {
+            for (const file of scope.files()) {
                 this.traverseTree(file, file.rootNode, includeSelf, result, limit)
                 if (result.length === limit) {
                     break
@@ -258,6 +281,14 @@ export class Referent {
         })
     }
 
+    // Words one of which a file must contain to refer to the resolved element:
+    // `self` refers to an enclosing declaration, so its file contains the name anyway.
+    private searchedWords(): string[] {
+        if (!this.resolved) return []
+        if (this.resolved.node.type === "init_function") return ["initOf"]
+        return [this.resolved.name()]
+    }
+
     /**
      * Returns the effective node in which all possible usages are expected.
      * Outside this node, no usages are assumed to exist. For example, variable
@@ -329,7 +360,7 @@ export class Referent {
             const owner = parentOfType(parent, "contract", "trait")
             if (owner?.type === "trait") {
                 // can be used in other traits, optimize?
-                return GlobalSearchScope.allFiles()
+                return GlobalSearchScope.allFiles(this.searchedWords())
             }
             // search in whole contract
             return Referent.localSearchScope(owner)
@@ -345,15 +376,15 @@ export class Referent {
             node.type === "struct" ||
             node.type === "message"
         ) {
-            return GlobalSearchScope.allFiles()
+            return GlobalSearchScope.allFiles(this.searchedWords())
         }
 
         if (node.type === "field") {
-            return GlobalSearchScope.allFiles()
+            return GlobalSearchScope.allFiles(this.searchedWords())
         }
 
         if (this.resolved.node.type === "init_function") {
-            return GlobalSearchScope.allFiles()
+            return GlobalSearchScope.allFiles(this.searchedWords())
         }
 
         return null
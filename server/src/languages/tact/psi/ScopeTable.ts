@@ -0,0 +1,160 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import type {Node as SyntaxNode} from "web-tree-sitter"
+import {NamedNode} from "@server/languages/tact/psi/TactNode"
+import type {TactFile} from "@server/languages/tact/psi/TactFile"
+import type {ScopeProcessor} from "@server/languages/tact/psi/Reference"
+import type {ResolveState} from "@server/psi/ResolveState"
+import {RecursiveVisitor} from "@server/languages/tact/psi/visitor"
+import {CACHE} from "@server/languages/tact/cache"
+
+interface Binding {
+    readonly node: NamedNode
+    readonly name: string
+    // start of the statement declaring the binding
+    readonly start: number
+}
+
+interface BlockScope {
+    // in the order of declaration
+    readonly bindings: readonly Binding[]
+    readonly byName: ReadonlyMap<string, readonly Binding[]>
+}
+
+function isBlock(node: SyntaxNode): boolean {
+    return node.type === "block_statement" || node.type === "function_body"
+}
+
+/**
+ * Variables declared by `let` and destructuring statements in every block of a
+ * function body, built once per tree the first time anything inside the body is
+ * resolved. Resolving a local variable then looks up its name instead of going
+ * over all statements of every enclosing block again.
+ */
+export class ScopeTable {
+    private constructor(private readonly blocks: ReadonlyMap<number, BlockScope>) {}
+
+    /** Table of the function body containing `block`, or of `block` itself outside of one. */
+    public static containing(block: SyntaxNode, file: TactFile): ScopeTable {
+        let root = block
+        for (let node: SyntaxNode | null = block; node; node = node.parent) {
+            if (node.type === "function_body") {
+                root = node
+                break
+            }
+        }
+        return CACHE.scopeCache.cached(file, root.id, () => ScopeTable.build(root, file))
+    }
+
+    public has(block: SyntaxNode): boolean {
+        return this.blocks.has(block.id)
+    }
+
+    /**
+     * Processes variables of `block` declared by statements starting before
+     * `before`, in the order of declaration. With `name`, only variables with
+     * this name are processed.
+     */
+    public processBlock(
+        block: SyntaxNode,
+        before: number,
+        name: string | undefined,
+        proc: ScopeProcessor,
+        state: ResolveState,
+    ): boolean {
+        const scope = this.blocks.get(block.id)
+        if (!scope) return true
+
+        if (name !== undefined) {
+            for (const binding of scope.byName.get(name) ?? []) {
+                if (binding.start >= before) break
+                if (!proc.execute(binding.node, state)) return false
+            }
+            return true
+        }
+
+        const bindings = scope.bindings
+        const count = ScopeTable.countBefore(bindings, before)
+        for (let i = 0; i < count; i++) {
+            if (!proc.execute(bindings[i].node, state)) return false
+        }
+        return true
+    }
+
+    // Number of bindings declared before `offset`, bindings are sorted by start.
+    private static countBefore(bindings: readonly Binding[], offset: number): number {
+        let low = 0
+        let high = bindings.length
+        while (low < high) {
+            const mid = (low + high) >>> 1
+            if (bindings[mid].start < offset) {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        return low
+    }
+
+    private static build(root: SyntaxNode, file: TactFile): ScopeTable {
+        const blocks: Map<number, BlockScope> = new Map()
+        RecursiveVisitor.visit(root, node => {
+            if (isBlock(node)) {
+                blocks.set(node.id, ScopeTable.blockScope(node, file))
+            }
+            return true
+        })
+        return new ScopeTable(blocks)
+    }
+
+    private static blockScope(block: SyntaxNode, file: TactFile): BlockScope {
+        const bindings: Binding[] = []
+        const add = (statement: SyntaxNode, name: SyntaxNode): void => {
+            const node = new NamedNode(name, file)
+            bindings.push({node, name: node.name(), start: statement.startIndex})
+        }
+
+        for (const stmt of block.children) {
+            if (!stmt) break
+
+            if (stmt.type === "let_statement") {
+                // let name = expr;
+                //     ^^^^ this
+                const name = stmt.childForFieldName("name")
+                if (name === null) break
+                add(stmt, name)
+            }
+
+            if (stmt.type === "destruct_statement") {
+                // let Foo { name, other: value } = foo()
+                //         ^^^^^^^^^^^^^^^^^^^^^^ this
+                const bindList = stmt.childForFieldName("binds")
+                if (!bindList) break
+
+                for (const bind of bindList.children) {
+                    if (bind?.type !== "destruct_bind") continue
+
+                    // let Foo { name, other: value } = foo()
+                    //           ^^^^         ^^^^^ this
+                    const actualName =
+                        bind.childForFieldName("bind") ?? bind.childForFieldName("name")
+                    if (actualName) {
+                        add(stmt, actualName)
+                    }
+                }
+            }
+        }
+
+        const byName: Map<string, Binding[]> = new Map()
+        for (const binding of bindings) {
+            const named = byName.get(binding.name)
+            if (named) {
+                named.push(binding)
+            } else {
+                byName.set(binding.name, [binding])
+            }
+        }
+
+        return {bindings, byName}
+    }
+}
@@ -8,8 +8,18 @@ import type {Position} from "vscode-languageclient"
 import {trimSuffix} from "@server/utils/strings"
 import {ImportResolver} from "@server/languages/tact/psi/ImportResolver"
 import {File} from "@server/psi/File"
+import {CACHE} from "@server/languages/tact/cache"
 
 export class TactFile extends File {
+    public override release(): boolean {
+        const deleted = super.release()
+        if (deleted) {
+            // results cached for the nodes of the tree are no longer reachable
+            CACHE.released(this)
+        }
+        return deleted
+    }
+
     public get fromStdlib(): boolean {
         return this.uri.includes("stdlib")
     }
@@ -19,7 +29,7 @@ export class TactFile extends File {
     }
 
     public symbolAt(offset: number): string {
-        return this.content[offset] ?? ""
+        return this.slice(offset, offset + 1)
     }
 
     public isImportedImplicitly(): boolean {
@@ -35,7 +35,7 @@ export function onFileRenamed(params: RenameFilesParams): void {
         const file = PARSED_FILES_CACHE.get(oldUri)
         if (file) {
             PARSED_FILES_CACHE.delete(oldUri)
-            const newFile = new TactFile(newUri, file.tree, file.content)
+            const newFile = new TactFile(newUri, file.tree.copy(), file.source)
             PARSED_FILES_CACHE.set(newUri, newFile)
 
             index.removeFile(oldUri)
@@ -75,7 +75,7 @@ async function processFileRename(
             }
 
             const oldFile = await findTactFile(oldUri)
-            const newFile = new TactFile(newUri, oldFile.tree, oldFile.content)
+            const newFile = new TactFile(newUri, oldFile.tree, oldFile.source)
             const newImportPath = newFile.importPath(file)
             const range = asLspRange(pathNode)
 
@@ -6,6 +6,7 @@ import {
     TypeSignature,
 } from "@server/languages/tact/search/TypeSignatureParser"
 import {index, IndexKey} from "@server/languages/tact/indexes"
+import type {DeclarationSummary, FileIndex} from "@server/languages/tact/indexes"
 import {ScopeProcessor} from "@server/languages/tact/psi/Reference"
 import {TactNode} from "@server/languages/tact/psi/TactNode"
 import {Fun, Contract, Trait} from "@server/languages/tact/psi/Decls"
@@ -55,6 +56,20 @@ export class TypeBasedSearch {
 
                 return true
             }
+
+            public executeDeclaration(
+                declaration: DeclarationSummary,
+                file: FileIndex,
+                _state: ResolveState,
+            ): boolean {
+                if (TypeSignatureUtils.matchesSignature(declaration.signature, signature)) {
+                    const result = TypeBasedSearch.declarationResult(declaration, file, "function")
+                    if (result) {
+                        results.push(result)
+                    }
+                }
+                return true
+            }
         })()
 
         index.processElementsByKey(IndexKey.Funs, processor, state)
@@ -84,6 +99,26 @@ export class TypeBasedSearch {
 
                 return true
             }
+
+            public executeDeclaration(
+                declaration: DeclarationSummary,
+                file: FileIndex,
+                _state: ResolveState,
+            ): boolean {
+                for (const method of declaration.methods) {
+                    if (!TypeSignatureUtils.matchesSignature(method.signature, signature)) continue
+                    const result = TypeBasedSearch.declarationResult(
+                        method,
+                        file,
+                        method.getter ? "getter" : "method",
+                        declaration.name,
+                    )
+                    if (result) {
+                        results.push(result)
+                    }
+                }
+                return true
+            }
         })()
 
         index.processElementsByKey(IndexKey.Contracts, processor, state)
@@ -109,11 +144,48 @@ export class TypeBasedSearch {
 
                 return true
             }
+
+            public executeDeclaration(
+                declaration: DeclarationSummary,
+                file: FileIndex,
+                _state: ResolveState,
+            ): boolean {
+                for (const method of declaration.methods) {
+                    if (!TypeSignatureUtils.matchesSignature(method.signature, signature)) continue
+                    const result = TypeBasedSearch.declarationResult(
+                        method,
+                        file,
+                        "method",
+                        declaration.name,
+                    )
+                    if (result) {
+                        results.push(result)
+                    }
+                }
+                return true
+            }
         })()
 
         index.processElementsByKey(IndexKey.Traits, processor, state)
     }
 
+    // Same as `createSearchResult`, for a function known by its summary.
+    private static declarationResult(
+        func: DeclarationSummary,
+        file: FileIndex,
+        kind: TypeSearchResult["kind"],
+        containerName?: string,
+    ): TypeSearchResult | null {
+        if (func.nameRange === null) return null
+        return {
+            name: func.name,
+            signature: func.signature,
+            location: {uri: file.uri, range: func.nameRange},
+            kind: kind,
+            containerName: containerName,
+        }
+    }
+
     private static createSearchResult(func: Fun, containerName?: string): TypeSearchResult | null {
         const nameIdentifier = func.nameIdentifier()
         if (!nameIdentifier) return null
@@ -126,10 +198,11 @@ export class TypeBasedSearch {
 
         let kind: TypeSearchResult["kind"] = "function"
 
-        const parent = func.node.parent
-        if (parent?.type === "contract") {
+        // the parent of a method is the body of its contract or trait
+        const owner = func.owner()
+        if (owner?.node.type === "contract") {
             kind = func.isGetMethod ? "getter" : "method"
-        } else if (parent?.type === "trait") {
+        } else if (owner?.node.type === "trait") {
             kind = "method"
         }
 
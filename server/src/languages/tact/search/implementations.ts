@@ -2,6 +2,7 @@
 //  Copyright © 2025 TON Studio
 import {Constant, Contract, Field, Fun, Trait} from "@server/languages/tact/psi/Decls"
 import {index, IndexKey} from "@server/languages/tact/indexes"
+import type {DeclarationSummary, FileIndex} from "@server/languages/tact/indexes"
 import {ScopeProcessor} from "@server/languages/tact/psi/Reference"
 import type {TactNode} from "@server/languages/tact/psi/TactNode"
 import {ResolveState} from "@server/psi/ResolveState"
@@ -35,6 +36,26 @@ class ImplementationProcessor implements ScopeProcessor {
 
         return true
     }
+
+    // Only files of contracts and traits that name the trait are parsed.
+    public executeDeclaration(
+        declaration: DeclarationSummary,
+        file: FileIndex,
+        state: ResolveState,
+    ): boolean {
+        if (declaration.key !== IndexKey.Contracts && declaration.key !== IndexKey.Traits) {
+            return true
+        }
+
+        // every contract and trait inherits `BaseTrait`, see `inheritTraits`
+        const name = this.trait.name()
+        const named =
+            name === "BaseTrait" ? declaration.name !== name : declaration.traits.includes(name)
+        if (!named) return true
+
+        const element = file.elementOf(declaration)
+        return element === null || this.execute(element, state)
+    }
 }
 
 export function implementationsFun(fun: Fun): Fun[] {
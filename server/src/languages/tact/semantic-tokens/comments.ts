@@ -1,13 +1,14 @@
 //  SPDX-License-Identifier: MIT
 //  Copyright © 2025 TON Studio
 import {Position} from "vscode-languageclient"
-import type {Node as SyntaxNode, Parser} from "web-tree-sitter"
+import type {Node as SyntaxNode} from "web-tree-sitter"
 import {parse} from "@textlint/markdown-to-ast"
 import {TxtCodeBlockNode} from "@textlint/ast-node-types"
 import * as lsp from "vscode-languageserver"
 import {RecursiveVisitor} from "@server/languages/tact/psi/visitor"
 import {Tokens} from "@server/languages/tact/semantic-tokens/tokens"
 import {SemanticTokenTypes} from "vscode-languageserver-protocol"
+import {tactParsers, tlbParsers} from "@server/parser"
 
 const KEYWORDS = {
     extend: true,
@@ -238,8 +239,6 @@ export function processDocComment(
         lines: string[]
         startPosition: Position
     },
-    parser: Parser,
-    tlbParser: Parser,
 ): void {
     const ast = parse(comment.lines.join("\n"))
     for (const node of ast.children) {
@@ -273,7 +272,7 @@ export function processDocComment(
         if (node.type !== "CodeBlock") continue
 
         if (node.lang === "tact") {
-            const tree = parser.parse(node.value)
+            const tree = tactParsers.use(parser => parser.parse(node.value))
             if (!tree) {
                 cannotParseCommentError(node)
                 continue
@@ -293,7 +292,7 @@ export function processDocComment(
             node.lang === "TL-B" ||
             node.lang === "TL-b"
         ) {
-            const tree = tlbParser.parse(node.value)
+            const tree = tlbParsers.use(parser => parser.parse(node.value))
             if (!tree) {
                 cannotParseCommentError(node)
                 continue
@@ -17,6 +17,7 @@ import {
 import {asLspRange, asNullableLspRange} from "@server/utils/position"
 import {ScopeProcessor} from "@server/languages/tact/psi/Reference"
 import {index, IndexKey} from "@server/languages/tact/indexes"
+import type {DeclarationSummary, FileIndex} from "@server/languages/tact/indexes"
 import {ResolveState} from "@server/psi/ResolveState"
 
 export async function provideTactDocumentSymbols(file: TactFile): Promise<lsp.DocumentSymbol[]> {
@@ -153,6 +154,26 @@ export function provideTactWorkspaceSymbols(): lsp.WorkspaceSymbol[] {
             })
             return true
         }
+
+        // answered from the index, files that are not open are not parsed
+        public executeDeclaration(
+            declaration: DeclarationSummary,
+            file: FileIndex,
+            _state: ResolveState,
+        ): boolean {
+            if (declaration.nameRange === null) return true
+
+            result.push({
+                name: declaration.name,
+                containerName: "",
+                kind: declarationSymbolKind(declaration.key),
+                location: {
+                    uri: file.uri,
+                    range: declaration.nameRange,
+                },
+            })
+            return true
+        }
     })()
 
     index.processElementsByKey(IndexKey.Contracts, proc, state)
@@ -166,6 +187,32 @@ export function provideTactWorkspaceSymbols(): lsp.WorkspaceSymbol[] {
     return result
 }
 
+// Same as `symbolKind` of the element of the declaration.
+function declarationSymbolKind(key: IndexKey): lsp.SymbolKind {
+    switch (key) {
+        case IndexKey.Funs:
+        case IndexKey.Methods: {
+            return lsp.SymbolKind.Function
+        }
+        case IndexKey.Contracts: {
+            return lsp.SymbolKind.Class
+        }
+        case IndexKey.Messages:
+        case IndexKey.Structs: {
+            return lsp.SymbolKind.Struct
+        }
+        case IndexKey.Traits: {
+            return lsp.SymbolKind.TypeParameter
+        }
+        case IndexKey.Primitives: {
+            return lsp.SymbolKind.Property
+        }
+        case IndexKey.Constants: {
+            return lsp.SymbolKind.Constant
+        }
+    }
+}
+
 function symbolKind(node: NamedNode): lsp.SymbolKind {
     if (node instanceof Fun) {
         return lsp.SymbolKind.Function
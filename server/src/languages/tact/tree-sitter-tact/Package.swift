@@ -14,17 +14,20 @@ let package = Package(
                 exclude: [
                     "Cargo.toml",
                     "Makefile",
+                    "bench",
                     "binding.gyp",
                     "bindings/c",
                     "bindings/go",
                     "bindings/node",
                     "bindings/python",
                     "bindings/rust",
+                    "fuzz",
                     "prebuilds",
                     "grammar.js",
                     "package.json",
                     "package-lock.json",
                     "pyproject.toml",
+                    "scripts",
                     "setup.py",
                     "test",
                     "examples",
@@ -0,0 +1,368 @@
+// Parser throughput benchmark for tree-sitter-tact.
+//
+// Parses the test corpus, the sample contract and synthetic inputs built by
+// repeating them, both from scratch and as an edit followed by an incremental
+// reparse, and prints the results as JSON. Built with the batch parser, it also
+// parses a workspace of copies of the sample on one thread and on all cores:
+//
+//   tact-parse-bench [--iterations N] [--sizes KiB,KiB,...] [grammar-dir]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <tree_sitter/api.h>
+#include "tree-sitter-tact.h"
+#ifdef TACT_BENCH_BATCH
+#include "tree-sitter-tact-batch.h"
+#endif
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef TACT_GRAMMAR_DIR
+#define TACT_GRAMMAR_DIR "."
+#endif
+
+#define DEFAULT_ITERATIONS 20
+#define DEFAULT_SIZES "64,1024,8192"
+#define BATCH_FILES 256
+
+typedef struct {
+  char *data;
+  size_t length;
+  size_t capacity;
+} Buffer;
+
+typedef struct {
+  const char *name;
+  const char *mode;
+  size_t bytes;
+  unsigned iterations;
+  double seconds;
+  uint64_t nodes;
+} BenchResult;
+
+static void buffer_append(Buffer *buffer, const char *data, size_t length) {
+  if (buffer->length + length + 1 > buffer->capacity) {
+    size_t capacity = buffer->capacity != 0 ? buffer->capacity : 4096;
+    while (capacity < buffer->length + length + 1) capacity *= 2;
+    buffer->data = realloc(buffer->data, capacity);
+    if (buffer->data == NULL) {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+    buffer->capacity = capacity;
+  }
+  memcpy(buffer->data + buffer->length, data, length);
+  buffer->length += length;
+  buffer->data[buffer->length] = '\0';
+}
+
+static bool read_file(const char *path, Buffer *buffer) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) return false;
+
+  char chunk[8192];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    buffer_append(buffer, chunk, read);
+  }
+  fclose(file);
+  return true;
+}
+
+static bool starts_with(const char *line, size_t length, char c) {
+  return length >= 3 && line[0] == c && line[1] == c && line[2] == c;
+}
+
+// Append the source part of every test in a corpus file, that is, the text
+// between the `===` header and the `---` separator.
+static void append_corpus_sources(const Buffer *corpus, Buffer *out) {
+  enum { SKIP, HEADER, SOURCE } state = SKIP;
+
+  const char *line = corpus->data;
+  const char *end = corpus->data + corpus->length;
+  while (line < end) {
+    const char *next = memchr(line, '\n', (size_t)(end - line));
+    size_t length = next != NULL ? (size_t)(next - line) : (size_t)(end - line);
+
+    if (starts_with(line, length, '=')) {
+      state = state == HEADER ? SOURCE : HEADER;
+    } else if (state == SOURCE && starts_with(line, length, '-')) {
+      state = SKIP;
+    } else if (state == SOURCE) {
+      buffer_append(out, line, length);
+      buffer_append(out, "\n", 1);
+    }
+
+    line = next != NULL ? next + 1 : end;
+  }
+}
+
+static size_t load_corpus(const char *grammar_dir, Buffer *out) {
+  char path[4096];
+  snprintf(path, sizeof(path), "%s/test/corpus", grammar_dir);
+
+  DIR *dir = opendir(path);
+  if (dir == NULL) return 0;
+
+  size_t files = 0;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    size_t name_length = strlen(entry->d_name);
+    if (name_length < 4 || strcmp(entry->d_name + name_length - 4, ".txt") != 0) continue;
+
+    snprintf(path, sizeof(path), "%s/test/corpus/%s", grammar_dir, entry->d_name);
+    Buffer corpus = {0};
+    if (read_file(path, &corpus)) {
+      append_corpus_sources(&corpus, out);
+      files++;
+    }
+    free(corpus.data);
+  }
+  closedir(dir);
+  return files;
+}
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t count_nodes(TSNode root) {
+  uint64_t count = 0;
+  TSTreeCursor cursor = ts_tree_cursor_new(root);
+  for (;;) {
+    count++;
+    if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        ts_tree_cursor_delete(&cursor);
+        return count;
+      }
+    }
+  }
+}
+
+static TSPoint point_at(const char *source, size_t offset) {
+  TSPoint point = {0, 0};
+  for (size_t i = 0; i < offset; i++) {
+    if (source[i] == '\n') {
+      point.row++;
+      point.column = 0;
+    } else {
+      point.column++;
+    }
+  }
+  return point;
+}
+
+static BenchResult bench_full(TSParser *parser, const char *name, const Buffer *input, unsigned iterations) {
+  BenchResult result = {name, "full", input->length, iterations, 0, 0};
+
+  for (unsigned i = 0; i < iterations; i++) {
+    double start = now_seconds();
+    TSTree *tree = ts_parser_parse_string(parser, NULL, input->data, (uint32_t)input->length);
+    result.seconds += now_seconds() - start;
+
+    result.nodes += count_nodes(ts_tree_root_node(tree));
+    ts_tree_delete(tree);
+  }
+  return result;
+}
+
+// Insert a line comment in the middle of the input, at a line start so the
+// edit never splits a token, and reparse it against the edited old tree.
+static BenchResult bench_edit(TSParser *parser, const char *name, const Buffer *input, unsigned iterations) {
+  BenchResult result = {name, "edit", input->length, iterations, 0, 0};
+
+  static const char inserted[] = "// edit\n";
+  size_t inserted_length = sizeof(inserted) - 1;
+
+  const char *middle = memchr(input->data + input->length / 2, '\n', input->length - input->length / 2);
+  size_t offset = middle != NULL ? (size_t)(middle - input->data) + 1 : input->length;
+
+  Buffer edited = {0};
+  buffer_append(&edited, input->data, offset);
+  buffer_append(&edited, inserted, inserted_length);
+  buffer_append(&edited, input->data + offset, input->length - offset);
+
+  TSPoint start_point = point_at(input->data, offset);
+  TSInputEdit edit = {
+    .start_byte = (uint32_t)offset,
+    .old_end_byte = (uint32_t)offset,
+    .new_end_byte = (uint32_t)(offset + inserted_length),
+    .start_point = start_point,
+    .old_end_point = start_point,
+    .new_end_point = {start_point.row + 1, 0},
+  };
+
+  TSTree *original = ts_parser_parse_string(parser, NULL, input->data, (uint32_t)input->length);
+  for (unsigned i = 0; i < iterations; i++) {
+    TSTree *old_tree = ts_tree_copy(original);
+
+    double start = now_seconds();
+    ts_tree_edit(old_tree, &edit);
+    TSTree *tree = ts_parser_parse_string(parser, old_tree, edited.data, (uint32_t)edited.length);
+    result.seconds += now_seconds() - start;
+
+    result.nodes += count_nodes(ts_tree_root_node(tree));
+    ts_tree_delete(tree);
+    ts_tree_delete(old_tree);
+  }
+  ts_tree_delete(original);
+  free(edited.data);
+  return result;
+}
+
+#ifdef TACT_BENCH_BATCH
+// Parse BATCH_FILES copies of the input as one batch, like indexing a workspace.
+static BenchResult bench_batch(const char *name, const char *mode, uint32_t thread_count,
+                               const Buffer *input, unsigned iterations) {
+  BenchResult result = {name, mode, input->length * BATCH_FILES, iterations, 0, 0};
+
+  TSTactBatchParser *batch = ts_tact_batch_parser_new(thread_count);
+  if (batch == NULL) {
+    fprintf(stderr, "cannot start the batch parser threads\n");
+    exit(1);
+  }
+
+  TSTactBatchInput inputs[BATCH_FILES];
+  TSTree *trees[BATCH_FILES];
+  for (size_t i = 0; i < BATCH_FILES; i++) {
+    inputs[i] = (TSTactBatchInput){input->data, (uint32_t)input->length, TSInputEncodingUTF8, 0};
+  }
+
+  for (unsigned i = 0; i < iterations; i++) {
+    double start = now_seconds();
+    ts_tact_batch_parse(batch, inputs, BATCH_FILES, trees);
+    result.seconds += now_seconds() - start;
+
+    for (size_t j = 0; j < BATCH_FILES; j++) {
+      result.nodes += count_nodes(ts_tree_root_node(trees[j]));
+      ts_tree_delete(trees[j]);
+    }
+  }
+  ts_tact_batch_parser_delete(batch);
+  return result;
+}
+#endif
+
+static void print_result(const BenchResult *result, bool last) {
+  double total_bytes = (double)result->bytes * result->iterations;
+  double seconds = result->seconds > 0 ? result->seconds : 1e-9;
+  printf("    {\"name\": \"%s\", \"mode\": \"%s\", \"bytes\": %zu, \"iterations\": %u, "
+         "\"seconds\": %.6f, \"mb_per_s\": %.3f, \"nodes_per_s\": %.0f}%s\n",
+         result->name, result->mode, result->bytes, result->iterations, result->seconds,
+         total_bytes / (1024.0 * 1024.0) / seconds, (double)result->nodes / seconds,
+         last ? "" : ",");
+}
+
+static void usage(const char *program) {
+  fprintf(stderr, "usage: %s [--iterations N] [--sizes KiB,KiB,...] [grammar-dir]\n", program);
+}
+
+int main(int argc, char **argv) {
+  unsigned iterations = DEFAULT_ITERATIONS;
+  const char *sizes = DEFAULT_SIZES;
+  const char *grammar_dir = TACT_GRAMMAR_DIR;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = (unsigned)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+      sizes = argv[++i];
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return 1;
+    } else {
+      grammar_dir = argv[i];
+    }
+  }
+  if (iterations == 0) iterations = 1;
+
+  Buffer corpus = {0};
+  if (load_corpus(grammar_dir, &corpus) == 0) {
+    fprintf(stderr, "cannot read corpus from %s/test/corpus\n", grammar_dir);
+    return 1;
+  }
+
+  char path[4096];
+  snprintf(path, sizeof(path), "%s/test/sample/example.tact", grammar_dir);
+  Buffer sample = {0};
+  if (!read_file(path, &sample)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_tact());
+
+  BenchResult results[64];
+  size_t count = 0;
+
+  results[count++] = bench_full(parser, "corpus", &corpus, iterations);
+  results[count++] = bench_edit(parser, "corpus", &corpus, iterations);
+  results[count++] = bench_full(parser, "example.tact", &sample, iterations);
+  results[count++] = bench_edit(parser, "example.tact", &sample, iterations);
+
+  // Synthetic inputs: the corpus and the sample repeated up to the given size.
+  static char names[16][32];
+  size_t synthetic = 0;
+  const char *size = sizes;
+  while (*size != '\0' && synthetic < 16 && count + 4 <= 64) {
+    size_t kib = strtoul(size, NULL, 10);
+    const char *comma = strchr(size, ',');
+    size = comma != NULL ? comma + 1 : size + strlen(size);
+    if (kib == 0) continue;
+
+    Buffer input = {0};
+    while (input.length < kib * 1024) {
+      buffer_append(&input, corpus.data, corpus.length);
+      buffer_append(&input, sample.data, sample.length);
+    }
+
+    snprintf(names[synthetic], sizeof(names[synthetic]), "synthetic-%zuKiB", kib);
+    unsigned scaled = iterations * 64 / (unsigned)(kib > 64 ? kib : 64);
+    if (scaled == 0) scaled = 1;
+    results[count++] = bench_full(parser, names[synthetic], &input, scaled);
+    results[count++] = bench_edit(parser, names[synthetic], &input, scaled);
+    synthetic++;
+    free(input.data);
+  }
+
+  ts_parser_delete(parser);
+
+#ifdef TACT_BENCH_BATCH
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t thread_count = cores > 1 ? (uint32_t)cores : 1;
+  static char batch_mode[32];
+  snprintf(batch_mode, sizeof(batch_mode), "batch-%u-threads", thread_count);
+  results[count++] = bench_batch("workspace", "batch-1-thread", 1, &sample, iterations);
+  results[count++] = bench_batch("workspace", batch_mode, thread_count, &sample, iterations);
+#endif
+
+  struct rusage usage_info;
+  getrusage(RUSAGE_SELF, &usage_info);
+#ifdef __APPLE__
+  long peak_rss_kb = usage_info.ru_maxrss / 1024;
+#else
+  long peak_rss_kb = usage_info.ru_maxrss;
+#endif
+
+  printf("{\n  \"results\": [\n");
+  for (size_t i = 0; i < count; i++) {
+    print_result(&results[i], i + 1 == count);
+  }
+  printf("  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss_kb);
+
+  free(corpus.data);
+  free(sample.data);
+  return 0;
+}
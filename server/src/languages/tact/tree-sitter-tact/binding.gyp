@@ -1,4 +1,9 @@
 {
+  "variables": {
+    # Directory of the tree-sitter runtime (`lib/` of the tree-sitter repository),
+    # see scripts/tree-sitter-lib-dir.js.
+    "tree_sitter_lib%": "<!(node scripts/tree-sitter-lib-dir.js)",
+  },
   "targets": [
     {
       "target_name": "tree_sitter_tact_binding",
@@ -7,15 +12,32 @@
       ],
       "include_dirs": [
         "src",
+        "bindings/c",
+        "<(tree_sitter_lib)/include",
+        "<(tree_sitter_lib)/src",
       ],
       "sources": [
         "bindings/node/binding.cc",
+        "bindings/c/tree-sitter-tact-batch.c",
+        "bindings/c/tree-sitter-tact-serialize.c",
         "src/parser.c",
+        "<(tree_sitter_lib)/src/lib.c",
         # NOTE: if your language has an external scanner, add it here.
       ],
       "cflags_c": [
         "-std=c11",
       ],
+      "cflags_cc": [
+        "-std=c++17",
+      ],
+      "xcode_settings": {
+        "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+      },
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "AdditionalOptions": ["/std:c++17"],
+        },
+      },
     }
   ]
 }
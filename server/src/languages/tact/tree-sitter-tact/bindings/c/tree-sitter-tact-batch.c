@@ -0,0 +1,287 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree-sitter-tact-batch.h"
+#include "tree-sitter-tact.h"
+
+#include <stdlib.h>
+
+#define MAX_THREAD_COUNT 64
+
+// Threads, locks and the clock, on Win32 or pthreads. MSVC's <stdatomic.h> is
+// still experimental, so the shared input counter uses Interlocked* there.
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef HANDLE thread_t;
+typedef SRWLOCK mutex_t;
+typedef CONDITION_VARIABLE cond_t;
+typedef volatile LONG counter_t;
+
+#define THREAD_MAIN(name, arg) static DWORD WINAPI name(LPVOID arg)
+#define THREAD_RETURN 0
+
+static bool thread_create(thread_t *thread, LPTHREAD_START_ROUTINE entry, void *arg) {
+  *thread = CreateThread(NULL, 0, entry, arg, 0, NULL);
+  return *thread != NULL;
+}
+
+static void thread_join(thread_t thread) {
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+static void mutex_init(mutex_t *mutex) { InitializeSRWLock(mutex); }
+static void mutex_destroy(mutex_t *mutex) { (void)mutex; }
+static void mutex_lock(mutex_t *mutex) { AcquireSRWLockExclusive(mutex); }
+static void mutex_unlock(mutex_t *mutex) { ReleaseSRWLockExclusive(mutex); }
+
+static void cond_init(cond_t *cond) { InitializeConditionVariable(cond); }
+static void cond_destroy(cond_t *cond) { (void)cond; }
+static void cond_wait(cond_t *cond, mutex_t *mutex) { SleepConditionVariableSRW(cond, mutex, INFINITE, 0); }
+static void cond_signal(cond_t *cond) { WakeConditionVariable(cond); }
+static void cond_broadcast(cond_t *cond) { WakeAllConditionVariable(cond); }
+
+static void counter_reset(counter_t *counter) { InterlockedExchange(counter, 0); }
+static uint32_t counter_next(counter_t *counter) { return (uint32_t)InterlockedIncrement(counter) - 1; }
+
+static uint64_t now_micros(void) {
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+         (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+}
+
+static long online_cores(void) { return (long)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS); }
+
+#else
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef pthread_t thread_t;
+typedef pthread_mutex_t mutex_t;
+typedef pthread_cond_t cond_t;
+typedef atomic_uint counter_t;
+
+#define THREAD_MAIN(name, arg) static void *name(void *arg)
+#define THREAD_RETURN NULL
+
+static bool thread_create(thread_t *thread, void *(*entry)(void *), void *arg) {
+  return pthread_create(thread, NULL, entry, arg) == 0;
+}
+
+static void thread_join(thread_t thread) { pthread_join(thread, NULL); }
+
+static void mutex_init(mutex_t *mutex) { pthread_mutex_init(mutex, NULL); }
+static void mutex_destroy(mutex_t *mutex) { pthread_mutex_destroy(mutex); }
+static void mutex_lock(mutex_t *mutex) { pthread_mutex_lock(mutex); }
+static void mutex_unlock(mutex_t *mutex) { pthread_mutex_unlock(mutex); }
+
+static void cond_init(cond_t *cond) { pthread_cond_init(cond, NULL); }
+static void cond_destroy(cond_t *cond) { pthread_cond_destroy(cond); }
+static void cond_wait(cond_t *cond, mutex_t *mutex) { pthread_cond_wait(cond, mutex); }
+static void cond_signal(cond_t *cond) { pthread_cond_signal(cond); }
+static void cond_broadcast(cond_t *cond) { pthread_cond_broadcast(cond); }
+
+static void counter_reset(counter_t *counter) { atomic_store(counter, 0); }
+static uint32_t counter_next(counter_t *counter) { return atomic_fetch_add(counter, 1); }
+
+static uint64_t now_micros(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static long online_cores(void) { return sysconf(_SC_NPROCESSORS_ONLN); }
+
+#endif
+
+struct TSTactBatchParser {
+  thread_t *threads;
+  uint32_t thread_count;
+
+  // Held for the whole duration of a batch, so concurrent callers queue up.
+  mutex_t batch_mutex;
+
+  mutex_t mutex;
+  cond_t work_ready;
+  cond_t work_done;
+
+  // State of the current batch, published under `mutex` by bumping `generation`.
+  const TSTactBatchInput *inputs;
+  TSTree **trees;
+  uint32_t count;
+  counter_t next;
+  uint32_t finished_workers;
+  uint64_t generation;
+  bool shutting_down;
+};
+
+static bool deadline_passed(TSParseState *state) {
+  const uint64_t *deadline = state->payload;
+  return now_micros() >= *deadline;
+}
+
+static const char *read_input(void *payload, uint32_t byte, TSPoint position, uint32_t *bytes_read) {
+  const TSTactBatchInput *input = payload;
+  (void)position;
+  if (byte >= input->length) {
+    *bytes_read = 0;
+    return "";
+  }
+  *bytes_read = input->length - byte;
+  return input->source + byte;
+}
+
+static TSTree *parse_input(TSParser *parser, const TSTactBatchInput *input) {
+  if (input->timeout_micros == 0) {
+    return ts_parser_parse_string_encoding(parser, NULL, input->source, input->length, input->encoding);
+  }
+
+  TSInput ts_input = {0};
+  ts_input.payload = (void *)input;
+  ts_input.read = read_input;
+  ts_input.encoding = input->encoding;
+
+  uint64_t deadline = now_micros() + input->timeout_micros;
+  TSParseOptions options = {&deadline, deadline_passed};
+  TSTree *tree = ts_parser_parse_with_options(parser, NULL, ts_input, options);
+  if (tree == NULL) ts_parser_reset(parser);
+  return tree;
+}
+
+THREAD_MAIN(worker_main, payload) {
+  TSTactBatchParser *self = payload;
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_tact());
+
+  uint64_t seen_generation = 0;
+  mutex_lock(&self->mutex);
+  for (;;) {
+    while (!self->shutting_down && self->generation == seen_generation) {
+      cond_wait(&self->work_ready, &self->mutex);
+    }
+    if (self->shutting_down) break;
+
+    seen_generation = self->generation;
+    const TSTactBatchInput *inputs = self->inputs;
+    TSTree **trees = self->trees;
+    uint32_t count = self->count;
+    mutex_unlock(&self->mutex);
+
+    for (;;) {
+      uint32_t index = counter_next(&self->next);
+      if (index >= count) break;
+
+      trees[index] = parse_input(parser, &inputs[index]);
+    }
+
+    mutex_lock(&self->mutex);
+    self->finished_workers++;
+    if (self->finished_workers == self->thread_count) {
+      cond_signal(&self->work_done);
+    }
+  }
+  mutex_unlock(&self->mutex);
+
+  ts_parser_delete(parser);
+  return THREAD_RETURN;
+}
+
+static uint32_t default_thread_count(void) {
+  long cores = online_cores();
+  if (cores < 1) return 1;
+  return cores > MAX_THREAD_COUNT ? MAX_THREAD_COUNT : (uint32_t)cores;
+}
+
+TSTactBatchParser *ts_tact_batch_parser_new(uint32_t thread_count) {
+  if (thread_count == 0) thread_count = default_thread_count();
+  if (thread_count > MAX_THREAD_COUNT) thread_count = MAX_THREAD_COUNT;
+
+  TSTactBatchParser *self = calloc(1, sizeof(TSTactBatchParser));
+  if (self == NULL) return NULL;
+
+  self->threads = calloc(thread_count, sizeof(thread_t));
+  if (self->threads == NULL) {
+    free(self);
+    return NULL;
+  }
+
+  mutex_init(&self->batch_mutex);
+  mutex_init(&self->mutex);
+  cond_init(&self->work_ready);
+  cond_init(&self->work_done);
+  counter_reset(&self->next);
+
+  for (uint32_t i = 0; i < thread_count; i++) {
+    if (!thread_create(&self->threads[i], worker_main, self)) break;
+    self->thread_count++;
+  }
+
+  if (self->thread_count == 0) {
+    ts_tact_batch_parser_delete(self);
+    return NULL;
+  }
+  return self;
+}
+
+uint32_t ts_tact_batch_parser_thread_count(const TSTactBatchParser *self) {
+  return self->thread_count;
+}
+
+void ts_tact_batch_parse(
+  TSTactBatchParser *self,
+  const TSTactBatchInput *inputs,
+  uint32_t count,
+  TSTree **trees
+) {
+  if (count == 0) return;
+
+  mutex_lock(&self->batch_mutex);
+  mutex_lock(&self->mutex);
+
+  self->inputs = inputs;
+  self->trees = trees;
+  self->count = count;
+  counter_reset(&self->next);
+  self->finished_workers = 0;
+  self->generation++;
+  cond_broadcast(&self->work_ready);
+
+  while (self->finished_workers < self->thread_count) {
+    cond_wait(&self->work_done, &self->mutex);
+  }
+
+  self->inputs = NULL;
+  self->trees = NULL;
+  self->count = 0;
+
+  mutex_unlock(&self->mutex);
+  mutex_unlock(&self->batch_mutex);
+}
+
+void ts_tact_batch_parser_delete(TSTactBatchParser *self) {
+  if (self == NULL) return;
+
+  mutex_lock(&self->mutex);
+  self->shutting_down = true;
+  cond_broadcast(&self->work_ready);
+  mutex_unlock(&self->mutex);
+
+  for (uint32_t i = 0; i < self->thread_count; i++) {
+    thread_join(self->threads[i]);
+  }
+
+  cond_destroy(&self->work_done);
+  cond_destroy(&self->work_ready);
+  mutex_destroy(&self->mutex);
+  mutex_destroy(&self->batch_mutex);
+  free(self->threads);
+  free(self);
+}
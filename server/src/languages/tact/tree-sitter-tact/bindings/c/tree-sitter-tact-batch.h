@@ -0,0 +1,53 @@
+#ifndef TREE_SITTER_TACT_BATCH_H_
+#define TREE_SITTER_TACT_BATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parallel parsing of many Tact sources at once, for indexing whole workspaces.
+//
+// A batch parser owns a fixed pool of worker threads, each with its own
+// `TSParser`. Workers take inputs from a shared queue, so a few large files
+// don't hold back the rest of the batch. Workers are pthreads, or Win32
+// threads on Windows.
+
+typedef struct TSTactBatchParser TSTactBatchParser;
+
+typedef struct {
+  const char *source;
+  // Length of `source` in bytes.
+  uint32_t length;
+  TSInputEncoding encoding;
+  // Give up on the input once parsing it takes longer than this, and leave its
+  // tree NULL. 0 means no limit.
+  uint64_t timeout_micros;
+} TSTactBatchInput;
+
+// Create a pool of `thread_count` workers, or one per CPU core if it is 0.
+TSTactBatchParser *ts_tact_batch_parser_new(uint32_t thread_count);
+
+uint32_t ts_tact_batch_parser_thread_count(const TSTactBatchParser *self);
+
+// Parse `inputs[i]` into `trees[i]` on the pool and block until all of them
+// are done. A tree is NULL if its input could not be parsed. The caller owns
+// the returned trees. Batches on the same parser are serialized.
+void ts_tact_batch_parse(
+  TSTactBatchParser *self,
+  const TSTactBatchInput *inputs,
+  uint32_t count,
+  TSTree **trees
+);
+
+void ts_tact_batch_parser_delete(TSTactBatchParser *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_TACT_BATCH_H_
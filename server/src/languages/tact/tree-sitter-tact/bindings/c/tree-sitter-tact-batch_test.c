@@ -0,0 +1,125 @@
+// Tests of the batch parser: trees parsed on the pool must be the trees a
+// single parser produces for the same inputs. Run by ctest.
+
+#include "tree-sitter-tact-batch.h"
+#include "tree-sitter-tact.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INPUT_COUNT 200
+
+static int failures = 0;
+
+#define CHECK(condition)                                                        \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                               \
+    }                                                                           \
+  } while (0)
+
+static char *make_source(uint32_t index) {
+  // Inputs of very different sizes, so workers finish them out of order.
+  uint32_t functions = (index * 37) % 300 + 1;
+  size_t capacity = 64 + (size_t)functions * 64;
+  char *source = malloc(capacity);
+  size_t length = (size_t)snprintf(source, capacity, "contract C%u {\n", index);
+  for (uint32_t i = 0; i < functions; i++) {
+    length += (size_t)snprintf(source + length, capacity - length,
+                               "    fun f%u(a: Int): Int { return a + %u; }\n", i, index);
+  }
+  snprintf(source + length, capacity - length, "}\n");
+  return source;
+}
+
+static void test_matches_sequential_parse(TSTactBatchParser *batch) {
+  TSTactBatchInput inputs[INPUT_COUNT];
+  TSTree *trees[INPUT_COUNT];
+  char *sources[INPUT_COUNT];
+  for (uint32_t i = 0; i < INPUT_COUNT; i++) {
+    sources[i] = make_source(i);
+    inputs[i] = (TSTactBatchInput){sources[i], (uint32_t)strlen(sources[i]), TSInputEncodingUTF8, 0};
+    trees[i] = NULL;
+  }
+
+  ts_tact_batch_parse(batch, inputs, INPUT_COUNT, trees);
+
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_tact());
+  for (uint32_t i = 0; i < INPUT_COUNT; i++) {
+    CHECK(trees[i] != NULL);
+    if (trees[i] == NULL) continue;
+
+    TSTree *expected = ts_parser_parse_string(parser, NULL, inputs[i].source, inputs[i].length);
+    char *expected_sexp = ts_node_string(ts_tree_root_node(expected));
+    char *actual_sexp = ts_node_string(ts_tree_root_node(trees[i]));
+    CHECK(strcmp(expected_sexp, actual_sexp) == 0);
+    CHECK(ts_node_end_byte(ts_tree_root_node(trees[i])) == inputs[i].length);
+
+    free(expected_sexp);
+    free(actual_sexp);
+    ts_tree_delete(expected);
+    ts_tree_delete(trees[i]);
+  }
+  ts_parser_delete(parser);
+
+  for (uint32_t i = 0; i < INPUT_COUNT; i++) free(sources[i]);
+}
+
+static void test_timeout(TSTactBatchParser *batch) {
+  // Large enough that parsing it takes far longer than a microsecond.
+  static const char line[] = "fun foo() { let a: Int = 1 + 2; }\n";
+  size_t line_length = sizeof(line) - 1;
+  size_t repeat = 20000;
+  char *large = malloc(line_length * repeat + 1);
+  for (size_t i = 0; i < repeat; i++) memcpy(large + i * line_length, line, line_length);
+  large[line_length * repeat] = '\0';
+
+  static const char small[] = "contract Foo { a: Int; }";
+  TSTactBatchInput inputs[2] = {
+    {large, (uint32_t)(line_length * repeat), TSInputEncodingUTF8, 1},
+    {small, (uint32_t)(sizeof(small) - 1), TSInputEncodingUTF8, 0},
+  };
+  TSTree *trees[2] = {NULL, NULL};
+
+  ts_tact_batch_parse(batch, inputs, 2, trees);
+  CHECK(trees[0] == NULL);
+  CHECK(trees[1] != NULL);
+
+  ts_tree_delete(trees[1]);
+  free(large);
+}
+
+static void test_empty_batch(TSTactBatchParser *batch) {
+  ts_tact_batch_parse(batch, NULL, 0, NULL);
+}
+
+int main(void) {
+  TSTactBatchParser *batch = ts_tact_batch_parser_new(4);
+  CHECK(batch != NULL);
+  if (batch == NULL) return 1;
+  CHECK(ts_tact_batch_parser_thread_count(batch) == 4);
+
+  test_matches_sequential_parse(batch);
+  test_timeout(batch);
+  test_empty_batch(batch);
+  // The pool is reused across batches.
+  test_matches_sequential_parse(batch);
+  ts_tact_batch_parser_delete(batch);
+
+  TSTactBatchParser *per_core = ts_tact_batch_parser_new(0);
+  CHECK(per_core != NULL);
+  if (per_core != NULL) {
+    CHECK(ts_tact_batch_parser_thread_count(per_core) >= 1);
+    test_matches_sequential_parse(per_core);
+    ts_tact_batch_parser_delete(per_core);
+  }
+
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,341 @@
+#include "tree-sitter-tact-serialize.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t MAGIC[4] = {'T', 'S', 'T', 'B'};
+
+#define NO_ID 0xFFFF
+
+typedef struct {
+  TSTactSerializedNode *nodes;
+  uint32_t node_count;
+  uint32_t node_capacity;
+
+  uint32_t *stack;
+  uint32_t depth;
+  uint32_t stack_capacity;
+
+  // Per-tree ids of the language's symbols and fields, NO_ID if not seen yet.
+  uint32_t language_symbol_count;
+  uint16_t *symbol_ids;
+  TSSymbol *symbols;
+  uint16_t symbol_count;
+  uint16_t *field_ids;
+  TSFieldId *fields;
+  uint16_t field_count;
+} Writer;
+
+static bool grow(void **items, uint32_t *capacity, uint32_t count, size_t item_size) {
+  if (count < *capacity) return true;
+  uint32_t new_capacity = *capacity != 0 ? *capacity * 2 : 256;
+  void *new_items = realloc(*items, new_capacity * item_size);
+  if (new_items == NULL) return false;
+  *items = new_items;
+  *capacity = new_capacity;
+  return true;
+}
+
+static void put_u16(uint8_t *out, uint16_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+  put_u16(out, (uint16_t)value);
+  put_u16(out + 2, (uint16_t)(value >> 16));
+}
+
+static void put_u64(uint8_t *out, uint64_t value) {
+  put_u32(out, (uint32_t)value);
+  put_u32(out + 4, (uint32_t)(value >> 32));
+}
+
+static uint16_t get_u16(const uint8_t *in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+  return (uint32_t)get_u16(in) | ((uint32_t)get_u16(in + 2) << 16);
+}
+
+static uint64_t get_u64(const uint8_t *in) {
+  return (uint64_t)get_u32(in) | ((uint64_t)get_u32(in + 4) << 32);
+}
+
+static uint32_t align4(uint32_t offset) {
+  return (offset + 3) & ~(uint32_t)3;
+}
+
+static bool writer_push(Writer *writer, const TSTreeCursor *cursor, uint32_t unit_shift) {
+  TSNode node = ts_tree_cursor_current_node(cursor);
+
+  // The ERROR symbol is outside of the language's symbol range, it gets the
+  // slot after the last symbol.
+  TSSymbol symbol = ts_node_symbol(node);
+  uint32_t slot = symbol < writer->language_symbol_count ? symbol : writer->language_symbol_count;
+  if (writer->symbol_ids[slot] == NO_ID) {
+    writer->symbol_ids[slot] = writer->symbol_count;
+    writer->symbols[writer->symbol_count++] = symbol;
+  }
+
+  TSFieldId field = ts_tree_cursor_current_field_id(cursor);
+  if (field != 0 && writer->field_ids[field] == NO_ID) {
+    // Field 0 means "no field", so fields are numbered from 1.
+    if (writer->field_count == UINT8_MAX) return false;
+    writer->field_ids[field] = ++writer->field_count;
+    writer->fields[writer->field_count - 1] = field;
+  }
+
+  if (!grow((void **)&writer->nodes, &writer->node_capacity, writer->node_count,
+            sizeof(TSTactSerializedNode)) ||
+      !grow((void **)&writer->stack, &writer->stack_capacity, writer->depth, sizeof(uint32_t))) {
+    return false;
+  }
+
+  uint8_t flags = 0;
+  if (ts_node_is_named(node)) flags |= TS_TACT_NODE_NAMED;
+  if (ts_node_is_missing(node)) flags |= TS_TACT_NODE_MISSING;
+  if (ts_node_is_extra(node)) flags |= TS_TACT_NODE_EXTRA;
+  if (ts_node_is_error(node)) flags |= TS_TACT_NODE_ERROR;
+  if (ts_node_has_error(node)) flags |= TS_TACT_NODE_HAS_ERROR;
+
+  writer->stack[writer->depth++] = writer->node_count;
+  writer->nodes[writer->node_count++] = (TSTactSerializedNode){
+    .symbol = writer->symbol_ids[slot],
+    .field = field != 0 ? (uint8_t)writer->field_ids[field] : 0,
+    .flags = flags,
+    .start = ts_node_start_byte(node) >> unit_shift,
+    .end = ts_node_end_byte(node) >> unit_shift,
+    .descendant_count = 0,
+  };
+  return true;
+}
+
+static void writer_pop(Writer *writer) {
+  uint32_t index = writer->stack[--writer->depth];
+  writer->nodes[index].descendant_count = writer->node_count - index - 1;
+}
+
+static bool writer_walk(Writer *writer, const TSTree *tree, uint32_t unit_shift) {
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  bool ok = true;
+
+  for (;;) {
+    if (!writer_push(writer, &cursor, unit_shift)) {
+      ok = false;
+      break;
+    }
+    if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+
+    bool done = false;
+    for (;;) {
+      writer_pop(writer);
+      if (ts_tree_cursor_goto_next_sibling(&cursor)) break;
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        done = true;
+        break;
+      }
+    }
+    if (done) break;
+  }
+
+  ts_tree_cursor_delete(&cursor);
+  return ok;
+}
+
+static uint32_t write_name(uint8_t *out, const char *name) {
+  uint16_t length = (uint16_t)strlen(name);
+  put_u16(out, length);
+  memcpy(out + 2, name, length);
+  return 2 + (uint32_t)length;
+}
+
+static uint8_t *writer_finish(const Writer *writer, const TSLanguage *language, uint16_t flags,
+                              uint64_t source_hash, uint32_t *length) {
+  uint64_t names_size = 0;
+  for (uint16_t i = 0; i < writer->symbol_count; i++) {
+    names_size += 2 + strlen(ts_language_symbol_name(language, writer->symbols[i]));
+  }
+  for (uint16_t i = 0; i < writer->field_count; i++) {
+    names_size += 2 + strlen(ts_language_field_name_for_id(language, writer->fields[i]));
+  }
+
+  uint64_t nodes_offset = (TS_TACT_SERIALIZED_HEADER_SIZE + names_size + 3) & ~(uint64_t)3;
+  uint64_t total = nodes_offset + (uint64_t)writer->node_count * TS_TACT_SERIALIZED_NODE_SIZE;
+  if (total > UINT32_MAX) return NULL;
+
+  uint8_t *out = calloc(1, (size_t)total);
+  if (out == NULL) return NULL;
+
+  memcpy(out, MAGIC, sizeof(MAGIC));
+  put_u16(out + 4, TS_TACT_SERIALIZED_VERSION);
+  put_u16(out + 6, flags);
+  put_u64(out + 8, source_hash);
+  put_u32(out + 16, writer->node_count);
+  put_u16(out + 20, writer->symbol_count);
+  put_u16(out + 22, writer->field_count);
+
+  uint32_t offset = TS_TACT_SERIALIZED_HEADER_SIZE;
+  for (uint16_t i = 0; i < writer->symbol_count; i++) {
+    offset += write_name(out + offset, ts_language_symbol_name(language, writer->symbols[i]));
+  }
+  for (uint16_t i = 0; i < writer->field_count; i++) {
+    offset += write_name(out + offset, ts_language_field_name_for_id(language, writer->fields[i]));
+  }
+
+  uint8_t *node_out = out + nodes_offset;
+  for (uint32_t i = 0; i < writer->node_count; i++, node_out += TS_TACT_SERIALIZED_NODE_SIZE) {
+    const TSTactSerializedNode *node = &writer->nodes[i];
+    put_u16(node_out, node->symbol);
+    node_out[2] = node->field;
+    node_out[3] = node->flags;
+    put_u32(node_out + 4, node->start);
+    put_u32(node_out + 8, node->end);
+    put_u32(node_out + 12, node->descendant_count);
+  }
+
+  *length = (uint32_t)total;
+  return out;
+}
+
+uint8_t *ts_tact_tree_serialize(
+  const TSTree *tree,
+  TSInputEncoding encoding,
+  uint64_t source_hash,
+  uint32_t *length
+) {
+  const TSLanguage *language = ts_tree_language(tree);
+  uint32_t symbol_count = ts_language_symbol_count(language);
+  uint32_t field_count = ts_language_field_count(language);
+  bool utf16 = encoding == TSInputEncodingUTF16LE || encoding == TSInputEncodingUTF16BE;
+
+  Writer writer = {0};
+  writer.language_symbol_count = symbol_count;
+  writer.symbol_ids = malloc((symbol_count + 1) * sizeof(uint16_t));
+  writer.symbols = malloc((symbol_count + 1) * sizeof(TSSymbol));
+  writer.field_ids = malloc((field_count + 1) * sizeof(uint16_t));
+  writer.fields = malloc((field_count + 1) * sizeof(TSFieldId));
+
+  uint8_t *result = NULL;
+  if (writer.symbol_ids != NULL && writer.symbols != NULL && writer.field_ids != NULL &&
+      writer.fields != NULL) {
+    memset(writer.symbol_ids, 0xFF, (symbol_count + 1) * sizeof(uint16_t));
+    memset(writer.field_ids, 0xFF, (field_count + 1) * sizeof(uint16_t));
+
+    if (writer_walk(&writer, tree, utf16 ? 1 : 0)) {
+      result = writer_finish(&writer, language, utf16 ? TS_TACT_SERIALIZED_UTF16 : 0,
+                             source_hash, length);
+    }
+  }
+
+  free(writer.nodes);
+  free(writer.stack);
+  free(writer.symbol_ids);
+  free(writer.symbols);
+  free(writer.field_ids);
+  free(writer.fields);
+  return result;
+}
+
+// Check that every node's descendants fit into its parent's.
+static bool validate_nodes(const TSTactSerializedTree *self) {
+  if (self->node_count == 0) return true;
+
+  uint32_t *ends = malloc(self->node_count * sizeof(uint32_t));
+  if (ends == NULL) return false;
+
+  bool ok = true;
+  uint32_t depth = 0;
+  for (uint32_t i = 0; i < self->node_count && ok; i++) {
+    TSTactSerializedNode node = ts_tact_serialized_tree_node(self, i);
+    uint64_t last = (uint64_t)i + node.descendant_count;
+
+    while (depth > 0 && ends[depth - 1] < i) depth--;
+    if (i > 0 && depth == 0) ok = false;
+    if (depth > 0 && last > ends[depth - 1]) ok = false;
+    if (last >= self->node_count) ok = false;
+    if (node.symbol >= self->symbol_count || node.field > self->field_count) ok = false;
+    if (node.start > node.end) ok = false;
+
+    ends[depth++] = (uint32_t)last;
+  }
+
+  free(ends);
+  return ok;
+}
+
+bool ts_tact_serialized_tree_open(TSTactSerializedTree *self, const uint8_t *data, uint32_t length) {
+  memset(self, 0, sizeof(*self));
+  if (length < TS_TACT_SERIALIZED_HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+    return false;
+  }
+  if (get_u16(data + 4) != TS_TACT_SERIALIZED_VERSION) return false;
+
+  self->data = data;
+  self->length = length;
+  self->flags = get_u16(data + 6);
+  self->source_hash = get_u64(data + 8);
+  self->node_count = get_u32(data + 16);
+  self->symbol_count = get_u16(data + 20);
+  self->field_count = get_u16(data + 22);
+  if (self->field_count > UINT8_MAX) return false;
+
+  uint32_t offset = TS_TACT_SERIALIZED_HEADER_SIZE;
+  self->names = data + offset;
+  for (uint32_t i = 0; i < (uint32_t)self->symbol_count + self->field_count; i++) {
+    if (length - offset < 2) return false;
+    uint16_t name_length = get_u16(data + offset);
+    if (length - offset - 2 < name_length) return false;
+    offset += 2 + name_length;
+  }
+
+  offset = align4(offset);
+  if (offset > length ||
+      (uint64_t)(length - offset) != (uint64_t)self->node_count * TS_TACT_SERIALIZED_NODE_SIZE) {
+    return false;
+  }
+  self->nodes = data + offset;
+
+  return validate_nodes(self);
+}
+
+TSTactSerializedNode ts_tact_serialized_tree_node(const TSTactSerializedTree *self, uint32_t index) {
+  const uint8_t *in = self->nodes + (size_t)index * TS_TACT_SERIALIZED_NODE_SIZE;
+  return (TSTactSerializedNode){
+    .symbol = get_u16(in),
+    .field = in[2],
+    .flags = in[3],
+    .start = get_u32(in + 4),
+    .end = get_u32(in + 8),
+    .descendant_count = get_u32(in + 12),
+  };
+}
+
+// Names are short and trees have few distinct symbols, so a linear scan is fine.
+static const char *name_at(const TSTactSerializedTree *self, uint32_t index, uint16_t *length) {
+  const uint8_t *name = self->names;
+  for (uint32_t i = 0; i < index; i++) {
+    name += 2 + get_u16(name);
+  }
+  *length = get_u16(name);
+  return (const char *)name + 2;
+}
+
+const char *ts_tact_serialized_tree_symbol_name(
+  const TSTactSerializedTree *self,
+  uint16_t symbol,
+  uint16_t *length
+) {
+  if (symbol >= self->symbol_count) return NULL;
+  return name_at(self, symbol, length);
+}
+
+const char *ts_tact_serialized_tree_field_name(
+  const TSTactSerializedTree *self,
+  uint8_t field,
+  uint16_t *length
+) {
+  if (field == 0 || field > self->field_count) return NULL;
+  return name_at(self, (uint32_t)self->symbol_count + field - 1, length);
+}
@@ -0,0 +1,113 @@
+#ifndef TREE_SITTER_TACT_SERIALIZE_H_
+#define TREE_SITTER_TACT_SERIALIZE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compact binary format for Tact syntax trees, so trees of files that didn't
+// change can be stored on disk and loaded without parsing them again.
+//
+// All integers are little-endian. A serialized tree is:
+//
+//   offset  size  field
+//   0       4     magic "TSTB"
+//   4       2     format version, TS_TACT_SERIALIZED_VERSION
+//   6       2     flags, TS_TACT_SERIALIZED_UTF16 if offsets are UTF-16 code units
+//   8       8     source hash, chosen by the writer's caller
+//   16      4     node count
+//   20      2     symbol count
+//   22      2     field count
+//   24            symbol names, then field names, each as a u16 length and UTF-8 bytes
+//                 zero padding up to a multiple of 4
+//                 nodes, 16 bytes each, see below
+//
+// Symbols and fields are numbered per tree, in the order they first appear, so
+// the format doesn't depend on the ids of a particular build of the grammar.
+// Field 0 means "no field", field names describe fields 1 to field count.
+//
+// Nodes are stored in preorder, including anonymous nodes. Every node is
+// followed by its descendants, so its first child, if it has one, is the next
+// node, and its next sibling comes right after its last descendant:
+//
+//   offset  size  field
+//   0       2     symbol
+//   2       1     field
+//   3       1     TS_TACT_NODE_* flags
+//   4       4     start offset
+//   8       4     end offset
+//   12      4     descendant count
+
+#define TS_TACT_SERIALIZED_VERSION 1
+#define TS_TACT_SERIALIZED_UTF16 1
+
+#define TS_TACT_SERIALIZED_HEADER_SIZE 24
+#define TS_TACT_SERIALIZED_NODE_SIZE 16
+
+#define TS_TACT_NODE_NAMED 1
+#define TS_TACT_NODE_MISSING 2
+#define TS_TACT_NODE_EXTRA 4
+#define TS_TACT_NODE_ERROR 8
+#define TS_TACT_NODE_HAS_ERROR 16
+
+typedef struct {
+  uint16_t symbol;
+  uint8_t field;
+  uint8_t flags;
+  uint32_t start;
+  uint32_t end;
+  uint32_t descendant_count;
+} TSTactSerializedNode;
+
+// A read-only view of a serialized tree, the data is not copied.
+typedef struct {
+  const uint8_t *data;
+  uint32_t length;
+  uint16_t flags;
+  uint64_t source_hash;
+  uint32_t node_count;
+  uint16_t symbol_count;
+  uint16_t field_count;
+  const uint8_t *names;
+  const uint8_t *nodes;
+} TSTactSerializedTree;
+
+// Serialize `tree` into a buffer allocated with `malloc`, and store its length
+// in `length`. `encoding` is the one the tree was parsed with, offsets are
+// stored in its code units. Returns NULL if the tree is too large for the
+// format or allocation fails.
+uint8_t *ts_tact_tree_serialize(
+  const TSTree *tree,
+  TSInputEncoding encoding,
+  uint64_t source_hash,
+  uint32_t *length
+);
+
+// Check that `data` holds a well-formed serialized tree of this format version,
+// and open a view of it. The data must outlive the view.
+bool ts_tact_serialized_tree_open(TSTactSerializedTree *self, const uint8_t *data, uint32_t length);
+
+TSTactSerializedNode ts_tact_serialized_tree_node(const TSTactSerializedTree *self, uint32_t index);
+
+// The name of a symbol or a field as a string that is not NULL-terminated.
+const char *ts_tact_serialized_tree_symbol_name(
+  const TSTactSerializedTree *self,
+  uint16_t symbol,
+  uint16_t *length
+);
+const char *ts_tact_serialized_tree_field_name(
+  const TSTactSerializedTree *self,
+  uint8_t field,
+  uint16_t *length
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_TACT_SERIALIZE_H_
@@ -0,0 +1,122 @@
+// Tests of the binary tree format: a serialized tree, read back with
+// ts_tact_serialized_tree_open, must describe the same nodes as the tree it
+// was written from. Run by ctest.
+
+#include "tree-sitter-tact-serialize.h"
+#include "tree-sitter-tact.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                        \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                               \
+    }                                                                           \
+  } while (0)
+
+static const char *SOURCES[] = {
+  "contract Foo {}",
+  "import \"./a\";\n"
+  "struct Point { x: Int; y: Int as uint8 = 0; }\n"
+  "message(0x1234) Add { amount: Int; }\n"
+  "contract Counter with Deployable {\n"
+  "    counter: Int = 0; // ✓ ünïcödé\n"
+  "    receive(msg: Add) { self.counter += msg.amount; }\n"
+  "    get fun counter(): Int { return self.counter; }\n"
+  "}\n"
+  "asm fun f() { ONE <{ TWO }> }\n",
+  // syntax errors and missing nodes
+  "contract Foo { fun bar( { let x: Int = ; }\n",
+  "",
+};
+
+static bool name_equals(const char *name, uint16_t length, const char *expected) {
+  return expected != NULL && strlen(expected) == length && memcmp(name, expected, length) == 0;
+}
+
+// Walk the tree in preorder alongside the serialized nodes.
+static void check_tree(const char *source) {
+  TSParser *parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_tact());
+  TSTree *tree = ts_parser_parse_string(parser, NULL, source, (uint32_t)strlen(source));
+
+  uint32_t length = 0;
+  uint8_t *data = ts_tact_tree_serialize(tree, TSInputEncodingUTF8, 0x1122334455667788, &length);
+  CHECK(data != NULL);
+  if (data == NULL) goto done;
+
+  TSTactSerializedTree serialized;
+  CHECK(ts_tact_serialized_tree_open(&serialized, data, length));
+  CHECK(serialized.source_hash == 0x1122334455667788);
+  CHECK((serialized.flags & TS_TACT_SERIALIZED_UTF16) == 0);
+  CHECK(serialized.node_count == ts_node_descendant_count(ts_tree_root_node(tree)));
+
+  // Truncated data must be rejected.
+  TSTactSerializedTree truncated;
+  CHECK(!ts_tact_serialized_tree_open(&truncated, data, length - 1));
+
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  uint32_t index = 0;
+  for (;;) {
+    TSNode node = ts_tree_cursor_current_node(&cursor);
+    CHECK(index < serialized.node_count);
+    if (index >= serialized.node_count) break;
+
+    TSTactSerializedNode actual = ts_tact_serialized_tree_node(&serialized, index);
+    uint16_t name_length = 0;
+    const char *name = ts_tact_serialized_tree_symbol_name(&serialized, actual.symbol, &name_length);
+    CHECK(name_equals(name, name_length, ts_node_type(node)));
+
+    const char *field = ts_tree_cursor_current_field_name(&cursor);
+    if (field == NULL) {
+      CHECK(actual.field == 0);
+    } else {
+      name = ts_tact_serialized_tree_field_name(&serialized, actual.field, &name_length);
+      CHECK(name_equals(name, name_length, field));
+    }
+
+    CHECK(actual.start == ts_node_start_byte(node));
+    CHECK(actual.end == ts_node_end_byte(node));
+    CHECK(actual.descendant_count + 1 == ts_node_descendant_count(node));
+    CHECK(((actual.flags & TS_TACT_NODE_NAMED) != 0) == ts_node_is_named(node));
+    CHECK(((actual.flags & TS_TACT_NODE_MISSING) != 0) == ts_node_is_missing(node));
+    CHECK(((actual.flags & TS_TACT_NODE_EXTRA) != 0) == ts_node_is_extra(node));
+    CHECK(((actual.flags & TS_TACT_NODE_ERROR) != 0) == ts_node_is_error(node));
+    CHECK(((actual.flags & TS_TACT_NODE_HAS_ERROR) != 0) == ts_node_has_error(node));
+    index++;
+
+    if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+    bool finished = false;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) {
+        finished = true;
+        break;
+      }
+    }
+    if (finished) break;
+  }
+  CHECK(index == serialized.node_count);
+  ts_tree_cursor_delete(&cursor);
+
+done:
+  free(data);
+  ts_tree_delete(tree);
+  ts_parser_delete(parser);
+}
+
+int main(void) {
+  for (size_t i = 0; i < sizeof(SOURCES) / sizeof(SOURCES[0]); i++) {
+    check_tree(SOURCES[i]);
+  }
+
+  if (failures != 0) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -1,19 +1,1445 @@
 #include <napi.h>
+#include <tree_sitter/api.h>
 
-typedef struct TSLanguage TSLanguage;
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
 
-extern "C" TSLanguage *tree_sitter_tact();
+#include "tree-sitter-tact-batch.h"
+#include "tree-sitter-tact-serialize.h"
+
+extern "C" const TSLanguage *tree_sitter_tact(void);
 
 // "tree-sitter", "language" hashed with BLAKE2
 const napi_type_tag LANGUAGE_TYPE_TAG = {
   0x8AF2E5212AD58ABF, 0xD5006CAD83ABBA16
 };
 
+// The native API mirrors `web-tree-sitter`: input is parsed as UTF-16LE, so every
+// byte offset and column reported by the runtime is halved before it reaches JS,
+// and doubled on the way back. Trees parsed from a `Uint8Array` of UTF-8 are the
+// exception, their offsets and columns are bytes, so `shift` is 0 for them.
+
+namespace {
+
+struct AddonData {
+    Napi::FunctionReference tree;
+    Napi::FunctionReference node;
+    Napi::FunctionReference cursor;
+    // Created on the first `parseBatch` call, one worker per core.
+    TSTactBatchParser *batch = nullptr;
+
+    ~AddonData() {
+        ts_tact_batch_parser_delete(batch);
+    }
+};
+
+AddonData *GetData(Napi::Env env) {
+    return env.GetInstanceData<AddonData>();
+}
+
+// Unwraps argument `index` as an instance of the class behind `constructor`.
+// Anything else, e.g. a plain object shaped like a node, has no native object
+// behind it, so it is rejected with a `TypeError` and nullptr is returned.
+template <typename T>
+T *UnwrapArg(const Napi::CallbackInfo &info, size_t index, const Napi::FunctionReference &constructor,
+             const char *name) {
+    Napi::Value value = info[index];
+    T *result = nullptr;
+    if (value.IsObject() && value.As<Napi::Object>().InstanceOf(constructor.Value())) {
+        result = T::Unwrap(value.As<Napi::Object>());
+    }
+    if (result == nullptr) {
+        Napi::TypeError::New(info.Env(), std::string("Argument must be a ") + name)
+            .ThrowAsJavaScriptException();
+    }
+    return result;
+}
+
+Napi::Object PointToJS(Napi::Env env, TSPoint point, uint32_t shift) {
+    auto result = Napi::Object::New(env);
+    result["row"] = Napi::Number::New(env, point.row);
+    result["column"] = Napi::Number::New(env, point.column >> shift);
+    return result;
+}
+
+TSPoint PointFromJS(const Napi::Value &value, uint32_t shift) {
+    auto obj = value.As<Napi::Object>();
+    uint32_t row = obj.Get("row").As<Napi::Number>().Uint32Value();
+    uint32_t column = obj.Get("column").As<Napi::Number>().Uint32Value();
+    return {row, column << shift};
+}
+
+uint32_t IndexFromJS(const Napi::Value &value, uint32_t shift) {
+    return value.As<Napi::Number>().Uint32Value() << shift;
+}
+
+Napi::Object RangeToJS(Napi::Env env, TSRange range, uint32_t shift) {
+    auto result = Napi::Object::New(env);
+    result["startIndex"] = Napi::Number::New(env, range.start_byte >> shift);
+    result["endIndex"] = Napi::Number::New(env, range.end_byte >> shift);
+    result["startPosition"] = PointToJS(env, range.start_point, shift);
+    result["endPosition"] = PointToJS(env, range.end_point, shift);
+    return result;
+}
+
+// The text a tree was parsed from, shared by the tree and its copies. Only one
+// of `text`, `bytes` and `read` is set: the code units of a JS string, the
+// `Uint8Array` the tree was parsed from, referenced rather than copied, or the
+// callback that supplied the input, which `Node.text` calls again.
+struct TreeSource {
+    TSInputEncoding encoding = TSInputEncodingUTF16LE;
+    std::u16string text;
+    Napi::Reference<Napi::Uint8Array> bytes;
+    Napi::FunctionReference read;
+
+    static std::shared_ptr<const TreeSource> FromString(std::u16string text) {
+        auto source = std::make_shared<TreeSource>();
+        source->text = std::move(text);
+        return source;
+    }
+
+    uint32_t Shift() const {
+        return encoding == TSInputEncodingUTF8 ? 0 : 1;
+    }
+
+    Napi::Value Slice(Napi::Env env, uint32_t start_byte, uint32_t end_byte, TSPoint start_point) const {
+        if (!bytes.IsEmpty()) {
+            // Looked up again, the array may have been detached since parsing.
+            auto array = bytes.Value();
+            size_t length = array.ByteLength();
+            size_t start = std::min<size_t>(start_byte, length);
+            size_t end = std::min<size_t>(end_byte, length);
+            return Napi::String::New(env, reinterpret_cast<const char *>(array.Data()) + start,
+                                     end - start);
+        }
+
+        if (!read.IsEmpty()) {
+            // Like `web-tree-sitter`, read chunks until the range is covered.
+            size_t length = (end_byte - start_byte) / 2;
+            std::u16string result;
+            TSPoint point = start_point;
+            while (result.size() < length) {
+                Napi::HandleScope scope(env);
+                Napi::Value chunk = read.Call({
+                    Napi::Number::New(env, start_byte / 2 + result.size()),
+                    PointToJS(env, point, 1),
+                });
+                if (!chunk.IsString()) break;
+                std::u16string units = chunk.As<Napi::String>().Utf16Value();
+                if (units.empty()) break;
+                units.resize(std::min(units.size(), length - result.size()));
+                for (char16_t unit : units) {
+                    if (unit == u'\n') {
+                        point.row++;
+                        point.column = 0;
+                    } else {
+                        point.column += 2;
+                    }
+                }
+                result += units;
+            }
+            return Napi::String::New(env, result.data(), result.size());
+        }
+
+        size_t start = std::min<size_t>(start_byte / 2, text.size());
+        size_t end = std::min<size_t>(end_byte / 2, text.size());
+        return Napi::String::New(env, text.data() + start, end - start);
+    }
+};
+
+class Tree : public Napi::ObjectWrap<Tree> {
+  public:
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "Tree", {
+            InstanceAccessor<&Tree::RootNode>("rootNode"),
+            InstanceMethod<&Tree::Edit>("edit"),
+            InstanceMethod<&Tree::Walk>("walk"),
+            InstanceMethod<&Tree::GetChangedRanges>("getChangedRanges"),
+            InstanceMethod<&Tree::Copy>("copy"),
+            InstanceMethod<&Tree::Serialize>("serialize"),
+            InstanceMethod<&Tree::Delete>("delete"),
+        });
+    }
+
+    static Napi::Object New(Napi::Env env, TSTree *tree, std::shared_ptr<const TreeSource> source) {
+        auto obj = GetData(env)->tree.New({});
+        auto *self = Unwrap(obj);
+        self->tree_ = tree;
+        self->source_ = std::move(source);
+        return obj;
+    }
+
+    explicit Tree(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Tree>(info) {}
+
+    ~Tree() override {
+        if (tree_ != nullptr) {
+            ts_tree_delete(tree_);
+        }
+    }
+
+    TSTree *tree() const { return tree_; }
+
+    const std::shared_ptr<const TreeSource> &source() const { return source_; }
+
+    uint32_t shift() const { return source_ != nullptr ? source_->Shift() : 1; }
+
+  private:
+    Napi::Value RootNode(const Napi::CallbackInfo &info);
+
+    Napi::Value Walk(const Napi::CallbackInfo &info);
+
+    Napi::Value Edit(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+
+        auto edit = info[0].As<Napi::Object>();
+        uint32_t shift = this->shift();
+        TSInputEdit input_edit = {
+            IndexFromJS(edit.Get("startIndex"), shift),
+            IndexFromJS(edit.Get("oldEndIndex"), shift),
+            IndexFromJS(edit.Get("newEndIndex"), shift),
+            PointFromJS(edit.Get("startPosition"), shift),
+            PointFromJS(edit.Get("oldEndPosition"), shift),
+            PointFromJS(edit.Get("newEndPosition"), shift),
+        };
+        ts_tree_edit(tree_, &input_edit);
+        return info.Env().Undefined();
+    }
+
+    Napi::Value GetChangedRanges(const Napi::CallbackInfo &info) {
+        auto env = info.Env();
+        if (!CheckAlive(env)) return env.Undefined();
+
+        auto *other = UnwrapArg<Tree>(info, 0, GetData(env)->tree, "Tree");
+        if (other == nullptr) return env.Undefined();
+        if (other->tree_ == nullptr) {
+            Napi::Error::New(env, "Tree has been deleted").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint32_t count = 0;
+        TSRange *ranges = ts_tree_get_changed_ranges(tree_, other->tree_, &count);
+        auto result = Napi::Array::New(env, count);
+        for (uint32_t i = 0; i < count; i++) {
+            result[i] = RangeToJS(env, ranges[i], shift());
+        }
+        free(ranges);
+        return result;
+    }
+
+    Napi::Value Copy(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return New(info.Env(), ts_tree_copy(tree_), source_);
+    }
+
+    // See tree-sitter-tact-serialize.h for the format. Offsets are in the same
+    // units as the tree's.
+    Napi::Value Serialize(const Napi::CallbackInfo &info) {
+        auto env = info.Env();
+        if (!CheckAlive(env)) return env.Undefined();
+
+        uint64_t source_hash = 0;
+        if (info.Length() > 0 && info[0].IsNumber()) {
+            source_hash = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+        }
+
+        uint32_t length = 0;
+        uint8_t *data = ts_tact_tree_serialize(tree_, source_->encoding, source_hash, &length);
+        if (data == nullptr) {
+            Napi::Error::New(env, "Tree is too large to serialize").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        // Copied, as external buffers are not allowed in Electron.
+        auto result = Napi::Buffer<uint8_t>::Copy(env, data, length);
+        free(data);
+        return result;
+    }
+
+    Napi::Value Delete(const Napi::CallbackInfo &info) {
+        if (tree_ != nullptr) {
+            ts_tree_delete(tree_);
+            tree_ = nullptr;
+            source_.reset();
+        }
+        return info.Env().Undefined();
+    }
+
+    bool CheckAlive(Napi::Env env) const {
+        if (tree_ == nullptr) {
+            Napi::Error::New(env, "Tree has been deleted").ThrowAsJavaScriptException();
+            return false;
+        }
+        return true;
+    }
+
+    TSTree *tree_ = nullptr;
+    std::shared_ptr<const TreeSource> source_;
+};
+
+class Node : public Napi::ObjectWrap<Node> {
+  public:
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "Node", {
+            InstanceAccessor<&Node::Id>("id"),
+            InstanceAccessor<&Node::TypeId>("typeId"),
+            InstanceAccessor<&Node::Type>("type"),
+            InstanceAccessor<&Node::GrammarType>("grammarType"),
+            InstanceAccessor<&Node::IsNamed>("isNamed"),
+            InstanceAccessor<&Node::IsMissing>("isMissing"),
+            InstanceAccessor<&Node::IsExtra>("isExtra"),
+            InstanceAccessor<&Node::IsError>("isError"),
+            InstanceAccessor<&Node::HasError>("hasError"),
+            InstanceAccessor<&Node::HasChanges>("hasChanges"),
+            InstanceAccessor<&Node::StartIndex>("startIndex"),
+            InstanceAccessor<&Node::EndIndex>("endIndex"),
+            InstanceAccessor<&Node::StartPosition>("startPosition"),
+            InstanceAccessor<&Node::EndPosition>("endPosition"),
+            InstanceAccessor<&Node::Text>("text"),
+            InstanceAccessor<&Node::TreeObject>("tree"),
+            InstanceAccessor<&Node::Parent>("parent"),
+            InstanceAccessor<&Node::Children>("children"),
+            InstanceAccessor<&Node::NamedChildren>("namedChildren"),
+            InstanceAccessor<&Node::ChildCount>("childCount"),
+            InstanceAccessor<&Node::NamedChildCount>("namedChildCount"),
+            InstanceAccessor<&Node::DescendantCount>("descendantCount"),
+            InstanceAccessor<&Node::FirstChild>("firstChild"),
+            InstanceAccessor<&Node::LastChild>("lastChild"),
+            InstanceAccessor<&Node::FirstNamedChild>("firstNamedChild"),
+            InstanceAccessor<&Node::LastNamedChild>("lastNamedChild"),
+            InstanceAccessor<&Node::NextSibling>("nextSibling"),
+            InstanceAccessor<&Node::PreviousSibling>("previousSibling"),
+            InstanceAccessor<&Node::NextNamedSibling>("nextNamedSibling"),
+            InstanceAccessor<&Node::PreviousNamedSibling>("previousNamedSibling"),
+            InstanceMethod<&Node::Child>("child"),
+            InstanceMethod<&Node::NamedChild>("namedChild"),
+            InstanceMethod<&Node::ChildForFieldName>("childForFieldName"),
+            InstanceMethod<&Node::ChildrenForFieldName>("childrenForFieldName"),
+            InstanceMethod<&Node::FieldNameForChild>("fieldNameForChild"),
+            InstanceMethod<&Node::DescendantForIndex>("descendantForIndex"),
+            InstanceMethod<&Node::NamedDescendantForIndex>("namedDescendantForIndex"),
+            InstanceMethod<&Node::DescendantForPosition>("descendantForPosition"),
+            InstanceMethod<&Node::NamedDescendantForPosition>("namedDescendantForPosition"),
+            InstanceMethod<&Node::Equals>("equals"),
+            InstanceMethod<&Node::Walk>("walk"),
+            InstanceMethod<&Node::ToString>("toString"),
+        });
+    }
+
+    // Wraps `node` or returns `null` for a null node, so callers can pass
+    // the result of any `ts_node_*` navigation function straight through.
+    static Napi::Value New(Napi::Env env, TSNode node, const Napi::Object &tree) {
+        if (ts_node_is_null(node)) {
+            return env.Null();
+        }
+        auto obj = GetData(env)->node.New({});
+        auto *self = Unwrap(obj);
+        self->node_ = node;
+        self->tree_ = Napi::Persistent(tree);
+        return obj;
+    }
+
+    explicit Node(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Node>(info) {}
+
+    TSNode node() const { return node_; }
+
+    Napi::Object TreeValue() const { return tree_.Value(); }
+
+    bool Alive() { return OwnerTree()->tree() != nullptr; }
+
+  private:
+    Napi::Value Wrap(Napi::Env env, TSNode node) {
+        return New(env, node, tree_.Value());
+    }
+
+    const Tree *OwnerTree() {
+        return Tree::Unwrap(tree_.Value());
+    }
+
+    // Nodes point into the memory of their tree, which `tree.delete()` frees.
+    bool CheckAlive(Napi::Env env) {
+        if (OwnerTree()->tree() == nullptr) {
+            Napi::Error::New(env, "Tree has been deleted").ThrowAsJavaScriptException();
+            return false;
+        }
+        return true;
+    }
+
+    Napi::Value Id(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), static_cast<double>(reinterpret_cast<uintptr_t>(node_.id)));
+    }
+
+    Napi::Value TypeId(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), ts_node_symbol(node_));
+    }
+
+    Napi::Value Type(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::String::New(info.Env(), ts_node_type(node_));
+    }
+
+    Napi::Value GrammarType(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::String::New(info.Env(), ts_node_grammar_type(node_));
+    }
+
+    Napi::Value IsNamed(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_is_named(node_));
+    }
+
+    Napi::Value IsMissing(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_is_missing(node_));
+    }
+
+    Napi::Value IsExtra(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_is_extra(node_));
+    }
+
+    Napi::Value IsError(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_is_error(node_));
+    }
+
+    Napi::Value HasError(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_has_error(node_));
+    }
+
+    Napi::Value HasChanges(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_has_changes(node_));
+    }
+
+    Napi::Value StartIndex(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), ts_node_start_byte(node_) >> OwnerTree()->shift());
+    }
+
+    Napi::Value EndIndex(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), ts_node_end_byte(node_) >> OwnerTree()->shift());
+    }
+
+    Napi::Value StartPosition(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return PointToJS(info.Env(), ts_node_start_point(node_), OwnerTree()->shift());
+    }
+
+    Napi::Value EndPosition(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return PointToJS(info.Env(), ts_node_end_point(node_), OwnerTree()->shift());
+    }
+
+    Napi::Value Text(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        const auto &source = OwnerTree()->source();
+        return source->Slice(info.Env(), ts_node_start_byte(node_), ts_node_end_byte(node_),
+                             ts_node_start_point(node_));
+    }
+
+    Napi::Value TreeObject(const Napi::CallbackInfo &) {
+        return tree_.Value();
+    }
+
+    Napi::Value Parent(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_parent(node_));
+    }
+
+    Napi::Value Children(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        auto env = info.Env();
+        auto result = Napi::Array::New(env, ts_node_child_count(node_));
+        TSTreeCursor cursor = ts_tree_cursor_new(node_);
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            uint32_t i = 0;
+            do {
+                result[i++] = Wrap(env, ts_tree_cursor_current_node(&cursor));
+            } while (ts_tree_cursor_goto_next_sibling(&cursor));
+        }
+        ts_tree_cursor_delete(&cursor);
+        return result;
+    }
+
+    Napi::Value NamedChildren(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        auto env = info.Env();
+        auto result = Napi::Array::New(env, ts_node_named_child_count(node_));
+        TSTreeCursor cursor = ts_tree_cursor_new(node_);
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            uint32_t i = 0;
+            do {
+                TSNode child = ts_tree_cursor_current_node(&cursor);
+                if (ts_node_is_named(child)) {
+                    result[i++] = Wrap(env, child);
+                }
+            } while (ts_tree_cursor_goto_next_sibling(&cursor));
+        }
+        ts_tree_cursor_delete(&cursor);
+        return result;
+    }
+
+    Napi::Value ChildCount(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), ts_node_child_count(node_));
+    }
+
+    Napi::Value NamedChildCount(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), ts_node_named_child_count(node_));
+    }
+
+    Napi::Value DescendantCount(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Number::New(info.Env(), ts_node_descendant_count(node_));
+    }
+
+    Napi::Value FirstChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_child(node_, 0));
+    }
+
+    Napi::Value LastChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t count = ts_node_child_count(node_);
+        if (count == 0) return info.Env().Null();
+        return Wrap(info.Env(), ts_node_child(node_, count - 1));
+    }
+
+    Napi::Value FirstNamedChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_named_child(node_, 0));
+    }
+
+    Napi::Value LastNamedChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t count = ts_node_named_child_count(node_);
+        if (count == 0) return info.Env().Null();
+        return Wrap(info.Env(), ts_node_named_child(node_, count - 1));
+    }
+
+    Napi::Value NextSibling(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_next_sibling(node_));
+    }
+
+    Napi::Value PreviousSibling(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_prev_sibling(node_));
+    }
+
+    Napi::Value NextNamedSibling(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_next_named_sibling(node_));
+    }
+
+    Napi::Value PreviousNamedSibling(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_prev_named_sibling(node_));
+    }
+
+    Napi::Value Child(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_child(node_, info[0].As<Napi::Number>().Uint32Value()));
+    }
+
+    Napi::Value NamedChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Wrap(info.Env(), ts_node_named_child(node_, info[0].As<Napi::Number>().Uint32Value()));
+    }
+
+    Napi::Value ChildForFieldName(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        std::string name = info[0].As<Napi::String>().Utf8Value();
+        return Wrap(info.Env(), ts_node_child_by_field_name(node_, name.data(), name.size()));
+    }
+
+    Napi::Value ChildrenForFieldName(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        auto env = info.Env();
+        std::string name = info[0].As<Napi::String>().Utf8Value();
+        TSFieldId field_id = ts_language_field_id_for_name(tree_sitter_tact(), name.data(), name.size());
+
+        auto result = Napi::Array::New(env);
+        if (field_id == 0) return result;
+
+        TSTreeCursor cursor = ts_tree_cursor_new(node_);
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            uint32_t i = 0;
+            do {
+                if (ts_tree_cursor_current_field_id(&cursor) == field_id) {
+                    result[i++] = Wrap(env, ts_tree_cursor_current_node(&cursor));
+                }
+            } while (ts_tree_cursor_goto_next_sibling(&cursor));
+        }
+        ts_tree_cursor_delete(&cursor);
+        return result;
+    }
+
+    Napi::Value FieldNameForChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        const char *name = ts_node_field_name_for_child(node_, info[0].As<Napi::Number>().Uint32Value());
+        if (name == nullptr) return info.Env().Null();
+        return Napi::String::New(info.Env(), name);
+    }
+
+    Napi::Value DescendantForIndex(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t shift = OwnerTree()->shift();
+        uint32_t start = IndexFromJS(info[0], shift);
+        uint32_t end = info.Length() > 1 ? IndexFromJS(info[1], shift) : start;
+        return Wrap(info.Env(), ts_node_descendant_for_byte_range(node_, start, end));
+    }
+
+    Napi::Value NamedDescendantForIndex(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t shift = OwnerTree()->shift();
+        uint32_t start = IndexFromJS(info[0], shift);
+        uint32_t end = info.Length() > 1 ? IndexFromJS(info[1], shift) : start;
+        return Wrap(info.Env(), ts_node_named_descendant_for_byte_range(node_, start, end));
+    }
+
+    Napi::Value DescendantForPosition(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t shift = OwnerTree()->shift();
+        TSPoint start = PointFromJS(info[0], shift);
+        TSPoint end = info.Length() > 1 ? PointFromJS(info[1], shift) : start;
+        return Wrap(info.Env(), ts_node_descendant_for_point_range(node_, start, end));
+    }
+
+    Napi::Value NamedDescendantForPosition(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t shift = OwnerTree()->shift();
+        TSPoint start = PointFromJS(info[0], shift);
+        TSPoint end = info.Length() > 1 ? PointFromJS(info[1], shift) : start;
+        return Wrap(info.Env(), ts_node_named_descendant_for_point_range(node_, start, end));
+    }
+
+    Napi::Value Equals(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        if (info[0].IsNull() || info[0].IsUndefined()) return Napi::Boolean::New(info.Env(), false);
+        auto *other = UnwrapArg<Node>(info, 0, GetData(info.Env())->node, "Node");
+        if (other == nullptr) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_node_eq(node_, other->node_));
+    }
+
+    Napi::Value Walk(const Napi::CallbackInfo &info);
+
+    Napi::Value ToString(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        char *sexp = ts_node_string(node_);
+        auto result = Napi::String::New(info.Env(), sexp);
+        free(sexp);
+        return result;
+    }
+
+    TSNode node_{};
+    Napi::ObjectReference tree_;
+};
+
+class TreeCursor : public Napi::ObjectWrap<TreeCursor> {
+  public:
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "TreeCursor", {
+            InstanceAccessor<&TreeCursor::CurrentNode>("currentNode"),
+            InstanceAccessor<&TreeCursor::CurrentFieldName>("currentFieldName"),
+            InstanceAccessor<&TreeCursor::NodeType>("nodeType"),
+            InstanceAccessor<&TreeCursor::StartIndex>("startIndex"),
+            InstanceAccessor<&TreeCursor::EndIndex>("endIndex"),
+            InstanceMethod<&TreeCursor::GotoFirstChild>("gotoFirstChild"),
+            InstanceMethod<&TreeCursor::GotoLastChild>("gotoLastChild"),
+            InstanceMethod<&TreeCursor::GotoNextSibling>("gotoNextSibling"),
+            InstanceMethod<&TreeCursor::GotoPreviousSibling>("gotoPreviousSibling"),
+            InstanceMethod<&TreeCursor::GotoParent>("gotoParent"),
+            InstanceMethod<&TreeCursor::Reset>("reset"),
+            InstanceMethod<&TreeCursor::Delete>("delete"),
+        });
+    }
+
+    static Napi::Object New(Napi::Env env, TSNode node, const Napi::Object &tree) {
+        auto obj = GetData(env)->cursor.New({});
+        auto *self = Unwrap(obj);
+        self->cursor_ = ts_tree_cursor_new(node);
+        self->alive_ = true;
+        self->tree_ = Napi::Persistent(tree);
+        return obj;
+    }
+
+    explicit TreeCursor(const Napi::CallbackInfo &info) : Napi::ObjectWrap<TreeCursor>(info) {}
+
+    ~TreeCursor() override {
+        if (alive_) {
+            ts_tree_cursor_delete(&cursor_);
+        }
+    }
+
+  private:
+    // Cursors point into the memory of their tree, which `tree.delete()` frees.
+    bool CheckAlive(Napi::Env env) {
+        if (!alive_ || Tree::Unwrap(tree_.Value())->tree() == nullptr) {
+            Napi::Error::New(env, alive_ ? "Tree has been deleted" : "Cursor has been deleted")
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+        return true;
+    }
+
+    Napi::Value CurrentNode(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Node::New(info.Env(), ts_tree_cursor_current_node(&cursor_), tree_.Value());
+    }
+
+    Napi::Value CurrentFieldName(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        const char *name = ts_tree_cursor_current_field_name(&cursor_);
+        if (name == nullptr) return info.Env().Null();
+        return Napi::String::New(info.Env(), name);
+    }
+
+    Napi::Value NodeType(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::String::New(info.Env(), ts_node_type(ts_tree_cursor_current_node(&cursor_)));
+    }
+
+    Napi::Value StartIndex(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t shift = Tree::Unwrap(tree_.Value())->shift();
+        return Napi::Number::New(info.Env(), ts_node_start_byte(ts_tree_cursor_current_node(&cursor_)) >> shift);
+    }
+
+    Napi::Value EndIndex(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        uint32_t shift = Tree::Unwrap(tree_.Value())->shift();
+        return Napi::Number::New(info.Env(), ts_node_end_byte(ts_tree_cursor_current_node(&cursor_)) >> shift);
+    }
+
+    Napi::Value GotoFirstChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_tree_cursor_goto_first_child(&cursor_));
+    }
+
+    Napi::Value GotoLastChild(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_tree_cursor_goto_last_child(&cursor_));
+    }
+
+    Napi::Value GotoNextSibling(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_tree_cursor_goto_next_sibling(&cursor_));
+    }
+
+    Napi::Value GotoPreviousSibling(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_tree_cursor_goto_previous_sibling(&cursor_));
+    }
+
+    Napi::Value GotoParent(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        return Napi::Boolean::New(info.Env(), ts_tree_cursor_goto_parent(&cursor_));
+    }
+
+    Napi::Value Reset(const Napi::CallbackInfo &info) {
+        if (!CheckAlive(info.Env())) return info.Env().Undefined();
+        auto *node = UnwrapArg<Node>(info, 0, GetData(info.Env())->node, "Node");
+        if (node == nullptr) return info.Env().Undefined();
+        if (!node->Alive()) {
+            Napi::Error::New(info.Env(), "Tree has been deleted").ThrowAsJavaScriptException();
+            return info.Env().Undefined();
+        }
+        ts_tree_cursor_reset(&cursor_, node->node());
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Delete(const Napi::CallbackInfo &info) {
+        if (alive_) {
+            ts_tree_cursor_delete(&cursor_);
+            alive_ = false;
+        }
+        return info.Env().Undefined();
+    }
+
+    TSTreeCursor cursor_{};
+    bool alive_ = false;
+    Napi::ObjectReference tree_;
+};
+
+Napi::Value Tree::RootNode(const Napi::CallbackInfo &info) {
+    if (!CheckAlive(info.Env())) return info.Env().Undefined();
+    return Node::New(info.Env(), ts_tree_root_node(tree_), Value());
+}
+
+Napi::Value Tree::Walk(const Napi::CallbackInfo &info) {
+    if (!CheckAlive(info.Env())) return info.Env().Undefined();
+    return TreeCursor::New(info.Env(), ts_tree_root_node(tree_), Value());
+}
+
+Napi::Value Node::Walk(const Napi::CallbackInfo &info) {
+    if (!CheckAlive(info.Env())) return info.Env().Undefined();
+    return TreeCursor::New(info.Env(), node_, tree_.Value());
+}
+
+struct StringInput {
+    const char *data;
+    uint32_t length;
+
+    static const char *Read(void *payload, uint32_t byte, TSPoint, uint32_t *bytes_read) {
+        auto *self = static_cast<StringInput *>(payload);
+        if (byte >= self->length) {
+            *bytes_read = 0;
+            return "";
+        }
+        *bytes_read = self->length - byte;
+        return self->data + byte;
+    }
+
+    TSInput ToTSInput(TSInputEncoding encoding = TSInputEncodingUTF16LE) {
+        TSInput input = {};
+        input.payload = this;
+        input.read = Read;
+        input.encoding = encoding;
+        return input;
+    }
+};
+
+// Input read chunk by chunk from a JS callback, e.g. over the pieces of a rope,
+// so the document is never copied whole. Same contract as `web-tree-sitter`'s
+// `ParseCallback`: called with a UTF-16 index and position, returns the text
+// from there on, or an empty string or `null` at the end of the input.
+struct CallbackInput {
+    Napi::Env env;
+    Napi::Function callback;
+    // Owned by the input until the next read, as the runtime requires.
+    std::u16string chunk;
+    // Thrown by the callback, rethrown once the runtime has returned.
+    Napi::Error error;
+
+    static const char *Read(void *payload, uint32_t byte, TSPoint point, uint32_t *bytes_read) {
+        auto *self = static_cast<CallbackInput *>(payload);
+        self->chunk.clear();
+        if (self->error.IsEmpty()) {
+            Napi::HandleScope scope(self->env);
+            // The runtime is C, so an exception must not unwind through it.
+            try {
+                Napi::Value result = self->callback.Call({
+                    Napi::Number::New(self->env, byte / 2),
+                    PointToJS(self->env, point, 1),
+                });
+                if (result.IsString()) {
+                    self->chunk = result.As<Napi::String>().Utf16Value();
+                }
+            } catch (const Napi::Error &error) {
+                self->error = error;
+            }
+        }
+        *bytes_read = static_cast<uint32_t>(self->chunk.size() * sizeof(char16_t));
+        return reinterpret_cast<const char *>(self->chunk.data());
+    }
+
+    TSInput ToTSInput() {
+        TSInput input = {};
+        input.payload = this;
+        input.read = Read;
+        input.encoding = TSInputEncodingUTF16LE;
+        return input;
+    }
+};
+
+// Parse options, `web-tree-sitter`'s `progressCallback` plus a native
+// `timeoutMicros` that is checked without calling back into JS.
+struct ParseProgress {
+    Napi::Env env;
+    Napi::Function callback;
+    bool has_deadline = false;
+    std::chrono::steady_clock::time_point deadline;
+    // Thrown by the callback, rethrown once the runtime has returned.
+    Napi::Error error;
+
+    // Units of `currentOffset`, see `shift` at the top of the file.
+    uint32_t shift;
+
+    ParseProgress(Napi::Env env, const Napi::Object &options, uint32_t shift) : env(env), shift(shift) {
+        Napi::Value callback_value = options.Get("progressCallback");
+        if (callback_value.IsFunction()) {
+            callback = callback_value.As<Napi::Function>();
+        }
+        Napi::Value timeout = options.Get("timeoutMicros");
+        if (timeout.IsNumber()) {
+            has_deadline = true;
+            deadline = std::chrono::steady_clock::now() +
+                       std::chrono::microseconds(timeout.As<Napi::Number>().Int64Value());
+        }
+    }
+
+    // Returns true to cancel the parse.
+    static bool Callback(TSParseState *state) {
+        auto *self = static_cast<ParseProgress *>(state->payload);
+        if (self->has_deadline && std::chrono::steady_clock::now() >= self->deadline) {
+            return true;
+        }
+        if (self->callback.IsEmpty()) return false;
+
+        Napi::HandleScope scope(self->env);
+        auto js_state = Napi::Object::New(self->env);
+        js_state["currentOffset"] = Napi::Number::New(self->env, state->current_byte_offset >> self->shift);
+        js_state["hasError"] = Napi::Boolean::New(self->env, state->has_error);
+        // The runtime is C, so an exception must not unwind through it.
+        try {
+            return self->callback.Call({js_state}).ToBoolean().Value();
+        } catch (const Napi::Error &error) {
+            self->error = error;
+            return true;
+        }
+    }
+};
+
+class Parser : public Napi::ObjectWrap<Parser> {
+  public:
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "Parser", {
+            InstanceMethod<&Parser::SetLanguage>("setLanguage"),
+            InstanceMethod<&Parser::Parse>("parse"),
+            InstanceMethod<&Parser::Reset>("reset"),
+            InstanceMethod<&Parser::Delete>("delete"),
+        });
+    }
+
+    explicit Parser(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Parser>(info) {
+        parser_ = ts_parser_new();
+        ts_parser_set_language(parser_, tree_sitter_tact());
+    }
+
+    ~Parser() override {
+        if (parser_ != nullptr) {
+            ts_parser_delete(parser_);
+        }
+    }
+
+  private:
+    // The addon is built for a single grammar, the argument is accepted only
+    // for compatibility with `web-tree-sitter`.
+    Napi::Value SetLanguage(const Napi::CallbackInfo &info) {
+        return info.Env().Undefined();
+    }
+
+    // Accepts a string, a `Uint8Array` of UTF-8 which is parsed in place, or a
+    // read callback, see `CallbackInput`.
+    Napi::Value Parse(const Napi::CallbackInfo &info) {
+        auto env = info.Env();
+        if (parser_ == nullptr) {
+            Napi::Error::New(env, "Parser has been deleted").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        auto source = std::make_shared<TreeSource>();
+        StringInput string_input = {};
+        CallbackInput callback_input = {env};
+        TSInput input;
+        if (info[0].IsString()) {
+            source->text = info[0].As<Napi::String>().Utf16Value();
+            string_input = {
+                reinterpret_cast<const char *>(source->text.data()),
+                static_cast<uint32_t>(source->text.size() * sizeof(char16_t)),
+            };
+            input = string_input.ToTSInput();
+        } else if (info[0].IsTypedArray() &&
+                   info[0].As<Napi::TypedArray>().TypedArrayType() == napi_uint8_array) {
+            auto bytes = info[0].As<Napi::Uint8Array>();
+            source->encoding = TSInputEncodingUTF8;
+            source->bytes = Napi::Persistent(bytes);
+            string_input = {
+                reinterpret_cast<const char *>(bytes.Data()),
+                static_cast<uint32_t>(bytes.ByteLength()),
+            };
+            input = string_input.ToTSInput(TSInputEncodingUTF8);
+        } else if (info[0].IsFunction()) {
+            callback_input.callback = info[0].As<Napi::Function>();
+            source->read = Napi::Persistent(callback_input.callback);
+            input = callback_input.ToTSInput();
+        } else {
+            Napi::TypeError::New(env, "Input must be a string, a Uint8Array or a function")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        const TSTree *old_tree = nullptr;
+        if (info.Length() > 1 && !info[1].IsNull() && !info[1].IsUndefined()) {
+            auto *old = UnwrapArg<Tree>(info, 1, GetData(env)->tree, "Tree");
+            if (old == nullptr) return env.Undefined();
+            if (old->tree() != nullptr && old->shift() != source->Shift()) {
+                Napi::Error::New(env, "The old tree was parsed from input in another encoding")
+                    .ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            old_tree = old->tree();
+        }
+
+        TSTree *tree;
+        Napi::Error error;
+        if (info.Length() > 2 && info[2].IsObject()) {
+            ParseProgress progress(env, info[2].As<Napi::Object>(), source->Shift());
+            TSParseOptions options = {&progress, ParseProgress::Callback};
+            tree = ts_parser_parse_with_options(parser_, old_tree, input, options);
+            error = progress.error;
+        } else {
+            tree = ts_parser_parse(parser_, old_tree, input);
+        }
+        if (error.IsEmpty()) {
+            error = callback_input.error;
+        }
+
+        if (!error.IsEmpty()) {
+            ts_parser_reset(parser_);
+            if (tree != nullptr) ts_tree_delete(tree);
+            error.ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        if (tree == nullptr) {
+            // A cancelled parse would be resumed by the next call otherwise.
+            ts_parser_reset(parser_);
+            return env.Null();
+        }
+        return Tree::New(env, tree, std::move(source));
+    }
+
+    Napi::Value Reset(const Napi::CallbackInfo &info) {
+        if (parser_ != nullptr) {
+            ts_parser_reset(parser_);
+        }
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Delete(const Napi::CallbackInfo &info) {
+        if (parser_ != nullptr) {
+            ts_parser_delete(parser_);
+            parser_ = nullptr;
+        }
+        return info.Env().Undefined();
+    }
+
+    TSParser *parser_ = nullptr;
+};
+
+// A text predicate of a query pattern: `#eq?`, `#match?` or `#any-of?`, or one
+// of their `not-` and `any-` forms. Evaluated like `web-tree-sitter` does, so
+// both runtimes return the same matches for the same query.
+struct TextPredicate {
+    enum class Kind { Eq, Match, AnyOf };
+
+    Kind kind = Kind::Eq;
+    // False for the `not-` forms.
+    bool positive = true;
+    // False for the `any-` forms: one node of a quantified capture is enough.
+    bool match_all = true;
+    uint32_t capture = 0;
+    // `#eq?` against another capture instead of `values[0]`.
+    bool compares_captures = false;
+    uint32_t other_capture = 0;
+    std::vector<std::string> values;
+    Napi::ObjectReference regex;
+
+    bool Satisfied(Napi::Env env, const TSQueryMatch &match, const TreeSource &source) const {
+        auto text = [&](TSNode node) {
+            return source.Slice(env, ts_node_start_byte(node), ts_node_end_byte(node), ts_node_start_point(node));
+        };
+
+        std::vector<TSNode> nodes;
+        std::vector<TSNode> others;
+        for (uint16_t i = 0; i < match.capture_count; i++) {
+            if (match.captures[i].index == capture) nodes.push_back(match.captures[i].node);
+            if (compares_captures && match.captures[i].index == other_capture) {
+                others.push_back(match.captures[i].node);
+            }
+        }
+
+        auto test = [&](TSNode node) {
+            Napi::Value node_text = text(node);
+            switch (kind) {
+                case Kind::Eq:
+                    if (compares_captures) {
+                        return std::any_of(others.begin(), others.end(), [&](TSNode other) {
+                            return node_text.StrictEquals(text(other)) == positive;
+                        });
+                    }
+                    return (node_text.As<Napi::String>().Utf8Value() == values[0]) == positive;
+                case Kind::Match: {
+                    auto object = regex.Value();
+                    bool found = object.Get("test").As<Napi::Function>().Call(object, {node_text}).ToBoolean();
+                    return found == positive;
+                }
+                case Kind::AnyOf: {
+                    std::string value = node_text.As<Napi::String>().Utf8Value();
+                    return (std::find(values.begin(), values.end(), value) != values.end()) == positive;
+                }
+            }
+            return false;
+        };
+        return match_all ? std::all_of(nodes.begin(), nodes.end(), test)
+                         : std::any_of(nodes.begin(), nodes.end(), test);
+    }
+};
+
+// Queries are compiled against the Tact grammar only. Text predicates are
+// evaluated natively, see `TextPredicate`. Other predicates and directives,
+// such as `#set!`, are rejected when the query is created.
+class Query : public Napi::ObjectWrap<Query> {
+  public:
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "Query", {
+            InstanceAccessor<&Query::CaptureNames>("captureNames"),
+            InstanceMethod<&Query::Captures>("captures"),
+            InstanceMethod<&Query::Matches>("matches"),
+        });
+    }
+
+    explicit Query(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Query>(info) {
+        auto env = info.Env();
+        std::string source = info[0].As<Napi::String>().Utf8Value();
+
+        uint32_t error_offset = 0;
+        TSQueryError error_type = TSQueryErrorNone;
+        query_ = ts_query_new(tree_sitter_tact(), source.data(), source.size(), &error_offset, &error_type);
+        if (query_ == nullptr) {
+            Napi::Error::New(env, "Invalid query at offset " + std::to_string(error_offset))
+                .ThrowAsJavaScriptException();
+            return;
+        }
+        cursor_ = ts_query_cursor_new();
+
+        uint32_t pattern_count = ts_query_pattern_count(query_);
+        predicates_.resize(pattern_count);
+        for (uint32_t pattern = 0; pattern < pattern_count; pattern++) {
+            uint32_t step_count = 0;
+            const TSQueryPredicateStep *steps = ts_query_predicates_for_pattern(query_, pattern, &step_count);
+            uint32_t start = 0;
+            for (uint32_t i = 0; i < step_count; i++) {
+                if (steps[i].type != TSQueryPredicateStepTypeDone) continue;
+                if (!AddPredicate(env, pattern, steps + start, i - start)) return;
+                start = i + 1;
+            }
+        }
+    }
+
+    ~Query() override {
+        if (cursor_ != nullptr) ts_query_cursor_delete(cursor_);
+        if (query_ != nullptr) ts_query_delete(query_);
+    }
+
+  private:
+    std::string StringValue(uint32_t id) const {
+        uint32_t length = 0;
+        const char *value = ts_query_string_value_for_id(query_, id, &length);
+        return std::string(value, length);
+    }
+
+    bool AddPredicate(Napi::Env env, uint32_t pattern, const TSQueryPredicateStep *steps, uint32_t count) {
+        std::string name = count > 0 && steps[0].type == TSQueryPredicateStepTypeString
+                               ? StringValue(steps[0].value_id)
+                               : std::string();
+
+        TextPredicate predicate;
+        std::string op = name;
+        if (op.rfind("any-", 0) == 0 && op != "any-of?") {
+            predicate.match_all = false;
+            op = op.substr(4);
+        }
+        if (op.rfind("not-", 0) == 0) {
+            predicate.positive = false;
+            op = op.substr(4);
+        }
+
+        bool valid = count >= 3 && steps[1].type == TSQueryPredicateStepTypeCapture;
+        if (op == "eq?") {
+            predicate.kind = TextPredicate::Kind::Eq;
+            valid = valid && count == 3;
+        } else if (op == "match?") {
+            predicate.kind = TextPredicate::Kind::Match;
+            valid = valid && count == 3 && steps[2].type == TSQueryPredicateStepTypeString;
+        } else if (op == "any-of?") {
+            predicate.kind = TextPredicate::Kind::AnyOf;
+            for (uint32_t i = 2; i < count; i++) {
+                valid = valid && steps[i].type == TSQueryPredicateStepTypeString;
+            }
+        } else {
+            Napi::Error::New(env, "Unsupported predicate #" + name + " in pattern " + std::to_string(pattern) +
+                                      ", only text predicates are supported")
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+        if (!valid) {
+            Napi::Error::New(env, "Wrong arguments to #" + name + " in pattern " + std::to_string(pattern))
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+
+        predicate.capture = steps[1].value_id;
+        if (steps[2].type == TSQueryPredicateStepTypeCapture) {
+            predicate.compares_captures = true;
+            predicate.other_capture = steps[2].value_id;
+        } else {
+            for (uint32_t i = 2; i < count; i++) {
+                predicate.values.push_back(StringValue(steps[i].value_id));
+            }
+        }
+        if (predicate.kind == TextPredicate::Kind::Match) {
+            auto regexp = env.Global().Get("RegExp").As<Napi::Function>();
+            predicate.regex = Napi::Persistent(regexp.New({Napi::String::New(env, predicate.values[0])}));
+        }
+
+        predicates_[pattern].push_back(std::move(predicate));
+        return true;
+    }
+
+    bool Satisfied(Napi::Env env, const TSQueryMatch &match, const TreeSource &source) const {
+        for (const auto &predicate : predicates_[match.pattern_index]) {
+            if (!predicate.Satisfied(env, match, source)) return false;
+        }
+        return true;
+    }
+
+    Napi::Value CaptureNames(const Napi::CallbackInfo &info) {
+        auto env = info.Env();
+        uint32_t count = ts_query_capture_count(query_);
+        auto result = Napi::Array::New(env, count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t length = 0;
+            const char *name = ts_query_capture_name_for_id(query_, i, &length);
+            result[i] = Napi::String::New(env, name, length);
+        }
+        return result;
+    }
+
+    Napi::Object CaptureToJS(Napi::Env env, const TSQueryCapture &capture, uint32_t pattern, const Napi::Object &tree) {
+        uint32_t length = 0;
+        const char *name = ts_query_capture_name_for_id(query_, capture.index, &length);
+        auto result = Napi::Object::New(env);
+        result["name"] = Napi::String::New(env, name, length);
+        result["patternIndex"] = Napi::Number::New(env, pattern);
+        result["node"] = Node::New(env, capture.node, tree);
+        return result;
+    }
+
+    // The node argument of `captures` and `matches`, or nullptr after throwing.
+    Node *NodeArg(const Napi::CallbackInfo &info) {
+        auto *node = UnwrapArg<Node>(info, 0, GetData(info.Env())->node, "Node");
+        if (node != nullptr && !node->Alive()) {
+            Napi::Error::New(info.Env(), "Tree has been deleted").ThrowAsJavaScriptException();
+            return nullptr;
+        }
+        return node;
+    }
+
+    Napi::Value Captures(const Napi::CallbackInfo &info) {
+        auto env = info.Env();
+        auto *node = NodeArg(info);
+        if (node == nullptr) return env.Undefined();
+        auto tree = node->TreeValue();
+        const TreeSource &source = *Tree::Unwrap(tree)->source();
+
+        ts_query_cursor_exec(cursor_, query_, node->node());
+
+        auto result = Napi::Array::New(env);
+        uint32_t i = 0;
+        TSQueryMatch match;
+        uint32_t capture_index = 0;
+        while (ts_query_cursor_next_capture(cursor_, &match, &capture_index)) {
+            if (!Satisfied(env, match, source)) continue;
+            result[i++] = CaptureToJS(env, match.captures[capture_index], match.pattern_index, tree);
+        }
+        return result;
+    }
+
+    Napi::Value Matches(const Napi::CallbackInfo &info) {
+        auto env = info.Env();
+        auto *node = NodeArg(info);
+        if (node == nullptr) return env.Undefined();
+        auto tree = node->TreeValue();
+        const TreeSource &source = *Tree::Unwrap(tree)->source();
+
+        ts_query_cursor_exec(cursor_, query_, node->node());
+
+        auto result = Napi::Array::New(env);
+        uint32_t i = 0;
+        TSQueryMatch match;
+        while (ts_query_cursor_next_match(cursor_, &match)) {
+            if (!Satisfied(env, match, source)) continue;
+            auto captures = Napi::Array::New(env, match.capture_count);
+            for (uint16_t j = 0; j < match.capture_count; j++) {
+                captures[j] = CaptureToJS(env, match.captures[j], match.pattern_index, tree);
+            }
+            auto item = Napi::Object::New(env);
+            item["patternIndex"] = Napi::Number::New(env, match.pattern_index);
+            item["captures"] = captures;
+            result[i++] = item;
+        }
+        return result;
+    }
+
+    TSQuery *query_ = nullptr;
+    TSQueryCursor *cursor_ = nullptr;
+    // Text predicates of each pattern.
+    std::vector<std::vector<TextPredicate>> predicates_;
+};
+
+// Parses all sources off the JS thread. With the batch parser the inputs are
+// spread over its pool, otherwise they are parsed one by one on the libuv
+// worker running this job.
+class ParseBatchWorker : public Napi::AsyncWorker {
+  public:
+    ParseBatchWorker(Napi::Env env, std::vector<std::u16string> sources, uint64_t timeout_micros)
+        : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)),
+          sources_(std::move(sources)), trees_(sources_.size(), nullptr),
+          timeout_micros_(timeout_micros) {
+        AddonData *data = GetData(env);
+        if (data->batch == nullptr) {
+            data->batch = ts_tact_batch_parser_new(0);
+        }
+        batch_ = data->batch;
+    }
+
+    ~ParseBatchWorker() override {
+        for (TSTree *tree : trees_) {
+            if (tree != nullptr) ts_tree_delete(tree);
+        }
+    }
+
+    Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  protected:
+    void Execute() override {
+        if (batch_ != nullptr) {
+            std::vector<TSTactBatchInput> inputs;
+            inputs.reserve(sources_.size());
+            for (const auto &source : sources_) {
+                inputs.push_back({
+                    reinterpret_cast<const char *>(source.data()),
+                    static_cast<uint32_t>(source.size() * sizeof(char16_t)),
+                    TSInputEncodingUTF16LE,
+                    timeout_micros_,
+                });
+            }
+            ts_tact_batch_parse(batch_, inputs.data(), static_cast<uint32_t>(inputs.size()),
+                                trees_.data());
+            return;
+        }
+
+        // No worker threads could be started, parse the sources one by one.
+        TSParser *parser = ts_parser_new();
+        ts_parser_set_language(parser, tree_sitter_tact());
+        for (size_t i = 0; i < sources_.size(); i++) {
+            StringInput input = {
+                reinterpret_cast<const char *>(sources_[i].data()),
+                static_cast<uint32_t>(sources_[i].size() * sizeof(char16_t)),
+            };
+            if (timeout_micros_ == 0) {
+                trees_[i] = ts_parser_parse(parser, nullptr, input.ToTSInput());
+                continue;
+            }
+
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::microseconds(timeout_micros_);
+            TSParseOptions options = {&deadline, DeadlinePassed};
+            trees_[i] = ts_parser_parse_with_options(parser, nullptr, input.ToTSInput(), options);
+            if (trees_[i] == nullptr) ts_parser_reset(parser);
+        }
+        ts_parser_delete(parser);
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto result = Napi::Array::New(env, trees_.size());
+        for (size_t i = 0; i < trees_.size(); i++) {
+            if (trees_[i] == nullptr) {
+                result.Set(static_cast<uint32_t>(i), env.Null());
+                continue;
+            }
+            result.Set(static_cast<uint32_t>(i),
+                       Tree::New(env, trees_[i], TreeSource::FromString(std::move(sources_[i]))));
+            trees_[i] = nullptr;
+        }
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error &error) override {
+        deferred_.Reject(error.Value());
+    }
+
+  private:
+    static bool DeadlinePassed(TSParseState *state) {
+        auto *deadline = static_cast<std::chrono::steady_clock::time_point *>(state->payload);
+        return std::chrono::steady_clock::now() >= *deadline;
+    }
+
+    Napi::Promise::Deferred deferred_;
+    std::vector<std::u16string> sources_;
+    std::vector<TSTree *> trees_;
+    uint64_t timeout_micros_;
+    TSTactBatchParser *batch_ = nullptr;
+};
+
+Napi::Value ParseBatch(const Napi::CallbackInfo &info) {
+    auto env = info.Env();
+    if (!info[0].IsArray()) {
+        Napi::TypeError::New(env, "Input must be an array of strings").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto array = info[0].As<Napi::Array>();
+    std::vector<std::u16string> sources;
+    sources.reserve(array.Length());
+    for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value value = array.Get(i);
+        if (!value.IsString()) {
+            Napi::TypeError::New(env, "Input must be an array of strings").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        sources.push_back(value.As<Napi::String>().Utf16Value());
+    }
+
+    uint64_t timeout_micros = 0;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Value timeout = info[1].As<Napi::Object>().Get("timeoutMicros");
+        if (timeout.IsNumber()) {
+            timeout_micros = static_cast<uint64_t>(timeout.As<Napi::Number>().Int64Value());
+        }
+    }
+
+    auto *worker = new ParseBatchWorker(env, std::move(sources), timeout_micros);
+    auto promise = worker->Promise();
+    worker->Queue();
+    return promise;
+}
+
+} // namespace
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports["name"] = Napi::String::New(env, "tact");
-    auto language = Napi::External<TSLanguage>::New(env, tree_sitter_tact());
+    auto language = Napi::External<TSLanguage>::New(env, const_cast<TSLanguage *>(tree_sitter_tact()));
     language.TypeTag(&LANGUAGE_TYPE_TAG);
     exports["language"] = language;
+
+    auto *data = new AddonData();
+    auto tree = Tree::Init(env);
+    auto node = Node::Init(env);
+    auto cursor = TreeCursor::Init(env);
+    data->tree = Napi::Persistent(tree);
+    data->node = Napi::Persistent(node);
+    data->cursor = Napi::Persistent(cursor);
+    env.SetInstanceData<AddonData>(data);
+
+    exports["Parser"] = Parser::Init(env);
+    exports["Tree"] = tree;
+    exports["Node"] = node;
+    exports["TreeCursor"] = cursor;
+    exports["Query"] = Query::Init(env);
+    exports["parseBatch"] = Napi::Function::New<ParseBatch>(env, "parseBatch");
     return exports;
 }
 
@@ -3,7 +3,142 @@
 const assert = require("node:assert");
 const { test } = require("node:test");
 
-test("can load grammar", () => {
+const hasTreeSitter = (() => {
+  try {
+    require.resolve("tree-sitter");
+    return true;
+  } catch {
+    return false;
+  }
+})();
+
+// `tree-sitter` is an optional peer, the binding can be built from TREE_SITTER_LIB_DIR.
+test("can load grammar", { skip: !hasTreeSitter && "tree-sitter is not installed" }, () => {
   const parser = new (require("tree-sitter"))();
   assert.doesNotThrow(() => parser.setLanguage(require("./index")));
 });
+
+test("can parse with native parser", () => {
+  const { Parser } = require("./index");
+  const parser = new Parser();
+  const tree = parser.parse("contract Foo { /* ✓ */ a: Int; }");
+  const contract = tree.rootNode.firstChild;
+  assert.strictEqual(contract.type, "contract");
+  assert.strictEqual(contract.childForFieldName("name").text, "Foo");
+  assert.strictEqual(contract.endIndex, 32);
+});
+
+test("can reparse incrementally", () => {
+  const { Parser } = require("./index");
+  const parser = new Parser();
+  const tree = parser.parse("fun foo() {}");
+  tree.edit({
+    startIndex: 8,
+    oldEndIndex: 8,
+    newEndIndex: 14,
+    startPosition: { row: 0, column: 8 },
+    oldEndPosition: { row: 0, column: 8 },
+    newEndPosition: { row: 0, column: 14 },
+  });
+  const newTree = parser.parse("fun foo(a: Int) {}", tree);
+  const params = newTree.rootNode.firstChild.childForFieldName("parameters");
+  assert.strictEqual(params.text, "(a: Int)");
+  assert.ok(tree.getChangedRanges(newTree).length > 0);
+});
+
+test("can parse UTF-8 bytes in place", () => {
+  const { Parser } = require("./index");
+  const source = Buffer.from("contract Foo { /* ✓ */ a: Int; }");
+  const tree = new Parser().parse(source);
+  const contract = tree.rootNode.firstChild;
+  assert.strictEqual(contract.childForFieldName("name").text, "Foo");
+  assert.strictEqual(contract.endIndex, source.length);
+  assert.throws(() => new Parser().parse("contract Foo {}", tree));
+});
+
+test("can parse from a read callback", () => {
+  const { Parser } = require("./index");
+  const chunks = ["contract Foo ", "{ a: Int; ", "}"];
+  const source = chunks.join("");
+  const reads = [];
+  const tree = new Parser().parse((index) => {
+    reads.push(index);
+    let offset = 0;
+    for (const chunk of chunks) {
+      if (index < offset + chunk.length) return chunk.slice(index - offset);
+      offset += chunk.length;
+    }
+    return null;
+  });
+  assert.ok(reads.length >= chunks.length);
+  assert.strictEqual(tree.rootNode.text, source);
+  assert.strictEqual(tree.rootNode.firstChild.childForFieldName("name").text, "Foo");
+  assert.throws(() => new Parser().parse(() => { throw new Error("read failed"); }), /read failed/);
+});
+
+test("can parse a batch in parallel", async () => {
+  const { parseBatch } = require("./index");
+  const sources = Array.from({ length: 32 }, (_, i) => `contract C${i} { a: Int; }`);
+  const trees = await parseBatch(sources);
+  assert.strictEqual(trees.length, sources.length);
+  trees.forEach((tree, i) => {
+    assert.strictEqual(tree.rootNode.firstChild.childForFieldName("name").text, `C${i}`);
+  });
+  assert.deepStrictEqual(await parseBatch([]), []);
+});
+
+test("can cancel parsing", () => {
+  const { Parser } = require("./index");
+  const parser = new Parser();
+  const source = "fun foo() { let a: Int = 1 + 2; }\n".repeat(2000);
+  assert.strictEqual(parser.parse(source, null, { progressCallback: () => true }), null);
+  assert.strictEqual(parser.parse(source, null, { timeoutMicros: 0 }), null);
+  assert.ok(parser.parse(source, null, { progressCallback: () => false }));
+});
+
+test("can serialize a tree", () => {
+  const { Parser } = require("./index");
+  const tree = new Parser().parse("contract Foo {}");
+  const data = tree.serialize(42);
+  assert.strictEqual(Buffer.from(data.subarray(0, 4)).toString("latin1"), "TSTB");
+  assert.strictEqual(data.readUInt32LE(16), tree.rootNode.descendantCount);
+});
+
+test("throws on nodes and cursors of a deleted tree", () => {
+  const { Parser } = require("./index");
+  const tree = new Parser().parse("contract Foo { a: Int; }");
+  const node = tree.rootNode.firstChild;
+  const cursor = tree.walk();
+  tree.delete();
+  assert.throws(() => node.type, /Tree has been deleted/);
+  assert.throws(() => node.parent, /Tree has been deleted/);
+  assert.throws(() => cursor.gotoFirstChild(), /Tree has been deleted/);
+});
+
+test("rejects objects that are not native trees or nodes", () => {
+  const { Parser, Query } = require("./index");
+  const parser = new Parser();
+  const tree = parser.parse("contract Foo {}");
+  const node = tree.rootNode;
+  const fake = { id: node.id, tree, rootNode: node };
+  assert.throws(() => node.equals(fake), TypeError);
+  assert.strictEqual(node.equals(null), false);
+  assert.throws(() => parser.parse("contract Foo {}", fake), TypeError);
+  assert.throws(() => tree.getChangedRanges(fake), TypeError);
+  assert.throws(() => tree.walk().reset(fake), TypeError);
+  assert.throws(() => new Query("(contract) @c").matches(fake), TypeError);
+});
+
+test("evaluates text predicates in queries", () => {
+  const { Parser, Query } = require("./index");
+  const tree = new Parser().parse("contract Foo {}\ncontract Bar {}\ncontract Baz {}");
+  const names = (source) =>
+    new Query(source).captures(tree.rootNode).map((capture) => capture.node.text);
+
+  assert.deepStrictEqual(names('(contract name: (identifier) @name (#eq? @name "Bar"))'), ["Bar"]);
+  assert.deepStrictEqual(names('(contract name: (identifier) @name (#not-eq? @name "Bar"))'), ["Foo", "Baz"]);
+  assert.deepStrictEqual(names('(contract name: (identifier) @name (#match? @name "^Ba"))'), ["Bar", "Baz"]);
+  assert.deepStrictEqual(names('(contract name: (identifier) @name (#any-of? @name "Foo" "Baz"))'), ["Foo", "Baz"]);
+  assert.strictEqual(new Query('(contract name: (identifier) @name (#match? @name "^F"))').matches(tree.rootNode).length, 1);
+  assert.throws(() => new Query('((identifier) @name (#set! kind "x"))'), /Unsupported predicate/);
+});
@@ -18,10 +18,182 @@ type NodeInfo =
       children: ChildNode[];
     });
 
+type Point = {
+  row: number;
+  column: number;
+};
+
+type Range = {
+  startIndex: number;
+  endIndex: number;
+  startPosition: Point;
+  endPosition: Point;
+};
+
+type Edit = {
+  startIndex: number;
+  oldEndIndex: number;
+  newEndIndex: number;
+  startPosition: Point;
+  oldEndPosition: Point;
+  newEndPosition: Point;
+};
+
+// Native counterparts of the `web-tree-sitter` classes with the same surface.
+// Indices and columns are measured in UTF-16 code units, like in `web-tree-sitter`,
+// except in trees parsed from a `Uint8Array` of UTF-8, where they are bytes.
+
+declare class SyntaxNode {
+  readonly id: number;
+  readonly typeId: number;
+  readonly type: string;
+  readonly grammarType: string;
+  readonly isNamed: boolean;
+  readonly isMissing: boolean;
+  readonly isExtra: boolean;
+  readonly isError: boolean;
+  readonly hasError: boolean;
+  readonly hasChanges: boolean;
+  readonly startIndex: number;
+  readonly endIndex: number;
+  readonly startPosition: Point;
+  readonly endPosition: Point;
+  readonly text: string;
+  readonly tree: Tree;
+  readonly parent: SyntaxNode | null;
+  readonly children: SyntaxNode[];
+  readonly namedChildren: SyntaxNode[];
+  readonly childCount: number;
+  readonly namedChildCount: number;
+  readonly descendantCount: number;
+  readonly firstChild: SyntaxNode | null;
+  readonly lastChild: SyntaxNode | null;
+  readonly firstNamedChild: SyntaxNode | null;
+  readonly lastNamedChild: SyntaxNode | null;
+  readonly nextSibling: SyntaxNode | null;
+  readonly previousSibling: SyntaxNode | null;
+  readonly nextNamedSibling: SyntaxNode | null;
+  readonly previousNamedSibling: SyntaxNode | null;
+  child(index: number): SyntaxNode | null;
+  namedChild(index: number): SyntaxNode | null;
+  childForFieldName(fieldName: string): SyntaxNode | null;
+  childrenForFieldName(fieldName: string): SyntaxNode[];
+  fieldNameForChild(index: number): string | null;
+  descendantForIndex(start: number, end?: number): SyntaxNode | null;
+  namedDescendantForIndex(start: number, end?: number): SyntaxNode | null;
+  descendantForPosition(start: Point, end?: Point): SyntaxNode | null;
+  namedDescendantForPosition(start: Point, end?: Point): SyntaxNode | null;
+  equals(other: SyntaxNode): boolean;
+  walk(): TreeCursor;
+  toString(): string;
+}
+
+declare class TreeCursor {
+  readonly currentNode: SyntaxNode;
+  readonly currentFieldName: string | null;
+  readonly nodeType: string;
+  readonly startIndex: number;
+  readonly endIndex: number;
+  gotoFirstChild(): boolean;
+  gotoLastChild(): boolean;
+  gotoNextSibling(): boolean;
+  gotoPreviousSibling(): boolean;
+  gotoParent(): boolean;
+  reset(node: SyntaxNode): void;
+  delete(): void;
+}
+
+declare class Tree {
+  readonly rootNode: SyntaxNode;
+  edit(edit: Edit): void;
+  walk(): TreeCursor;
+  getChangedRanges(other: Tree): Range[];
+  copy(): Tree;
+  /**
+   * Serializes the tree into the binary format described in
+   * `bindings/c/tree-sitter-tact-serialize.h`, with `sourceHash` stored as is.
+   */
+  serialize(sourceHash?: number): Uint8Array;
+  delete(): void;
+}
+
+type ParseState = {
+  currentOffset: number;
+  hasError: boolean;
+};
+
+/**
+ * Reads the input from `index` on, e.g. from the pieces of a rope. Returns an
+ * empty string or `null` at the end of the input. The tree keeps the callback
+ * and calls it again for `SyntaxNode.text`.
+ */
+type ParseCallback = (index: number, position: Point) => string | null | undefined;
+
+type ParseOptions = {
+  /** Called periodically during parsing, return `true` to cancel it. */
+  progressCallback?: (state: ParseState) => boolean;
+  /** Cancels parsing after this many microseconds, without calling into JS. */
+  timeoutMicros?: number;
+};
+
+declare class Parser {
+  constructor();
+  setLanguage(language?: unknown): void;
+  /**
+   * Parses a string, a read callback, or UTF-8 bytes without copying them. The
+   * bytes are kept by the tree for `SyntaxNode.text` and must not be modified
+   * while it is in use. `oldTree` must have been parsed from the same kind of
+   * input. Returns `null` if parsing was cancelled through `options`.
+   */
+  parse(
+    input: string | Uint8Array | ParseCallback,
+    oldTree?: Tree | null,
+    options?: ParseOptions,
+  ): Tree | null;
+  reset(): void;
+  delete(): void;
+}
+
+type QueryCapture = {
+  name: string;
+  patternIndex: number;
+  node: SyntaxNode;
+};
+
+type QueryMatch = {
+  patternIndex: number;
+  captures: QueryCapture[];
+};
+
+/**
+ * A query over Tact trees. Text predicates (`#eq?`, `#match?`, `#any-of?` and
+ * their `not-` and `any-` forms) filter the results like in `web-tree-sitter`.
+ * Other predicates and directives, such as `#set!`, make the constructor throw.
+ */
+declare class Query {
+  constructor(source: string);
+  readonly captureNames: string[];
+  captures(node: SyntaxNode): QueryCapture[];
+  matches(node: SyntaxNode): QueryMatch[];
+}
+
 type Language = {
   name: string;
   language: unknown;
   nodeTypeInfo: NodeInfo[];
+  Parser: typeof Parser;
+  Tree: typeof Tree;
+  Node: typeof SyntaxNode;
+  TreeCursor: typeof TreeCursor;
+  Query: typeof Query;
+  /**
+   * Parses all sources in parallel off the main thread. A tree is `null` if
+   * its source could not be parsed within `options.timeoutMicros`.
+   */
+  parseBatch(
+    sources: readonly string[],
+    options?: Pick<ParseOptions, "timeoutMicros">,
+  ): Promise<(Tree | null)[]>;
 };
 
 declare const language: Language;
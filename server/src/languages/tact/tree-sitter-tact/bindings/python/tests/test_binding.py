@@ -1,11 +1,44 @@
-from unittest import TestCase
+from unittest import TestCase, skipIf, skipUnless
 
-import tree_sitter, tree_sitter_tact
+import tree_sitter_tact
+
+try:
+    import tree_sitter
+except ImportError:
+    tree_sitter = None
+
+
+def has_runtime():
+    try:
+        tree_sitter_tact.parse_many([])
+        return True
+    except NotImplementedError:
+        return False
 
 
 class TestLanguage(TestCase):
+    @skipUnless(tree_sitter is not None, "tree-sitter is not installed")
     def test_can_load_grammar(self):
         try:
             tree_sitter.Language(tree_sitter_tact.language())
         except Exception:
             self.fail("Error loading Tact grammar")
+
+    @skipUnless(has_runtime(), "built without the tree-sitter runtime")
+    def test_can_parse_many(self):
+        sources = [f"contract C{i} {{ a: Int; }}".encode() for i in range(32)]
+        trees = tree_sitter_tact.parse_many(sources)
+        self.assertEqual(len(trees), len(sources))
+        for tree in trees:
+            self.assertTrue(tree.startswith("(source_file (contract"))
+        self.assertEqual(tree_sitter_tact.parse_many([]), [])
+
+    @skipUnless(has_runtime(), "built without the tree-sitter runtime")
+    def test_can_parse_many_serialized(self):
+        (tree,) = tree_sitter_tact.parse_many([b"contract Foo {}"], serialize=True)
+        self.assertEqual(tree[:4], b"TSTB")
+
+    @skipIf(has_runtime(), "built with the tree-sitter runtime")
+    def test_parse_many_without_runtime(self):
+        with self.assertRaisesRegex(NotImplementedError, "TREE_SITTER_LIB_DIR"):
+            tree_sitter_tact.parse_many([b"contract Foo {}"])
@@ -1,5 +1,5 @@
 "Tact grammar for tree-sitter"
 
-from ._binding import language
+from ._binding import language, parse_many
 
-__all__ = ["language"]
+__all__ = ["language", "parse_many"]
@@ -1 +1,13 @@
+from typing import Literal, Optional, Sequence, overload
+
 def language() -> int: ...
+
+# Parse UTF-8 sources on native threads without holding the GIL. Returns the
+# S-expression of each tree, or with `serialize=True` the tree in the binary format
+# of `tree-sitter-tact-serialize.h`, or None if a source could not be parsed.
+# Raises NotImplementedError if the extension was built without the tree-sitter
+# runtime.
+@overload
+def parse_many(sources: Sequence[bytes], *, serialize: Literal[False] = ...) -> list[Optional[str]]: ...
+@overload
+def parse_many(sources: Sequence[bytes], *, serialize: Literal[True]) -> list[Optional[bytes]]: ...
@@ -8,9 +8,167 @@ static PyObject* _binding_language(PyObject *Py_UNUSED(self), PyObject *Py_UNUSE
     return PyCapsule_New(tree_sitter_tact(), "tree_sitter.Language", NULL);
 }
 
+// `parse_many` only works when the extension is built together with the
+// tree-sitter runtime, see TREE_SITTER_LIB_DIR in setup.py. Otherwise it raises
+// NotImplementedError.
+#ifdef TREE_SITTER_TACT_RUNTIME
+
+#include <stdlib.h>
+#include <tree_sitter/api.h>
+#include "tree-sitter-tact-batch.h"
+#include "tree-sitter-tact-serialize.h"
+
+// Shared by all calls, created on the first one. Batches on it are serialized,
+// so calls from several Python threads are safe.
+static TSTactBatchParser *batch_parser = NULL;
+
+// Parse all inputs and turn the trees into S-expressions or serialized trees,
+// without the GIL. Returns false if memory for the trees can't be allocated.
+static bool parse_sources(TSTactBatchInput *inputs, uint32_t count, bool serialize,
+                          char **results, uint32_t *lengths) {
+    TSTree **trees = calloc(count != 0 ? count : 1, sizeof(TSTree *));
+    if (trees == NULL) return false;
+
+    if (batch_parser != NULL) {
+        ts_tact_batch_parse(batch_parser, inputs, count, trees);
+    } else {
+        // No worker threads could be started, parse the sources one by one.
+        TSParser *parser = ts_parser_new();
+        ts_parser_set_language(parser, tree_sitter_tact());
+        for (uint32_t i = 0; i < count; i++) {
+            trees[i] = ts_parser_parse_string(parser, NULL, inputs[i].source, inputs[i].length);
+        }
+        ts_parser_delete(parser);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (trees[i] == NULL) continue;
+        if (serialize) {
+            results[i] = (char *)ts_tact_tree_serialize(trees[i], TSInputEncodingUTF8, 0, &lengths[i]);
+        } else {
+            results[i] = ts_node_string(ts_tree_root_node(trees[i]));
+        }
+        ts_tree_delete(trees[i]);
+    }
+    free(trees);
+    return true;
+}
+
+static PyObject* _binding_parse_many(PyObject *Py_UNUSED(self), PyObject *args, PyObject *kwargs) {
+    static char *keywords[] = {"sources", "serialize", NULL};
+    PyObject *sources;
+    int serialize = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$p", keywords, &sources, &serialize)) {
+        return NULL;
+    }
+
+    // Own the items, the sequence may be mutated while the GIL is released.
+    PyObject *items = PySequence_Tuple(sources);
+    if (items == NULL) return NULL;
+
+    Py_ssize_t size = PyTuple_Size(items);
+    if (size > UINT32_MAX) {
+        Py_DECREF(items);
+        PyErr_SetString(PyExc_OverflowError, "too many sources");
+        return NULL;
+    }
+    uint32_t count = (uint32_t)size;
+
+    TSTactBatchInput *inputs = PyMem_Calloc(count != 0 ? count : 1, sizeof(TSTactBatchInput));
+    char **results = PyMem_Calloc(count != 0 ? count : 1, sizeof(char *));
+    uint32_t *lengths = PyMem_Calloc(count != 0 ? count : 1, sizeof(uint32_t));
+    if (inputs == NULL || results == NULL || lengths == NULL) {
+        PyMem_Free(inputs);
+        PyMem_Free(results);
+        PyMem_Free(lengths);
+        Py_DECREF(items);
+        return PyErr_NoMemory();
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        char *data;
+        Py_ssize_t length;
+        if (PyBytes_AsStringAndSize(PyTuple_GetItem(items, i), &data, &length) < 0 ||
+            length > UINT32_MAX) {
+            if (!PyErr_Occurred()) PyErr_SetString(PyExc_OverflowError, "source is too large");
+            PyMem_Free(inputs);
+            PyMem_Free(results);
+            PyMem_Free(lengths);
+            Py_DECREF(items);
+            return NULL;
+        }
+        inputs[i].source = data;
+        inputs[i].length = (uint32_t)length;
+        inputs[i].encoding = TSInputEncodingUTF8;
+    }
+
+    if (batch_parser == NULL) {
+        batch_parser = ts_tact_batch_parser_new(0);
+    }
+
+    bool parsed;
+    Py_BEGIN_ALLOW_THREADS
+    parsed = parse_sources(inputs, count, serialize, results, lengths);
+    Py_END_ALLOW_THREADS
+
+    if (!parsed) {
+        PyMem_Free(inputs);
+        PyMem_Free(results);
+        PyMem_Free(lengths);
+        Py_DECREF(items);
+        return PyErr_NoMemory();
+    }
+
+    PyObject *result = PyList_New(size);
+    for (uint32_t i = 0; i < count; i++) {
+        PyObject *item;
+        if (result == NULL) {
+            item = NULL;
+        } else if (results[i] != NULL && serialize) {
+            item = PyBytes_FromStringAndSize(results[i], lengths[i]);
+        } else if (results[i] != NULL) {
+            item = PyUnicode_FromString(results[i]);
+        } else {
+            Py_INCREF(Py_None);
+            item = Py_None;
+        }
+        free(results[i]);
+
+        if (result != NULL && item == NULL) {
+            Py_CLEAR(result);
+        } else if (result != NULL) {
+            PyList_SetItem(result, i, item);
+        }
+    }
+
+    PyMem_Free(inputs);
+    PyMem_Free(results);
+    PyMem_Free(lengths);
+    Py_DECREF(items);
+    return result;
+}
+
+#else
+
+static PyObject* _binding_parse_many(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args),
+                                     PyObject *Py_UNUSED(kwargs)) {
+    PyErr_SetString(PyExc_NotImplementedError,
+                    "tree_sitter_tact was built without the tree-sitter runtime, rebuild it with "
+                    "TREE_SITTER_LIB_DIR set to the lib/ directory of the tree-sitter repository "
+                    "to use parse_many");
+    return NULL;
+}
+
+#endif // TREE_SITTER_TACT_RUNTIME
+
 static PyMethodDef methods[] = {
     {"language", _binding_language, METH_NOARGS,
      "Get the tree-sitter language for this grammar."},
+    {"parse_many", (PyCFunction)(void (*)(void))_binding_parse_many, METH_VARARGS | METH_KEYWORDS,
+     "Parse a sequence of UTF-8 sources on native threads, without holding the GIL.\n\n"
+     "Returns the S-expression of each tree, or with serialize=True the tree in the binary\n"
+     "format of tree-sitter-tact-serialize.h, or None if a source could not be parsed.\n"
+     "Raises NotImplementedError if the extension was built without the tree-sitter runtime."},
     {NULL, NULL, 0, NULL}
 };
 
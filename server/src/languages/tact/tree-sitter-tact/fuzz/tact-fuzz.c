@@ -0,0 +1,123 @@
+// Fuzz harness for the Tact grammar, for libFuzzer and AFL++.
+//
+// Besides crashes, it reports inputs that take disproportionately long to
+// parse for their size: the grammar's error recovery on broken `asm` bodies or
+// nested `<{ }>` sequences can go super-linear, and a single such file must not
+// stall the language server. An input fails once parsing it takes longer than
+// TACT_FUZZ_MAX_NS_PER_BYTE per byte (default 20000) and longer than
+// TACT_FUZZ_MIN_NS in total (default 10 ms, to ignore noise on tiny inputs).
+//
+//   tact-fuzz -dict=fuzz/tact.dict CORPUS_DIR test/sample
+//
+// Built with TACT_FUZZ_STANDALONE, it parses the files given as arguments
+// instead, which is handy to reproduce a finding without libFuzzer.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <tree_sitter/api.h>
+#include "tree-sitter-tact.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_MAX_NS_PER_BYTE 20000
+#define DEFAULT_MIN_NS (10 * 1000 * 1000)
+
+static TSParser *parser = NULL;
+static uint64_t max_ns_per_byte = DEFAULT_MAX_NS_PER_BYTE;
+static uint64_t min_ns = DEFAULT_MIN_NS;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t env_or(const char *name, uint64_t fallback) {
+  const char *value = getenv(name);
+  if (value == NULL || *value == '\0') return fallback;
+  return strtoull(value, NULL, 10);
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  (void)argc;
+  (void)argv;
+  parser = ts_parser_new();
+  ts_parser_set_language(parser, tree_sitter_tact());
+  max_ns_per_byte = env_or("TACT_FUZZ_MAX_NS_PER_BYTE", DEFAULT_MAX_NS_PER_BYTE);
+  min_ns = env_or("TACT_FUZZ_MIN_NS", DEFAULT_MIN_NS);
+  return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size > UINT32_MAX) return 0;
+
+  uint64_t start = now_ns();
+  TSTree *tree = ts_parser_parse_string(parser, NULL, (const char *)data, (uint32_t)size);
+  uint64_t elapsed = now_ns() - start;
+
+  if (tree == NULL) {
+    fprintf(stderr, "tact-fuzz: parser returned no tree for %zu bytes\n", size);
+    abort();
+  }
+
+  // Walking the tree touches every node, so a corrupted tree is caught here.
+  TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+  for (;;) {
+    if (ts_tree_cursor_goto_first_child(&cursor)) continue;
+    while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+      if (!ts_tree_cursor_goto_parent(&cursor)) goto done;
+    }
+  }
+done:
+  ts_tree_cursor_delete(&cursor);
+  ts_tree_delete(tree);
+
+  uint64_t per_byte = elapsed / (size != 0 ? size : 1);
+  if (elapsed > min_ns && per_byte > max_ns_per_byte) {
+    fprintf(stderr,
+            "tact-fuzz: super-linear parse, %zu bytes in %.3f ms (%llu ns/byte, limit %llu)\n",
+            size, (double)elapsed / 1e6, (unsigned long long)per_byte,
+            (unsigned long long)max_ns_per_byte);
+    abort();
+  }
+  return 0;
+}
+
+#ifdef TACT_FUZZ_STANDALONE
+int main(int argc, char **argv) {
+  LLVMFuzzerInitialize(&argc, &argv);
+  for (int i = 1; i < argc; i++) {
+    FILE *file = fopen(argv[i], "rb");
+    if (file == NULL) {
+      fprintf(stderr, "cannot read %s\n", argv[i]);
+      return 1;
+    }
+
+    size_t capacity = 4096;
+    size_t size = 0;
+    uint8_t *data = malloc(capacity);
+    size_t read;
+    while (data != NULL && (read = fread(data + size, 1, capacity - size, file)) > 0) {
+      size += read;
+      if (size == capacity) {
+        capacity *= 2;
+        data = realloc(data, capacity);
+      }
+    }
+    fclose(file);
+    if (data == NULL) {
+      fprintf(stderr, "out of memory\n");
+      return 1;
+    }
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    printf("%s: ok\n", argv[i]);
+  }
+  ts_parser_delete(parser);
+  return 0;
+}
+#endif
@@ -0,0 +1,99 @@
+#!/usr/bin/env node
+// Parser throughput benchmark for a tree-sitter-tact WASM build, printing the
+// same JSON as bench/tact-parse-bench.c so scripts/pgo-report.js can compare
+// both:
+//
+//   node scripts/bench-wasm.js [--iterations N] [--sizes KiB,KiB,...] tree-sitter-tact.wasm
+
+const fs = require("node:fs");
+const path = require("node:path");
+const { Parser, Language } = require("web-tree-sitter");
+
+const grammarDir = path.join(__dirname, "..");
+
+function parseArgs(argv) {
+  const options = { iterations: 20, sizes: [64, 1024, 8192], wasm: null };
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i] === "--iterations") {
+      options.iterations = Math.max(1, Number(argv[++i]));
+    } else if (argv[i] === "--sizes") {
+      options.sizes = argv[++i].split(",").map(Number).filter((kib) => kib > 0);
+    } else {
+      options.wasm = argv[i];
+    }
+  }
+  if (options.wasm === null) {
+    console.error("usage: bench-wasm.js [--iterations N] [--sizes KiB,KiB,...] grammar.wasm");
+    process.exit(1);
+  }
+  return options;
+}
+
+// The source part of every test in the corpus, between the `===` header and
+// the `---` separator.
+function loadCorpus() {
+  const corpusDir = path.join(grammarDir, "test", "corpus");
+  let result = "";
+  for (const name of fs.readdirSync(corpusDir).filter((name) => name.endsWith(".txt"))) {
+    let state = "skip";
+    for (const line of fs.readFileSync(path.join(corpusDir, name), "utf8").split("\n")) {
+      if (line.startsWith("===")) {
+        state = state === "header" ? "source" : "header";
+      } else if (state === "source" && line.startsWith("---")) {
+        state = "skip";
+      } else if (state === "source") {
+        result += line + "\n";
+      }
+    }
+  }
+  return result;
+}
+
+function bench(parser, name, input, iterations) {
+  let seconds = 0;
+  let nodes = 0;
+  for (let i = 0; i < iterations; i++) {
+    const start = process.hrtime.bigint();
+    const tree = parser.parse(input);
+    seconds += Number(process.hrtime.bigint() - start) / 1e9;
+    nodes += tree.rootNode.descendantCount;
+    tree.delete();
+  }
+
+  const bytes = Buffer.byteLength(input);
+  return {
+    name,
+    mode: "full",
+    bytes,
+    iterations,
+    seconds,
+    mb_per_s: (bytes * iterations) / (1024 * 1024) / seconds,
+    nodes_per_s: nodes / seconds,
+  };
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+
+  await Parser.init();
+  const parser = new Parser();
+  parser.setLanguage(await Language.load(options.wasm));
+
+  const corpus = loadCorpus();
+  const sample = fs.readFileSync(path.join(grammarDir, "test", "sample", "example.tact"), "utf8");
+
+  const results = [
+    bench(parser, "corpus", corpus, options.iterations),
+    bench(parser, "example.tact", sample, options.iterations),
+  ];
+  for (const kib of options.sizes) {
+    let input = "";
+    while (input.length < kib * 1024) input += corpus + sample;
+    const iterations = Math.max(1, Math.floor((options.iterations * 64) / Math.max(kib, 64)));
+    results.push(bench(parser, `synthetic-${kib}KiB`, input, iterations));
+  }
+
+  console.log(JSON.stringify({ results, peak_rss_kb: Math.round(process.resourceUsage().maxRSS) }, null, 2));
+}
+
+main();
@@ -0,0 +1,32 @@
+#!/usr/bin/env node
+// Runs `tree-sitter generate` followed by scripts/perfect-hash-keywords.js, so
+// src/parser.c never ends up with the generated keyword lexer. Arguments are
+// passed on to `tree-sitter generate`.
+//
+// Use this instead of a plain `tree-sitter generate`; every script that
+// regenerates the parser (package.json, Makefile, CMakeLists.txt and the
+// `grammar:tact` scripts of the language server) goes through it.
+
+const { spawnSync } = require("node:child_process");
+const path = require("node:path");
+
+const grammarDir = path.join(__dirname, "..");
+
+function run(command, args) {
+  const result = spawnSync(command, args, {
+    cwd: grammarDir,
+    stdio: "inherit",
+    // `tree-sitter` is a .cmd shim on Windows
+    shell: process.platform === "win32",
+  });
+  if (result.error) {
+    console.error(`Cannot run ${command}: ${result.error.message}`);
+    process.exit(1);
+  }
+  if (result.status !== 0) {
+    process.exit(result.status ?? 1);
+  }
+}
+
+run(process.env.TREE_SITTER_CLI || "tree-sitter", ["generate", ...process.argv.slice(2)]);
+run(process.execPath, [path.join(__dirname, "perfect-hash-keywords.js")]);
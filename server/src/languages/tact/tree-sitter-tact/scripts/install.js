@@ -0,0 +1,39 @@
+#!/usr/bin/env node
+// `install` script of the package: loads a prebuild or an existing build of the
+// native binding, and otherwise builds it with node-gyp.
+//
+// The binding compiles the tree-sitter runtime in, which comes from the optional
+// `tree-sitter` peer or TREE_SITTER_LIB_DIR. Without either, the build is skipped
+// with a warning instead of failing the install: the grammar itself (src/,
+// queries/, the WASM build) doesn't need the binding, and `require` of the
+// package then fails with node-gyp-build's "No native build was found" error.
+
+const { spawnSync } = require("node:child_process");
+const path = require("node:path");
+const { treeSitterLibDir } = require("./tree-sitter-lib-dir");
+
+const root = path.join(__dirname, "..");
+
+function hasBuild() {
+  try {
+    require("node-gyp-build").resolve(root);
+    return true;
+  } catch {
+    return false;
+  }
+}
+
+if (!hasBuild()) {
+  if (treeSitterLibDir() === null) {
+    console.warn(
+      "tree-sitter-tact: no prebuilt native binding for this platform and no " +
+        "tree-sitter runtime to build one, skipping the native build. Install the " +
+        "tree-sitter package (^0.25.0) or set TREE_SITTER_LIB_DIR to build it.",
+    );
+    process.exit(0);
+  }
+
+  const bin = require.resolve("node-gyp-build/bin.js");
+  const result = spawnSync(process.execPath, [bin], { cwd: root, stdio: "inherit" });
+  process.exit(result.status ?? 1);
+}
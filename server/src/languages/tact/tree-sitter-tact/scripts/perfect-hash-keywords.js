@@ -0,0 +1,237 @@
+#!/usr/bin/env node
+// Replaces the keyword lexer generated by `tree-sitter generate` in src/parser.c
+// with a perfect-hash lookup emitted into src/keywords.h.
+//
+// The generated `ts_lex_keywords` is a character-by-character state machine that
+// runs on every identifier. The replacement scans the identifier once, rejects it
+// as soon as it is longer than any keyword, and otherwise finds the only candidate
+// keyword with a collision-free hash and a single comparison.
+//
+// scripts/generate.js runs it after every `tree-sitter generate`; running it twice
+// is a no-op.
+// With `--check`, only verifies that src/parser.c was processed and exits with 1
+// otherwise, so a plain `tree-sitter generate` doesn't slip back the old lexer.
+
+const fs = require("node:fs");
+const path = require("node:path");
+
+const srcDir = path.join(__dirname, "..", "src");
+const parserPath = path.join(srcDir, "parser.c");
+const keywordsPath = path.join(srcDir, "keywords.h");
+
+const TYPE_IDENTIFIER = "sym__type_identifier";
+
+function extractKeywordLexer(source) {
+  const start = source.indexOf("static bool ts_lex_keywords(TSLexer *lexer, TSStateId state) {");
+  if (start === -1) return null;
+
+  // The function ends with `default: return false; } }` at the top level.
+  const endMarker = "\n    default:\n      return false;\n  }\n}\n";
+  const end = source.indexOf(endMarker, start);
+  if (end === -1) {
+    throw new Error("cannot find the end of ts_lex_keywords in parser.c");
+  }
+  return { start, end: end + endMarker.length, body: source.slice(start, end) };
+}
+
+function symbolNames(source) {
+  const names = new Map();
+  const start = source.indexOf("static const char * const ts_symbol_names[] = {");
+  const end = source.indexOf("};", start);
+  const pattern = /\[(\w+)\] = "((?:[^"\\]|\\.)*)"/g;
+  for (const match of source.slice(start, end).matchAll(pattern)) {
+    names.set(match[1], match[2]);
+  }
+  return names;
+}
+
+function collectKeywords(body, names) {
+  const symbols = new Set();
+  for (const match of body.matchAll(/ACCEPT_TOKEN\((\w+)\)/g)) {
+    symbols.add(match[1]);
+  }
+  if (!symbols.delete(TYPE_IDENTIFIER)) {
+    throw new Error(`ts_lex_keywords doesn't produce ${TYPE_IDENTIFIER} anymore`);
+  }
+
+  const keywords = [...symbols].map((symbol) => {
+    const text = names.get(symbol);
+    if (text === undefined || !/^[a-z][a-zA-Z0-9_]*$/.test(text)) {
+      throw new Error(`unexpected keyword ${symbol}: ${text}`);
+    }
+    return { symbol, text };
+  });
+  return keywords.sort((a, b) => a.text.localeCompare(b.text));
+}
+
+function hash(text, params) {
+  const first = text.charCodeAt(0);
+  const second = text.charCodeAt(1 % text.length);
+  const last = text.charCodeAt(text.length - 1);
+  return (
+    (first * params.a + second * params.b + last * params.c + text.length) &
+    (params.size - 1)
+  );
+}
+
+function findParams(keywords) {
+  for (let size = 64; size <= 1024; size *= 2) {
+    for (let a = 1; a < 64; a++) {
+      for (let b = 0; b < 64; b++) {
+        for (let c = 0; c < 64; c++) {
+          const params = { size, a, b, c };
+          const seen = new Set();
+          let ok = true;
+          for (const keyword of keywords) {
+            const value = hash(keyword.text, params);
+            if (seen.has(value)) {
+              ok = false;
+              break;
+            }
+            seen.add(value);
+          }
+          if (ok) return params;
+        }
+      }
+    }
+  }
+  throw new Error("cannot find a perfect hash for the keywords");
+}
+
+function render(keywords, params) {
+  const maxLength = Math.max(...keywords.map((keyword) => keyword.text.length));
+  const table = new Array(params.size).fill(null);
+  for (const keyword of keywords) {
+    table[hash(keyword.text, params)] = keyword;
+  }
+
+  const entries = table
+    .map((keyword, index) =>
+      keyword === null
+        ? null
+        : `  [${index}] = {"${keyword.text}", ${keyword.text.length}, ${keyword.symbol}},`,
+    )
+    .filter((line) => line !== null)
+    .join("\n");
+
+  return `// Generated by scripts/perfect-hash-keywords.js, do not edit.
+//
+// Included by parser.c in place of the generated keyword lexer, so it sees the
+// symbol enum and the lexer macros.
+
+#ifndef TREE_SITTER_TACT_KEYWORDS_H_
+#define TREE_SITTER_TACT_KEYWORDS_H_
+
+#include <string.h>
+
+#define TACT_KEYWORD_COUNT ${keywords.length}
+#define TACT_KEYWORD_MAX_LENGTH ${maxLength}
+#define TACT_KEYWORD_TABLE_SIZE ${params.size}
+
+typedef struct {
+  const char *text;
+  uint8_t length;
+  TSSymbol symbol;
+} TactKeyword;
+
+static const TactKeyword tact_keywords[TACT_KEYWORD_TABLE_SIZE] = {
+${entries}
+};
+
+static inline uint32_t tact_keyword_hash(const char *text, uint32_t length) {
+  uint32_t first = (uint8_t)text[0];
+  uint32_t second = (uint8_t)text[length > 1 ? 1 : 0];
+  uint32_t last = (uint8_t)text[length - 1];
+  return (first * ${params.a} + second * ${params.b} + last * ${params.c} + length) &
+         (TACT_KEYWORD_TABLE_SIZE - 1);
+}
+
+static inline bool tact_is_identifier_char(int32_t c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_';
+}
+
+// Called by the runtime at the start of every \`identifier\` token, see
+// \`keyword_capture_token\`. Identifiers starting with an uppercase letter are
+// type identifiers, everything else is either a keyword or rejected.
+static bool ts_lex_keywords(TSLexer *lexer, TSStateId state) {
+  (void)state;
+
+  if ('A' <= lexer->lookahead && lexer->lookahead <= 'Z') {
+    while (tact_is_identifier_char(lexer->lookahead)) {
+      lexer->advance(lexer, false);
+    }
+    lexer->result_symbol = ${TYPE_IDENTIFIER};
+    lexer->mark_end(lexer);
+    return true;
+  }
+
+  char text[TACT_KEYWORD_MAX_LENGTH];
+  uint32_t length = 0;
+  while (tact_is_identifier_char(lexer->lookahead)) {
+    if (length == TACT_KEYWORD_MAX_LENGTH) return false;
+    text[length++] = (char)lexer->lookahead;
+    lexer->advance(lexer, false);
+  }
+  if (length == 0) return false;
+
+  const TactKeyword *keyword = &tact_keywords[tact_keyword_hash(text, length)];
+  if (keyword->length != length || memcmp(keyword->text, text, length) != 0) {
+    return false;
+  }
+
+  lexer->result_symbol = keyword->symbol;
+  lexer->mark_end(lexer);
+  return true;
+}
+
+#endif // TREE_SITTER_TACT_KEYWORDS_H_
+`;
+}
+
+const INCLUDE = '#include "keywords.h"';
+
+function check(source) {
+  if (extractKeywordLexer(source) !== null || !source.includes(INCLUDE)) {
+    console.error(
+      "src/parser.c still has the generated keyword lexer, regenerate it with `node scripts/generate.js`",
+    );
+    process.exit(1);
+  }
+  if (!fs.existsSync(keywordsPath)) {
+    console.error("src/keywords.h is missing, regenerate the parser");
+    process.exit(1);
+  }
+  console.log("parser.c uses the perfect-hash keyword lexer");
+}
+
+function main() {
+  const source = fs.readFileSync(parserPath, "utf8");
+  if (process.argv.includes("--check")) {
+    check(source);
+    return;
+  }
+
+  const lexer = extractKeywordLexer(source);
+  if (lexer === null) {
+    if (source.includes(INCLUDE)) {
+      console.log("parser.c already uses the perfect-hash keyword lexer");
+      return;
+    }
+    throw new Error("cannot find ts_lex_keywords in parser.c");
+  }
+
+  const keywords = collectKeywords(lexer.body, symbolNames(source));
+  const params = findParams(keywords);
+
+  fs.writeFileSync(keywordsPath, render(keywords, params));
+  fs.writeFileSync(
+    parserPath,
+    source.slice(0, lexer.start) + INCLUDE + "\n" + source.slice(lexer.end),
+  );
+
+  console.log(
+    `Replaced ts_lex_keywords with a perfect hash of ${keywords.length} keywords (table size ${params.size})`,
+  );
+}
+
+main();
@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+# Builds tree-sitter-tact with profile-guided optimization and LTO, optimizes
+# the WASM artifact with wasm-opt, and writes a report comparing both against
+# the default build.
+#
+#   scripts/pgo-build.sh [build-dir]
+#
+# Steps:
+#   1. default Release build of the grammar and tact-parse-bench, as a baseline;
+#   2. instrumented build, trained by running tact-parse-bench, which parses the
+#      test corpus, test/sample/example.tact and synthetic inputs built from them;
+#   3. the same build directory rebuilt with the profile and LTO;
+#   4. tree-sitter-tact.wasm rebuilt and run through `wasm-opt -O3 --enable-simd`;
+#   5. both pairs benchmarked and compared in <build-dir>/pgo-report.md.
+#
+# Needs the tree-sitter runtime (found with pkg-config), tree-sitter CLI for the
+# WASM build, wasm-opt from binaryen, and llvm-profdata when building with Clang.
+# Set TACT_PGO_SKIP_WASM=1 to only build the native library.
+
+set -euo pipefail
+
+cd "$(dirname "$0")/.."
+GRAMMAR_DIR="$PWD"
+BUILD_DIR="$(mkdir -p "${1:-build-pgo}" && cd "${1:-build-pgo}" && pwd)"
+PROFILE_DIR="$BUILD_DIR/profile"
+ITERATIONS="${TACT_PGO_ITERATIONS:-20}"
+
+configure() {
+  cmake -S "$GRAMMAR_DIR" -B "$1" -DCMAKE_BUILD_TYPE=Release -DBUILD_SHARED_LIBS=OFF \
+    -DTACT_PGO_DIR="$PROFILE_DIR" "${@:2}" >/dev/null
+}
+
+bench() {
+  "$1/tact-parse-bench" --iterations "$ITERATIONS" "$GRAMMAR_DIR"
+}
+
+echo "[1/5] default build"
+configure "$BUILD_DIR/default"
+cmake --build "$BUILD_DIR/default" --target tact-parse-bench -j
+
+echo "[2/5] instrumented build and training run"
+rm -rf "$PROFILE_DIR" "$BUILD_DIR/pgo"
+mkdir -p "$PROFILE_DIR"
+configure "$BUILD_DIR/pgo" -DTACT_PGO=GENERATE -DTACT_LTO=OFF
+cmake --build "$BUILD_DIR/pgo" --target tact-parse-bench -j
+LLVM_PROFILE_FILE="$PROFILE_DIR/tact-%p.profraw" bench "$BUILD_DIR/pgo" >/dev/null
+
+if compgen -G "$PROFILE_DIR/*.profraw" >/dev/null; then
+  llvm-profdata merge -output="$PROFILE_DIR/tact.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+echo "[3/5] optimized build"
+configure "$BUILD_DIR/pgo" -DTACT_PGO=USE -DTACT_LTO=ON
+cmake --build "$BUILD_DIR/pgo" --target tact-parse-bench -j --clean-first
+
+echo "[4/5] benchmarks"
+bench "$BUILD_DIR/default" >"$BUILD_DIR/native-default.json"
+bench "$BUILD_DIR/pgo" >"$BUILD_DIR/native-pgo.json"
+
+report_args=(
+  --native "$BUILD_DIR/native-default.json" "$BUILD_DIR/native-pgo.json"
+  --size "$BUILD_DIR/default/libtree-sitter-tact.a" "$BUILD_DIR/pgo/libtree-sitter-tact.a"
+)
+
+if [ "${TACT_PGO_SKIP_WASM:-0}" != "1" ]; then
+  echo "[5/5] WASM build"
+  tree-sitter build --wasm -o "$BUILD_DIR/tree-sitter-tact.wasm"
+  wasm-opt -O3 --enable-simd --enable-bulk-memory \
+    "$BUILD_DIR/tree-sitter-tact.wasm" -o "$BUILD_DIR/tree-sitter-tact.opt.wasm"
+
+  node scripts/bench-wasm.js --iterations "$ITERATIONS" "$BUILD_DIR/tree-sitter-tact.wasm" \
+    >"$BUILD_DIR/wasm-default.json"
+  node scripts/bench-wasm.js --iterations "$ITERATIONS" "$BUILD_DIR/tree-sitter-tact.opt.wasm" \
+    >"$BUILD_DIR/wasm-opt.json"
+
+  report_args+=(
+    --wasm "$BUILD_DIR/wasm-default.json" "$BUILD_DIR/wasm-opt.json"
+    --size "$BUILD_DIR/tree-sitter-tact.wasm" "$BUILD_DIR/tree-sitter-tact.opt.wasm"
+  )
+fi
+
+node scripts/pgo-report.js "${report_args[@]}" >"$BUILD_DIR/pgo-report.md"
+cat "$BUILD_DIR/pgo-report.md"
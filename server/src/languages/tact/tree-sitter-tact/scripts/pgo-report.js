@@ -0,0 +1,91 @@
+#!/usr/bin/env node
+// Renders the Markdown report of scripts/pgo-build.sh from benchmark results in
+// the JSON format of bench/tact-parse-bench.c:
+//
+//   node scripts/pgo-report.js [--native default.json optimized.json]
+//     [--wasm default.json optimized.json] [--size default-file optimized-file]...
+
+const fs = require("node:fs");
+const path = require("node:path");
+
+function parseArgs(argv) {
+  const options = { native: null, wasm: null, sizes: [] };
+  for (let i = 0; i < argv.length; i += 3) {
+    const pair = [argv[i + 1], argv[i + 2]];
+    if (pair.some((file) => file === undefined)) {
+      throw new Error(`${argv[i]} expects two files`);
+    }
+    if (argv[i] === "--native") options.native = pair;
+    else if (argv[i] === "--wasm") options.wasm = pair;
+    else if (argv[i] === "--size") options.sizes.push(pair);
+    else throw new Error(`unknown option ${argv[i]}`);
+  }
+  return options;
+}
+
+function readResults(file) {
+  return JSON.parse(fs.readFileSync(file, "utf8"));
+}
+
+function percent(before, after) {
+  const change = ((after - before) / before) * 100;
+  return `${change >= 0 ? "+" : ""}${change.toFixed(1)}%`;
+}
+
+function throughputTable(title, [defaultFile, optimizedFile], optimizedName) {
+  const before = readResults(defaultFile);
+  const after = readResults(optimizedFile);
+
+  const lines = [
+    `## ${title}`,
+    "",
+    `| input | mode | default MB/s | ${optimizedName} MB/s | change |`,
+    "| --- | --- | ---: | ---: | ---: |",
+  ];
+  for (const result of after.results) {
+    const baseline = before.results.find(
+      (other) => other.name === result.name && other.mode === result.mode,
+    );
+    if (baseline === undefined) continue;
+    lines.push(
+      `| ${result.name} | ${result.mode} | ${baseline.mb_per_s.toFixed(2)} | ` +
+        `${result.mb_per_s.toFixed(2)} | ${percent(baseline.mb_per_s, result.mb_per_s)} |`,
+    );
+  }
+  lines.push(
+    "",
+    `Peak RSS: ${before.peak_rss_kb} KiB default, ${after.peak_rss_kb} KiB ${optimizedName}.`,
+    "",
+  );
+  return lines;
+}
+
+function sizeTable(sizes) {
+  const lines = ["## Artifact size", "", "| artifact | default | optimized | change |", "| --- | ---: | ---: | ---: |"];
+  for (const [before, after] of sizes) {
+    const beforeSize = fs.statSync(before).size;
+    const afterSize = fs.statSync(after).size;
+    lines.push(
+      `| ${path.basename(before)} | ${beforeSize} | ${afterSize} | ${percent(beforeSize, afterSize)} |`,
+    );
+  }
+  lines.push("");
+  return lines;
+}
+
+function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const lines = ["# tree-sitter-tact optimized build report", ""];
+  if (options.native) {
+    lines.push(...throughputTable("Native: PGO + LTO", options.native, "PGO+LTO"));
+  }
+  if (options.wasm) {
+    lines.push(...throughputTable("WASM: wasm-opt -O3 with SIMD", options.wasm, "wasm-opt"));
+  }
+  if (options.sizes.length > 0) {
+    lines.push(...sizeTable(options.sizes));
+  }
+  console.log(lines.join("\n"));
+}
+
+main();
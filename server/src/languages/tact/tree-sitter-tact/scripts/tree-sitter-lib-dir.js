@@ -0,0 +1,45 @@
+#!/usr/bin/env node
+// Prints the directory of the tree-sitter runtime (`lib/` of the tree-sitter
+// repository) the native binding is compiled against, for binding.gyp.
+//
+// TREE_SITTER_LIB_DIR wins, otherwise the copy vendored by the `tree-sitter`
+// Node package (the optional peer dependency, 0.25 or newer) is used.
+
+const fs = require("node:fs");
+const path = require("node:path");
+
+function candidateDir() {
+  if (process.env.TREE_SITTER_LIB_DIR) {
+    return process.env.TREE_SITTER_LIB_DIR;
+  }
+  try {
+    const pkg = require.resolve("tree-sitter/package.json");
+    return path.join(path.dirname(pkg), "vendor", "tree-sitter", "lib");
+  } catch {
+    return null;
+  }
+}
+
+/** The runtime directory, or `null` if there is no runtime to build against. */
+function treeSitterLibDir() {
+  const dir = candidateDir();
+  if (dir === null || !fs.existsSync(path.join(dir, "src", "lib.c"))) {
+    return null;
+  }
+  return dir;
+}
+
+module.exports = { treeSitterLibDir };
+
+if (require.main === module) {
+  const dir = treeSitterLibDir();
+  if (dir === null) {
+    console.error(
+      "tree-sitter-tact: the tree-sitter runtime was not found. Install the " +
+        "tree-sitter package (^0.25.0) next to this one, or point " +
+        "TREE_SITTER_LIB_DIR to the lib/ directory of the tree-sitter repository.",
+    );
+    process.exit(1);
+  }
+  process.stdout.write(dir);
+}
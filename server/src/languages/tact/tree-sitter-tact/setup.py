@@ -1,5 +1,7 @@
-from os.path import isdir, join
+from os import environ
+from os.path import isdir, isfile, join
 from platform import system
+from warnings import warn
 
 from setuptools import Extension, find_packages, setup
 from setuptools.command.build import build
@@ -22,6 +24,29 @@ class BdistWheel(bdist_wheel):
         return python, abi, platform
 
 
+# `parse_many` needs the tree-sitter runtime compiled into the extension. It is
+# taken from TREE_SITTER_LIB_DIR (`lib/` of the tree-sitter repository), or the
+# copy vendored by the `tree-sitter` Node package, like in binding.gyp.
+runtime_dir = environ.get("TREE_SITTER_LIB_DIR")
+if runtime_dir is not None and not isfile(join(runtime_dir, "src", "lib.c")):
+    raise SystemExit(f"TREE_SITTER_LIB_DIR={runtime_dir} has no src/lib.c of the tree-sitter runtime")
+runtime_dir = runtime_dir or join("node_modules", "tree-sitter", "vendor", "tree-sitter", "lib")
+runtime_sources, runtime_macros, runtime_include_dirs = [], [], []
+if not isfile(join(runtime_dir, "src", "lib.c")):
+    warn(
+        f"tree-sitter runtime not found in {runtime_dir}, building without parse_many; "
+        "set TREE_SITTER_LIB_DIR to the lib/ directory of the tree-sitter repository"
+    )
+else:
+    runtime_sources = [
+        join(runtime_dir, "src", "lib.c"),
+        "bindings/c/tree-sitter-tact-batch.c",
+        "bindings/c/tree-sitter-tact-serialize.c",
+    ]
+    runtime_macros = [("TREE_SITTER_TACT_RUNTIME", None)]
+    runtime_include_dirs = [join(runtime_dir, "include"), join(runtime_dir, "src"), "bindings/c"]
+
+
 setup(
     packages=find_packages("bindings/python"),
     package_dir={"": "bindings/python"},
@@ -37,15 +62,17 @@ setup(
                 "bindings/python/tree_sitter_tact/binding.c",
                 "src/parser.c",
                 # NOTE: if your language uses an external scanner, add it here.
+                *runtime_sources,
             ],
             extra_compile_args=(
                 ["-std=c11"] if system() != 'Windows' else []
             ),
             define_macros=[
                 ("Py_LIMITED_API", "0x03080000"),
-                ("PY_SSIZE_T_CLEAN", None)
+                ("PY_SSIZE_T_CLEAN", None),
+                *runtime_macros,
             ],
-            include_dirs=["src"],
+            include_dirs=["src", *runtime_include_dirs],
             py_limited_api=True,
         )
     ],
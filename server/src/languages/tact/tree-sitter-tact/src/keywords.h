@@ -0,0 +1,113 @@
+// Generated by scripts/perfect-hash-keywords.js, do not edit.
+//
+// Included by parser.c in place of the generated keyword lexer, so it sees the
+// symbol enum and the lexer macros.
+
+#ifndef TREE_SITTER_TACT_KEYWORDS_H_
+#define TREE_SITTER_TACT_KEYWORDS_H_
+
+#include <string.h>
+
+#define TACT_KEYWORD_COUNT 43
+#define TACT_KEYWORD_MAX_LENGTH 9
+#define TACT_KEYWORD_TABLE_SIZE 128
+
+typedef struct {
+  const char *text;
+  uint8_t length;
+  TSSymbol symbol;
+} TactKeyword;
+
+static const TactKeyword tact_keywords[TACT_KEYWORD_TABLE_SIZE] = {
+  [9] = {"map", 3, anon_sym_map},
+  [14] = {"override", 8, anon_sym_override},
+  [15] = {"if", 2, anon_sym_if},
+  [18] = {"self", 4, sym_self},
+  [20] = {"until", 5, anon_sym_until},
+  [21] = {"while", 5, anon_sym_while},
+  [24] = {"mutates", 7, anon_sym_mutates},
+  [25] = {"catch", 5, anon_sym_catch},
+  [27] = {"get", 3, anon_sym_get},
+  [28] = {"foreach", 7, anon_sym_foreach},
+  [31] = {"trait", 5, anon_sym_trait},
+  [32] = {"let", 3, anon_sym_let},
+  [36] = {"bounced", 7, anon_sym_bounced},
+  [38] = {"else", 4, anon_sym_else},
+  [39] = {"set", 3, anon_sym_set},
+  [41] = {"repeat", 6, anon_sym_repeat},
+  [43] = {"extends", 7, anon_sym_extends},
+  [46] = {"try", 3, anon_sym_try},
+  [49] = {"struct", 6, anon_sym_struct},
+  [62] = {"inline", 6, anon_sym_inline},
+  [63] = {"in", 2, anon_sym_in},
+  [69] = {"false", 5, anon_sym_false},
+  [72] = {"asm", 3, anon_sym_asm},
+  [75] = {"null", 4, sym_null},
+  [78] = {"native", 6, anon_sym_native},
+  [91] = {"initOf", 6, anon_sym_initOf},
+  [94] = {"codeOf", 6, anon_sym_codeOf},
+  [96] = {"do", 2, anon_sym_do},
+  [97] = {"external", 8, anon_sym_external},
+  [104] = {"import", 6, anon_sym_import},
+  [106] = {"virtual", 7, anon_sym_virtual},
+  [107] = {"true", 4, anon_sym_true},
+  [108] = {"primitive", 9, anon_sym_primitive},
+  [111] = {"init", 4, anon_sym_init},
+  [114] = {"message", 7, anon_sym_message},
+  [115] = {"const", 5, anon_sym_const},
+  [116] = {"with", 4, anon_sym_with},
+  [117] = {"as", 2, anon_sym_as},
+  [118] = {"contract", 8, anon_sym_contract},
+  [119] = {"receive", 7, anon_sym_receive},
+  [123] = {"return", 6, anon_sym_return},
+  [124] = {"fun", 3, anon_sym_fun},
+  [127] = {"abstract", 8, anon_sym_abstract},
+};
+
+static inline uint32_t tact_keyword_hash(const char *text, uint32_t length) {
+  uint32_t first = (uint8_t)text[0];
+  uint32_t second = (uint8_t)text[length > 1 ? 1 : 0];
+  uint32_t last = (uint8_t)text[length - 1];
+  return (first * 1 + second * 9 + last * 29 + length) &
+         (TACT_KEYWORD_TABLE_SIZE - 1);
+}
+
+static inline bool tact_is_identifier_char(int32_t c) {
+  return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_';
+}
+
+// Called by the runtime at the start of every `identifier` token, see
+// `keyword_capture_token`. Identifiers starting with an uppercase letter are
+// type identifiers, everything else is either a keyword or rejected.
+static bool ts_lex_keywords(TSLexer *lexer, TSStateId state) {
+  (void)state;
+
+  if ('A' <= lexer->lookahead && lexer->lookahead <= 'Z') {
+    while (tact_is_identifier_char(lexer->lookahead)) {
+      lexer->advance(lexer, false);
+    }
+    lexer->result_symbol = sym__type_identifier;
+    lexer->mark_end(lexer);
+    return true;
+  }
+
+  char text[TACT_KEYWORD_MAX_LENGTH];
+  uint32_t length = 0;
+  while (tact_is_identifier_char(lexer->lookahead)) {
+    if (length == TACT_KEYWORD_MAX_LENGTH) return false;
+    text[length++] = (char)lexer->lookahead;
+    lexer->advance(lexer, false);
+  }
+  if (length == 0) return false;
+
+  const TactKeyword *keyword = &tact_keywords[tact_keyword_hash(text, length)];
+  if (keyword->length != length || memcmp(keyword->text, text, length) != 0) {
+    return false;
+  }
+
+  lexer->result_symbol = keyword->symbol;
+  lexer->mark_end(lexer);
+  return true;
+}
+
+#endif // TREE_SITTER_TACT_KEYWORDS_H_
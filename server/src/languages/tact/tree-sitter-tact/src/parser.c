@@ -4435,611 +4435,7 @@ static bool ts_lex(TSLexer *lexer, TSStateId state) {
   }
 }
 
-static bool ts_lex_keywords(TSLexer *lexer, TSStateId state) {
-  START_LEXER();
-  eof = lexer->eof(lexer);
-  switch (state) {
-    case 0:
-      ADVANCE_MAP(
-        'a', 1,
-        'b', 2,
-        'c', 3,
-        'd', 4,
-        'e', 5,
-        'f', 6,
-        'g', 7,
-        'i', 8,
-        'l', 9,
-        'm', 10,
-        'n', 11,
-        'o', 12,
-        'p', 13,
-        'r', 14,
-        's', 15,
-        't', 16,
-        'u', 17,
-        'v', 18,
-        'w', 19,
-      );
-      if (('\t' <= lookahead && lookahead <= '\r') ||
-          lookahead == ' ') SKIP(0);
-      if (('A' <= lookahead && lookahead <= 'Z')) ADVANCE(20);
-      END_STATE();
-    case 1:
-      if (lookahead == 'b') ADVANCE(21);
-      if (lookahead == 's') ADVANCE(22);
-      END_STATE();
-    case 2:
-      if (lookahead == 'o') ADVANCE(23);
-      END_STATE();
-    case 3:
-      if (lookahead == 'a') ADVANCE(24);
-      if (lookahead == 'o') ADVANCE(25);
-      END_STATE();
-    case 4:
-      if (lookahead == 'o') ADVANCE(26);
-      END_STATE();
-    case 5:
-      if (lookahead == 'l') ADVANCE(27);
-      if (lookahead == 'x') ADVANCE(28);
-      END_STATE();
-    case 6:
-      if (lookahead == 'a') ADVANCE(29);
-      if (lookahead == 'o') ADVANCE(30);
-      if (lookahead == 'u') ADVANCE(31);
-      END_STATE();
-    case 7:
-      if (lookahead == 'e') ADVANCE(32);
-      END_STATE();
-    case 8:
-      if (lookahead == 'f') ADVANCE(33);
-      if (lookahead == 'm') ADVANCE(34);
-      if (lookahead == 'n') ADVANCE(35);
-      END_STATE();
-    case 9:
-      if (lookahead == 'e') ADVANCE(36);
-      END_STATE();
-    case 10:
-      if (lookahead == 'a') ADVANCE(37);
-      if (lookahead == 'e') ADVANCE(38);
-      if (lookahead == 'u') ADVANCE(39);
-      END_STATE();
-    case 11:
-      if (lookahead == 'a') ADVANCE(40);
-      if (lookahead == 'u') ADVANCE(41);
-      END_STATE();
-    case 12:
-      if (lookahead == 'v') ADVANCE(42);
-      END_STATE();
-    case 13:
-      if (lookahead == 'r') ADVANCE(43);
-      END_STATE();
-    case 14:
-      if (lookahead == 'e') ADVANCE(44);
-      END_STATE();
-    case 15:
-      if (lookahead == 'e') ADVANCE(45);
-      if (lookahead == 't') ADVANCE(46);
-      END_STATE();
-    case 16:
-      if (lookahead == 'r') ADVANCE(47);
-      END_STATE();
-    case 17:
-      if (lookahead == 'n') ADVANCE(48);
-      END_STATE();
-    case 18:
-      if (lookahead == 'i') ADVANCE(49);
-      END_STATE();
-    case 19:
-      if (lookahead == 'h') ADVANCE(50);
-      if (lookahead == 'i') ADVANCE(51);
-      END_STATE();
-    case 20:
-      ACCEPT_TOKEN(sym__type_identifier);
-      if (('0' <= lookahead && lookahead <= '9') ||
-          ('A' <= lookahead && lookahead <= 'Z') ||
-          lookahead == '_' ||
-          ('a' <= lookahead && lookahead <= 'z')) ADVANCE(20);
-      END_STATE();
-    case 21:
-      if (lookahead == 's') ADVANCE(52);
-      END_STATE();
-    case 22:
-      ACCEPT_TOKEN(anon_sym_as);
-      if (lookahead == 'm') ADVANCE(53);
-      END_STATE();
-    case 23:
-      if (lookahead == 'u') ADVANCE(54);
-      END_STATE();
-    case 24:
-      if (lookahead == 't') ADVANCE(55);
-      END_STATE();
-    case 25:
-      if (lookahead == 'd') ADVANCE(56);
-      if (lookahead == 'n') ADVANCE(57);
-      END_STATE();
-    case 26:
-      ACCEPT_TOKEN(anon_sym_do);
-      END_STATE();
-    case 27:
-      if (lookahead == 's') ADVANCE(58);
-      END_STATE();
-    case 28:
-      if (lookahead == 't') ADVANCE(59);
-      END_STATE();
-    case 29:
-      if (lookahead == 'l') ADVANCE(60);
-      END_STATE();
-    case 30:
-      if (lookahead == 'r') ADVANCE(61);
-      END_STATE();
-    case 31:
-      if (lookahead == 'n') ADVANCE(62);
-      END_STATE();
-    case 32:
-      if (lookahead == 't') ADVANCE(63);
-      END_STATE();
-    case 33:
-      ACCEPT_TOKEN(anon_sym_if);
-      END_STATE();
-    case 34:
-      if (lookahead == 'p') ADVANCE(64);
-      END_STATE();
-    case 35:
-      ACCEPT_TOKEN(anon_sym_in);
-      if (lookahead == 'i') ADVANCE(65);
-      if (lookahead == 'l') ADVANCE(66);
-      END_STATE();
-    case 36:
-      if (lookahead == 't') ADVANCE(67);
-      END_STATE();
-    case 37:
-      if (lookahead == 'p') ADVANCE(68);
-      END_STATE();
-    case 38:
-      if (lookahead == 's') ADVANCE(69);
-      END_STATE();
-    case 39:
-      if (lookahead == 't') ADVANCE(70);
-      END_STATE();
-    case 40:
-      if (lookahead == 't') ADVANCE(71);
-      END_STATE();
-    case 41:
-      if (lookahead == 'l') ADVANCE(72);
-      END_STATE();
-    case 42:
-      if (lookahead == 'e') ADVANCE(73);
-      END_STATE();
-    case 43:
-      if (lookahead == 'i') ADVANCE(74);
-      END_STATE();
-    case 44:
-      if (lookahead == 'c') ADVANCE(75);
-      if (lookahead == 'p') ADVANCE(76);
-      if (lookahead == 't') ADVANCE(77);
-      END_STATE();
-    case 45:
-      if (lookahead == 'l') ADVANCE(78);
-      if (lookahead == 't') ADVANCE(79);
-      END_STATE();
-    case 46:
-      if (lookahead == 'r') ADVANCE(80);
-      END_STATE();
-    case 47:
-      if (lookahead == 'a') ADVANCE(81);
-      if (lookahead == 'u') ADVANCE(82);
-      if (lookahead == 'y') ADVANCE(83);
-      END_STATE();
-    case 48:
-      if (lookahead == 't') ADVANCE(84);
-      END_STATE();
-    case 49:
-      if (lookahead == 'r') ADVANCE(85);
-      END_STATE();
-    case 50:
-      if (lookahead == 'i') ADVANCE(86);
-      END_STATE();
-    case 51:
-      if (lookahead == 't') ADVANCE(87);
-      END_STATE();
-    case 52:
-      if (lookahead == 't') ADVANCE(88);
-      END_STATE();
-    case 53:
-      ACCEPT_TOKEN(anon_sym_asm);
-      END_STATE();
-    case 54:
-      if (lookahead == 'n') ADVANCE(89);
-      END_STATE();
-    case 55:
-      if (lookahead == 'c') ADVANCE(90);
-      END_STATE();
-    case 56:
-      if (lookahead == 'e') ADVANCE(91);
-      END_STATE();
-    case 57:
-      if (lookahead == 's') ADVANCE(92);
-      if (lookahead == 't') ADVANCE(93);
-      END_STATE();
-    case 58:
-      if (lookahead == 'e') ADVANCE(94);
-      END_STATE();
-    case 59:
-      if (lookahead == 'e') ADVANCE(95);
-      END_STATE();
-    case 60:
-      if (lookahead == 's') ADVANCE(96);
-      END_STATE();
-    case 61:
-      if (lookahead == 'e') ADVANCE(97);
-      END_STATE();
-    case 62:
-      ACCEPT_TOKEN(anon_sym_fun);
-      END_STATE();
-    case 63:
-      ACCEPT_TOKEN(anon_sym_get);
-      END_STATE();
-    case 64:
-      if (lookahead == 'o') ADVANCE(98);
-      END_STATE();
-    case 65:
-      if (lookahead == 't') ADVANCE(99);
-      END_STATE();
-    case 66:
-      if (lookahead == 'i') ADVANCE(100);
-      END_STATE();
-    case 67:
-      ACCEPT_TOKEN(anon_sym_let);
-      END_STATE();
-    case 68:
-      ACCEPT_TOKEN(anon_sym_map);
-      END_STATE();
-    case 69:
-      if (lookahead == 's') ADVANCE(101);
-      END_STATE();
-    case 70:
-      if (lookahead == 'a') ADVANCE(102);
-      END_STATE();
-    case 71:
-      if (lookahead == 'i') ADVANCE(103);
-      END_STATE();
-    case 72:
-      if (lookahead == 'l') ADVANCE(104);
-      END_STATE();
-    case 73:
-      if (lookahead == 'r') ADVANCE(105);
-      END_STATE();
-    case 74:
-      if (lookahead == 'm') ADVANCE(106);
-      END_STATE();
-    case 75:
-      if (lookahead == 'e') ADVANCE(107);
-      END_STATE();
-    case 76:
-      if (lookahead == 'e') ADVANCE(108);
-      END_STATE();
-    case 77:
-      if (lookahead == 'u') ADVANCE(109);
-      END_STATE();
-    case 78:
-      if (lookahead == 'f') ADVANCE(110);
-      END_STATE();
-    case 79:
-      ACCEPT_TOKEN(anon_sym_set);
-      END_STATE();
-    case 80:
-      if (lookahead == 'u') ADVANCE(111);
-      END_STATE();
-    case 81:
-      if (lookahead == 'i') ADVANCE(112);
-      END_STATE();
-    case 82:
-      if (lookahead == 'e') ADVANCE(113);
-      END_STATE();
-    case 83:
-      ACCEPT_TOKEN(anon_sym_try);
-      END_STATE();
-    case 84:
-      if (lookahead == 'i') ADVANCE(114);
-      END_STATE();
-    case 85:
-      if (lookahead == 't') ADVANCE(115);
-      END_STATE();
-    case 86:
-      if (lookahead == 'l') ADVANCE(116);
-      END_STATE();
-    case 87:
-      if (lookahead == 'h') ADVANCE(117);
-      END_STATE();
-    case 88:
-      if (lookahead == 'r') ADVANCE(118);
-      END_STATE();
-    case 89:
-      if (lookahead == 'c') ADVANCE(119);
-      END_STATE();
-    case 90:
-      if (lookahead == 'h') ADVANCE(120);
-      END_STATE();
-    case 91:
-      if (lookahead == 'O') ADVANCE(121);
-      END_STATE();
-    case 92:
-      if (lookahead == 't') ADVANCE(122);
-      END_STATE();
-    case 93:
-      if (lookahead == 'r') ADVANCE(123);
-      END_STATE();
-    case 94:
-      ACCEPT_TOKEN(anon_sym_else);
-      END_STATE();
-    case 95:
-      if (lookahead == 'n') ADVANCE(124);
-      if (lookahead == 'r') ADVANCE(125);
-      END_STATE();
-    case 96:
-      if (lookahead == 'e') ADVANCE(126);
-      END_STATE();
-    case 97:
-      if (lookahead == 'a') ADVANCE(127);
-      END_STATE();
-    case 98:
-      if (lookahead == 'r') ADVANCE(128);
-      END_STATE();
-    case 99:
-      ACCEPT_TOKEN(anon_sym_init);
-      if (lookahead == 'O') ADVANCE(129);
-      END_STATE();
-    case 100:
-      if (lookahead == 'n') ADVANCE(130);
-      END_STATE();
-    case 101:
-      if (lookahead == 'a') ADVANCE(131);
-      END_STATE();
-    case 102:
-      if (lookahead == 't') ADVANCE(132);
-      END_STATE();
-    case 103:
-      if (lookahead == 'v') ADVANCE(133);
-      END_STATE();
-    case 104:
-      ACCEPT_TOKEN(sym_null);
-      END_STATE();
-    case 105:
-      if (lookahead == 'r') ADVANCE(134);
-      END_STATE();
-    case 106:
-      if (lookahead == 'i') ADVANCE(135);
-      END_STATE();
-    case 107:
-      if (lookahead == 'i') ADVANCE(136);
-      END_STATE();
-    case 108:
-      if (lookahead == 'a') ADVANCE(137);
-      END_STATE();
-    case 109:
-      if (lookahead == 'r') ADVANCE(138);
-      END_STATE();
-    case 110:
-      ACCEPT_TOKEN(sym_self);
-      END_STATE();
-    case 111:
-      if (lookahead == 'c') ADVANCE(139);
-      END_STATE();
-    case 112:
-      if (lookahead == 't') ADVANCE(140);
-      END_STATE();
-    case 113:
-      ACCEPT_TOKEN(anon_sym_true);
-      END_STATE();
-    case 114:
-      if (lookahead == 'l') ADVANCE(141);
-      END_STATE();
-    case 115:
-      if (lookahead == 'u') ADVANCE(142);
-      END_STATE();
-    case 116:
-      if (lookahead == 'e') ADVANCE(143);
-      END_STATE();
-    case 117:
-      ACCEPT_TOKEN(anon_sym_with);
-      END_STATE();
-    case 118:
-      if (lookahead == 'a') ADVANCE(144);
-      END_STATE();
-    case 119:
-      if (lookahead == 'e') ADVANCE(145);
-      END_STATE();
-    case 120:
-      ACCEPT_TOKEN(anon_sym_catch);
-      END_STATE();
-    case 121:
-      if (lookahead == 'f') ADVANCE(146);
-      END_STATE();
-    case 122:
-      ACCEPT_TOKEN(anon_sym_const);
-      END_STATE();
-    case 123:
-      if (lookahead == 'a') ADVANCE(147);
-      END_STATE();
-    case 124:
-      if (lookahead == 'd') ADVANCE(148);
-      END_STATE();
-    case 125:
-      if (lookahead == 'n') ADVANCE(149);
-      END_STATE();
-    case 126:
-      ACCEPT_TOKEN(anon_sym_false);
-      END_STATE();
-    case 127:
-      if (lookahead == 'c') ADVANCE(150);
-      END_STATE();
-    case 128:
-      if (lookahead == 't') ADVANCE(151);
-      END_STATE();
-    case 129:
-      if (lookahead == 'f') ADVANCE(152);
-      END_STATE();
-    case 130:
-      if (lookahead == 'e') ADVANCE(153);
-      END_STATE();
-    case 131:
-      if (lookahead == 'g') ADVANCE(154);
-      END_STATE();
-    case 132:
-      if (lookahead == 'e') ADVANCE(155);
-      END_STATE();
-    case 133:
-      if (lookahead == 'e') ADVANCE(156);
-      END_STATE();
-    case 134:
-      if (lookahead == 'i') ADVANCE(157);
-      END_STATE();
-    case 135:
-      if (lookahead == 't') ADVANCE(158);
-      END_STATE();
-    case 136:
-      if (lookahead == 'v') ADVANCE(159);
-      END_STATE();
-    case 137:
-      if (lookahead == 't') ADVANCE(160);
-      END_STATE();
-    case 138:
-      if (lookahead == 'n') ADVANCE(161);
-      END_STATE();
-    case 139:
-      if (lookahead == 't') ADVANCE(162);
-      END_STATE();
-    case 140:
-      ACCEPT_TOKEN(anon_sym_trait);
-      END_STATE();
-    case 141:
-      ACCEPT_TOKEN(anon_sym_until);
-      END_STATE();
-    case 142:
-      if (lookahead == 'a') ADVANCE(163);
-      END_STATE();
-    case 143:
-      ACCEPT_TOKEN(anon_sym_while);
-      END_STATE();
-    case 144:
-      if (lookahead == 'c') ADVANCE(164);
-      END_STATE();
-    case 145:
-      if (lookahead == 'd') ADVANCE(165);
-      END_STATE();
-    case 146:
-      ACCEPT_TOKEN(anon_sym_codeOf);
-      END_STATE();
-    case 147:
-      if (lookahead == 'c') ADVANCE(166);
-      END_STATE();
-    case 148:
-      if (lookahead == 's') ADVANCE(167);
-      END_STATE();
-    case 149:
-      if (lookahead == 'a') ADVANCE(168);
-      END_STATE();
-    case 150:
-      if (lookahead == 'h') ADVANCE(169);
-      END_STATE();
-    case 151:
-      ACCEPT_TOKEN(anon_sym_import);
-      END_STATE();
-    case 152:
-      ACCEPT_TOKEN(anon_sym_initOf);
-      END_STATE();
-    case 153:
-      ACCEPT_TOKEN(anon_sym_inline);
-      END_STATE();
-    case 154:
-      if (lookahead == 'e') ADVANCE(170);
-      END_STATE();
-    case 155:
-      if (lookahead == 's') ADVANCE(171);
-      END_STATE();
-    case 156:
-      ACCEPT_TOKEN(anon_sym_native);
-      END_STATE();
-    case 157:
-      if (lookahead == 'd') ADVANCE(172);
-      END_STATE();
-    case 158:
-      if (lookahead == 'i') ADVANCE(173);
-      END_STATE();
-    case 159:
-      if (lookahead == 'e') ADVANCE(174);
-      END_STATE();
-    case 160:
-      ACCEPT_TOKEN(anon_sym_repeat);
-      END_STATE();
-    case 161:
-      ACCEPT_TOKEN(anon_sym_return);
-      END_STATE();
-    case 162:
-      ACCEPT_TOKEN(anon_sym_struct);
-      END_STATE();
-    case 163:
-      if (lookahead == 'l') ADVANCE(175);
-      END_STATE();
-    case 164:
-      if (lookahead == 't') ADVANCE(176);
-      END_STATE();
-    case 165:
-      ACCEPT_TOKEN(anon_sym_bounced);
-      END_STATE();
-    case 166:
-      if (lookahead == 't') ADVANCE(177);
-      END_STATE();
-    case 167:
-      ACCEPT_TOKEN(anon_sym_extends);
-      END_STATE();
-    case 168:
-      if (lookahead == 'l') ADVANCE(178);
-      END_STATE();
-    case 169:
-      ACCEPT_TOKEN(anon_sym_foreach);
-      END_STATE();
-    case 170:
-      ACCEPT_TOKEN(anon_sym_message);
-      END_STATE();
-    case 171:
-      ACCEPT_TOKEN(anon_sym_mutates);
-      END_STATE();
-    case 172:
-      if (lookahead == 'e') ADVANCE(179);
-      END_STATE();
-    case 173:
-      if (lookahead == 'v') ADVANCE(180);
-      END_STATE();
-    case 174:
-      ACCEPT_TOKEN(anon_sym_receive);
-      END_STATE();
-    case 175:
-      ACCEPT_TOKEN(anon_sym_virtual);
-      END_STATE();
-    case 176:
-      ACCEPT_TOKEN(anon_sym_abstract);
-      END_STATE();
-    case 177:
-      ACCEPT_TOKEN(anon_sym_contract);
-      END_STATE();
-    case 178:
-      ACCEPT_TOKEN(anon_sym_external);
-      END_STATE();
-    case 179:
-      ACCEPT_TOKEN(anon_sym_override);
-      END_STATE();
-    case 180:
-      if (lookahead == 'e') ADVANCE(181);
-      END_STATE();
-    case 181:
-      ACCEPT_TOKEN(anon_sym_primitive);
-      END_STATE();
-    default:
-      return false;
-  }
-}
+#include "keywords.h"
 
 static const TSLexerMode ts_lex_modes[STATE_COUNT] = {
   [0] = {.lex_state = 0},
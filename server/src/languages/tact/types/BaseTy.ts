@@ -16,6 +16,7 @@ import type {
 import {NamedNode} from "@server/languages/tact/psi/TactNode"
 import {trimPrefix} from "@server/utils/strings"
 import {TypeInferer} from "@server/languages/tact/TypeInferer"
+import type {File} from "@server/psi/File"
 
 export interface Ty {
     name(): string
@@ -23,6 +24,9 @@ export interface Ty {
     qualifiedName(): string
 
     sizeOf(visited: Map<string, SizeOf>): SizeOf
+
+    /** Files declaring this type and the types it is made of. */
+    sources(): File[]
 }
 
 export abstract class BaseTy<Anchor extends NamedNode> implements Ty {
@@ -43,6 +47,10 @@ export abstract class BaseTy<Anchor extends NamedNode> implements Ty {
     }
 
     public abstract sizeOf(_visited: Map<string, SizeOf>): SizeOf
+
+    public sources(): File[] {
+        return this.anchor ? [this.anchor.file] : []
+    }
 }
 
 export interface SizeOf {
@@ -118,7 +126,7 @@ export class PrimitiveTy extends BaseTy<Primitive> {
     public constructor(
         name: string,
         anchor: Primitive | null,
-        public tlb: string | null,
+        public readonly tlb: string | null,
     ) {
         super(name, anchor)
     }
@@ -242,6 +250,10 @@ export class BouncedTy implements Ty {
     public sizeOf(_visited: Map<string, SizeOf>): SizeOf {
         return this.innerTy.sizeOf(_visited)
     }
+
+    public sources(): File[] {
+        return this.innerTy.sources()
+    }
 }
 
 export class OptionTy implements Ty {
@@ -259,6 +271,10 @@ export class OptionTy implements Ty {
         const innerSizeOf = this.innerTy.sizeOf(_visited)
         return mergeSizes(innerSizeOf, {fixed: 1, floating: 0, valid: true}) // 1 bit for null/not-null
     }
+
+    public sources(): File[] {
+        return this.innerTy.sources()
+    }
 }
 
 export class MapTy implements Ty {
@@ -278,6 +294,10 @@ export class MapTy implements Ty {
     public sizeOf(_visited: Map<string, SizeOf>): SizeOf {
         return {fixed: 0, floating: 0, valid: false} // we don't know the size of the map
     }
+
+    public sources(): File[] {
+        return [...this.keyTy.sources(), ...this.valueTy.sources()]
+    }
 }
 
 export class NullTy implements Ty {
@@ -292,9 +312,130 @@ export class NullTy implements Ty {
     public sizeOf(_visited: Map<string, SizeOf>): SizeOf {
         return {fixed: 0, floating: 0, valid: true}
     }
+
+    public sources(): File[] {
+        return []
+    }
 }
 
 export function unwrapBounced(ty: Ty): Ty {
     if (ty instanceof BouncedTy) return ty.innerTy
     return ty
 }
+
+/**
+ * Whether `a` and `b` are the same type. Types from `TYPES` are checked by
+ * identity first, names are only compared for types interned for different
+ * trees, like a struct of the previous version of a file that is still
+ * referenced by a type inferred before the file changed.
+ */
+export function sameTy(a: Ty, b: Ty): boolean {
+    return a === b || a.qualifiedName() === b.qualifiedName()
+}
+
+/**
+ * Hands out a single instance of each type, so inferring a type again allocates
+ * nothing and types of the same trees can be compared by identity, see `sameTy`.
+ *
+ * Types declared in a file are kept per file object and go away together with
+ * it, types made of other types are kept in weak maps keyed by their parts.
+ */
+export class TypeInterner {
+    public readonly nullTy: NullTy = new NullTy()
+
+    private readonly declared: WeakMap<File, Map<string, Ty>> = new WeakMap()
+    private readonly options: WeakMap<Ty, OptionTy> = new WeakMap()
+    private readonly bouncedTypes: WeakMap<Ty, BouncedTy> = new WeakMap()
+    private readonly maps: WeakMap<Ty, WeakMap<Ty, MapTy>> = new WeakMap()
+    // Primitives without a declaration, by qualified name, there are only a few.
+    private readonly unanchored: Map<string, PrimitiveTy> = new Map()
+
+    public struct(anchor: Struct): StructTy {
+        return this.declaredTy("struct", anchor, () => new StructTy(anchor.name(), anchor))
+    }
+
+    public message(anchor: Message): MessageTy {
+        return this.declaredTy("message", anchor, () => new MessageTy(anchor.name(), anchor))
+    }
+
+    public trait(anchor: Trait): TraitTy {
+        return this.declaredTy("trait", anchor, () => new TraitTy(anchor.name(), anchor))
+    }
+
+    public contract(anchor: Contract): ContractTy {
+        return this.declaredTy("contract", anchor, () => new ContractTy(anchor.name(), anchor))
+    }
+
+    public primitive(anchor: Primitive, tlb: string | null = null): PrimitiveTy {
+        return this.declaredTy(`primitive ${tlb}`, anchor, () =>
+            new PrimitiveTy(anchor.name(), anchor, tlb),
+        )
+    }
+
+    /** Type parameter like `K` of `map<K, V>`, anchored at its use. */
+    public placeholder(anchor: NamedNode): PlaceholderTy {
+        return this.declaredTy("placeholder", anchor, () =>
+            new PlaceholderTy(anchor.node.text, anchor),
+        )
+    }
+
+    /** `ty` serialized as `tlb`, like `Int as uint8`. */
+    public withTlb(ty: PrimitiveTy, tlb: string): PrimitiveTy {
+        if (ty.tlb === tlb) return ty
+        if (ty.anchor !== null) return this.primitive(ty.anchor, tlb)
+
+        const key = `${ty.name()} as ${tlb}`
+        const existing = this.unanchored.get(key)
+        if (existing) return existing
+        const created = new PrimitiveTy(ty.name(), null, tlb)
+        this.unanchored.set(key, created)
+        return created
+    }
+
+    public option(inner: Ty): OptionTy {
+        const existing = this.options.get(inner)
+        if (existing) return existing
+        const created = new OptionTy(inner)
+        this.options.set(inner, created)
+        return created
+    }
+
+    public bounced(inner: Ty): BouncedTy {
+        const existing = this.bouncedTypes.get(inner)
+        if (existing) return existing
+        const created = new BouncedTy(inner)
+        this.bouncedTypes.set(inner, created)
+        return created
+    }
+
+    public map(key: Ty, value: Ty): MapTy {
+        let byValue = this.maps.get(key)
+        if (!byValue) {
+            byValue = new WeakMap()
+            this.maps.set(key, byValue)
+        }
+        const existing = byValue.get(value)
+        if (existing) return existing
+        const created = new MapTy(key, value)
+        byValue.set(value, created)
+        return created
+    }
+
+    private declaredTy<T extends Ty>(kind: string, anchor: NamedNode, create: () => T): T {
+        let types = this.declared.get(anchor.file)
+        if (!types) {
+            types = new Map()
+            this.declared.set(anchor.file, types)
+        }
+
+        // the kind of a declaration doesn't change within a tree, so this is always a `T`
+        const key = `${kind} ${anchor.node.id}`
+        const existing = types.get(key) as T | undefined
+        if (existing) return existing
+        const created = create()
+        types.set(key, created)
+        return created
+    }
+}
+
+export const TYPES: TypeInterner = new TypeInterner()
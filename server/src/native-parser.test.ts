@@ -0,0 +1,238 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {Parser, Language} from "web-tree-sitter"
+import type {Edit, Node as SyntaxNode, Point, Tree} from "web-tree-sitter"
+import {createRequire} from "node:module"
+import {existsSync, readFileSync} from "node:fs"
+import * as path from "node:path"
+import type {NativeTactBinding} from "./parser"
+import {SerializedTree} from "./serialized-tree"
+import type {SerializedNode} from "./serialized-tree"
+
+// Compares the native addon with web-tree-sitter on the same inputs. Runs when
+// both the addon (`yarn grammar:tact:native`) and the WASM grammar
+// (`yarn grammar:tact:wasm`) are built, and is skipped otherwise. CI sets
+// TACT_REQUIRE_NATIVE_PARSER so that a missing build fails instead.
+
+const grammarDir = path.join(__dirname, "languages/tact/tree-sitter-tact")
+const addonPath = path.join(grammarDir, "build/Release/tree_sitter_tact_binding.node")
+const grammarWasmPath = path.join(grammarDir, "tree-sitter-tact.wasm")
+const runtimeWasmPath = path.join(__dirname, "../../node_modules/web-tree-sitter/tree-sitter.wasm")
+
+const available = [addonPath, grammarWasmPath, runtimeWasmPath].every(file => existsSync(file))
+if (!available && process.env["TACT_REQUIRE_NATIVE_PARSER"] === "true") {
+    throw new Error(`Build ${addonPath} and ${grammarWasmPath} to run the native parser tests`)
+}
+const describeNative = available ? describe : describe.skip
+
+const sources: Record<string, string> = {
+    "example.tact": readFileSync(path.join(grammarDir, "test/sample/example.tact"), "utf8"),
+    "stubs.tact": readFileSync(path.join(__dirname, "languages/tact/stubs/stubs.tact"), "utf8"),
+    "non-ascii":
+        'contract Foo {\n    // ✓ 𝄞 ünïcödé\n    get fun s(): String { return "𝄞✓"; }\n}\n',
+    "errors": "contract Foo { fun bar( { let x: Int = ; }\nasm fun f() { ONE <{ TWO }> }\n",
+}
+
+function describeNode(node: SyntaxNode): object {
+    return {
+        type: node.type,
+        isNamed: node.isNamed,
+        isMissing: node.isMissing,
+        isExtra: node.isExtra,
+        hasError: node.hasError,
+        startIndex: node.startIndex,
+        endIndex: node.endIndex,
+        startPosition: node.startPosition,
+        endPosition: node.endPosition,
+        text: node.text,
+        childCount: node.childCount,
+        namedChildCount: node.namedChildCount,
+        fields: node.children.map((_, i) => node.fieldNameForChild(i)),
+    }
+}
+
+// Properties of a node kept by the binary tree format.
+function describeSerializable(node: SyntaxNode | SerializedNode, fieldName: string | null): object {
+    return {
+        type: node.type,
+        fieldName,
+        isNamed: node.isNamed,
+        isMissing: node.isMissing,
+        isExtra: node.isExtra,
+        hasError: node.hasError,
+        startIndex: node.startIndex,
+        endIndex: node.endIndex,
+    }
+}
+
+// Row and UTF-16 column of `index` in `text`, like the positions of both runtimes.
+function pointAt(text: string, index: number): Point {
+    const before = text.slice(0, index)
+    const lineStart = before.lastIndexOf("\n") + 1
+    return {row: before.split("\n").length - 1, column: index - lineStart}
+}
+
+interface TextEdit {
+    readonly start: number
+    readonly deleted: number
+    readonly inserted: string
+}
+
+// Applies `edit` to `text` and returns the new text and the tree edit for it.
+function applyEdit(text: string, edit: TextEdit): [string, Edit] {
+    const newText =
+        text.slice(0, edit.start) + edit.inserted + text.slice(edit.start + edit.deleted)
+    const oldEnd = edit.start + edit.deleted
+    const newEnd = edit.start + edit.inserted.length
+    return [
+        newText,
+        {
+            startIndex: edit.start,
+            oldEndIndex: oldEnd,
+            newEndIndex: newEnd,
+            startPosition: pointAt(text, edit.start),
+            oldEndPosition: pointAt(text, oldEnd),
+            newEndPosition: pointAt(newText, newEnd),
+        },
+    ]
+}
+
+// Edits around and after non-ASCII text, so that byte offsets and UTF-16
+// offsets differ on every edit, including astral characters (surrogate pairs).
+const EDITED_SOURCE =
+    'contract Foo {\n    // ✓ 𝄞 ünïcödé\n    a: Int = 1;\n    get fun s(): String { return "𝄞✓"; }\n}\n'
+const EDITS: ((text: string) => TextEdit)[] = [
+    text => ({start: text.indexOf("a: Int"), deleted: 1, inserted: "ä𝄞"}),
+    text => ({start: text.indexOf("1;"), deleted: 1, inserted: "1 + 2"}),
+    text => ({start: text.indexOf("✓"), deleted: "✓ 𝄞".length, inserted: ""}),
+    text => ({
+        start: text.indexOf("}\n}"),
+        deleted: 0,
+        inserted: "\n    fun f(x: Int) { let y = x * 2; }",
+    }),
+    text => ({start: text.indexOf("return"), deleted: "return".length, inserted: "retur"}),
+    text => ({start: text.indexOf("retur"), deleted: "retur".length, inserted: "return"}),
+    text => ({start: 0, deleted: 0, inserted: "// 𝄞\n"}),
+    text => ({
+        start: text.indexOf("contract"),
+        deleted: text.length - text.indexOf("contract"),
+        inserted: "",
+    }),
+]
+
+/** Every node of `tree` in pre-order, with the properties the server reads. */
+function flatten(tree: Tree): object[] {
+    const result: object[] = []
+    const visit = (node: SyntaxNode): void => {
+        result.push(describeNode(node))
+        for (const child of node.children) {
+            if (child) visit(child)
+        }
+    }
+    visit(tree.rootNode)
+    return result
+}
+
+describeNative("native parser", () => {
+    let binding: NativeTactBinding
+    let native: Parser
+    let wasm: Parser
+
+    beforeAll(async () => {
+        await Parser.init({locateFile: () => runtimeWasmPath})
+        wasm = new Parser()
+        wasm.setLanguage(await Language.load(grammarWasmPath))
+
+        binding = createRequire(__filename)(addonPath) as NativeTactBinding
+        native = new binding.Parser() as unknown as Parser
+    })
+
+    for (const [name, source] of Object.entries(sources)) {
+        it(`should produce the same tree as web-tree-sitter for ${name}`, () => {
+            const nativeTree = native.parse(source)
+            const wasmTree = wasm.parse(source)
+            if (!nativeTree || !wasmTree) throw new Error("parse failed")
+
+            expect(flatten(nativeTree)).toEqual(flatten(wasmTree))
+            expect(nativeTree.rootNode.toString()).toBe(wasmTree.rootNode.toString())
+        })
+
+        it(`should find the same descendants by position in ${name}`, () => {
+            const nativeTree = native.parse(source)
+            const wasmTree = wasm.parse(source)
+            if (!nativeTree || !wasmTree) throw new Error("parse failed")
+
+            const lines = source.split("\n")
+            for (const [row, line] of lines.entries()) {
+                for (let column = 0; column <= line.length; column += 3) {
+                    const point = {row, column}
+                    const fromNative = nativeTree.rootNode.descendantForPosition(point)
+                    const fromWasm = wasmTree.rootNode.descendantForPosition(point)
+                    expect(fromNative && describeNode(fromNative)).toEqual(
+                        fromWasm && describeNode(fromWasm),
+                    )
+                }
+            }
+        })
+
+        it(`should serialize ${name} into trees SerializedTree reads`, () => {
+            const tree = new binding.Parser().parse(source)
+            if (!tree) throw new Error("parse failed")
+
+            const serialized = SerializedTree.read(tree.serialize(42))
+            expect(serialized.sourceHash).toBe(42n)
+            expect(serialized.isUtf16).toBe(true)
+
+            const expected: object[] = []
+            const visit = (node: SyntaxNode, fieldName: string | null): void => {
+                expected.push(describeSerializable(node, fieldName))
+                for (const [i, child] of node.children.entries()) {
+                    if (child) visit(child, node.fieldNameForChild(i))
+                }
+            }
+            visit(tree.rootNode as unknown as SyntaxNode, null)
+
+            const actual: object[] = []
+            serialized.visit(0, node => {
+                actual.push(describeSerializable(node, node.fieldName))
+                return true
+            })
+
+            expect(actual).toEqual(expected)
+            expect(serialized.rootNode?.text(source)).toBe(tree.rootNode.text)
+        })
+    }
+
+    it("should produce the same trees and changed ranges as web-tree-sitter after edits", () => {
+        let text = EDITED_SOURCE
+        let nativeTree = native.parse(text)
+        let wasmTree = wasm.parse(text)
+        if (!nativeTree || !wasmTree) throw new Error("parse failed")
+
+        for (const makeEdit of EDITS) {
+            const [newText, edit] = applyEdit(text, makeEdit(text))
+            nativeTree.edit(edit)
+            wasmTree.edit(edit)
+            // the text of an edited tree is stale, only compare where it now ends
+            expect(nativeTree.rootNode.endIndex).toBe(wasmTree.rootNode.endIndex)
+            expect(nativeTree.rootNode.endPosition).toEqual(wasmTree.rootNode.endPosition)
+
+            const newNativeTree = native.parse(newText, nativeTree)
+            const newWasmTree = wasm.parse(newText, wasmTree)
+            if (!newNativeTree || !newWasmTree) throw new Error("parse failed")
+
+            expect(flatten(newNativeTree)).toEqual(flatten(newWasmTree))
+            expect(nativeTree.getChangedRanges(newNativeTree)).toEqual(
+                wasmTree.getChangedRanges(newWasmTree),
+            )
+
+            nativeTree.delete()
+            wasmTree.delete()
+            text = newText
+            nativeTree = newNativeTree
+            wasmTree = newWasmTree
+        }
+        nativeTree.delete()
+        wasmTree.delete()
+    })
+})
@@ -0,0 +1,59 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import type {Parser} from "web-tree-sitter"
+import {ParserPool} from "./parser"
+
+function fakeParser(): Parser & {resets: number; deleted: boolean} {
+    const parser = {
+        resets: 0,
+        deleted: false,
+        reset() {
+            parser.resets++
+        },
+        delete() {
+            parser.deleted = true
+        },
+    }
+    return parser as unknown as Parser & {resets: number; deleted: boolean}
+}
+
+describe("ParserPool", () => {
+    it("should reuse released parsers", () => {
+        const pool = new ParserPool(fakeParser, 2)
+        const first = pool.use(parser => parser)
+        const second = pool.use(parser => parser)
+        expect(second).toBe(first)
+        expect(pool.stats()).toEqual({alive: 1, inUse: 0, idle: 1, created: 1})
+    })
+
+    it("should reset parsers when they are released", () => {
+        const pool = new ParserPool(fakeParser, 2)
+        const parser = pool.acquire() as ReturnType<typeof fakeParser>
+        expect(parser.resets).toBe(0)
+        pool.release(parser)
+        expect(parser.resets).toBe(1)
+    })
+
+    it("should release parsers when the action throws", () => {
+        const pool = new ParserPool(fakeParser, 2)
+        expect(() =>
+            pool.use(() => {
+                throw new Error("failed")
+            }),
+        ).toThrow("failed")
+        expect(pool.stats()).toEqual({alive: 1, inUse: 0, idle: 1, created: 1})
+    })
+
+    it("should delete parsers above the idle limit", () => {
+        const pool = new ParserPool(fakeParser, 1)
+        const first = pool.acquire() as ReturnType<typeof fakeParser>
+        const second = pool.acquire() as ReturnType<typeof fakeParser>
+        expect(pool.stats()).toEqual({alive: 2, inUse: 2, idle: 0, created: 2})
+
+        pool.release(first)
+        pool.release(second)
+        expect(first.deleted).toBe(false)
+        expect(second.deleted).toBe(true)
+        expect(pool.stats()).toEqual({alive: 1, inUse: 0, idle: 1, created: 2})
+    })
+})
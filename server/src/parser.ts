@@ -1,14 +1,80 @@
 //  SPDX-License-Identifier: MIT
 //  Copyright © 2025 TON Studio
-import {Parser, Language} from "web-tree-sitter"
+import {Parser, Language, Node, Tree, TreeCursor} from "web-tree-sitter"
+import type {ParseOptions, ParseCallback} from "web-tree-sitter"
+import {createRequire} from "node:module"
+import {existsSync} from "node:fs"
+import type {ParserPoolStats} from "@shared/shared-msgtypes"
+import type {Rope} from "@server/utils/Rope"
 
 export let tactLanguage: Language | null = null
 export let tlbLanguage: Language | null = null
 
+/** Declarations of the native addon, `bindings/node/index.d.ts` of the grammar. */
+type NativeTactModule = typeof import("./languages/tact/tree-sitter-tact/bindings/node")
+
+/**
+ * Part of the native `tree-sitter-tact` addon built from `binding.gyp` the server uses.
+ *
+ * Its `parse` also accepts UTF-8 bytes, parsed in place, but the trees then have
+ * byte offsets, so the server only passes it strings and read callbacks.
+ */
+export interface NativeTactBinding {
+    readonly Parser: NativeTactModule["Parser"]
+    /**
+     * Parses many sources on a native thread pool, see `bindings/c/tree-sitter-tact-batch.h`.
+     * Missing in addons built before it was added.
+     */
+    readonly parseBatch?: NativeTactModule["parseBatch"]
+}
+
+/**
+ * Native trees as the `web-tree-sitter` types the rest of the server works with.
+ *
+ * The native classes are declared separately, and only implement the part of the
+ * `web-tree-sitter` API the server calls, so this is the one place where they are
+ * converted. `native-parser.test.ts` checks that both runtimes produce the same
+ * trees and nodes for the same inputs and edits.
+ */
+function asWebTreeSitter<T>(value: unknown): T {
+    return value as T
+}
+
+/**
+ * Native Tact parser, if the addon was found during {@link initParser}.
+ * When `null`, the WASM runtime is used.
+ */
+export let nativeTactBinding: NativeTactBinding | null = null
+
+function loadNativeTactBinding(bindingPath: string): NativeTactBinding | null {
+    if (process.env["TACT_LS_DISABLE_NATIVE_PARSER"] === "true") {
+        return null
+    }
+
+    if (!existsSync(bindingPath)) {
+        return null
+    }
+
+    try {
+        // webpack must not try to bundle the addon, so use a runtime `require`
+        const nodeRequire = createRequire(__filename)
+        const binding = nodeRequire(bindingPath) as Partial<NativeTactBinding>
+        if (typeof binding.Parser !== "function") {
+            console.warn(`${bindingPath} doesn't expose a native parser, using WASM`)
+            return null
+        }
+        return binding as NativeTactBinding
+    } catch (error) {
+        console.warn(`Cannot load native Tact parser from ${bindingPath}, using WASM:`, error)
+        return null
+    }
+}
+
 export const initParser = async (
     treeSitterUri: string,
     tactLangUri: string,
     tlbLangUri: string,
+    tactNativeBindingPath?: string,
 ): Promise<void> => {
     if (tactLanguage && tlbLanguage) {
         return
@@ -19,18 +85,217 @@ export const initParser = async (
         },
     }
     await Parser.init(options)
+    if (process.env["TACT_LS_CHECK_DELETED_TREES"] === "true") {
+        guardDeletedTrees()
+    }
     tactLanguage = await Language.load(tactLangUri)
     tlbLanguage = await Language.load(tlbLangUri)
+
+    if (tactNativeBindingPath !== undefined) {
+        nativeTactBinding = loadNativeTactBinding(tactNativeBindingPath)
+        if (nativeTactBinding) {
+            console.info(`Using native Tact parser from ${tactNativeBindingPath}`)
+        }
+    }
+}
+
+const DELETED: unique symbol = Symbol("deleted")
+
+type MaybeDeletedTree = Tree & {[DELETED]?: true}
+
+let deletedTreesGuarded = false
+
+/**
+ * Makes a deleted WASM tree, and its nodes and cursors, throw when read, as the
+ * native ones do. Otherwise a node kept past the `release()` of its file, see
+ * `File.retain`, silently reads memory `tree.delete()` freed and the WASM heap
+ * may have reused since.
+ *
+ * Every accessor of `web-tree-sitter` is wrapped to check the tree first, which
+ * slows down every node read, so this is only for tests and debugging: jest
+ * installs it through `jest.setup.js`, and the server with
+ * `TACT_LS_CHECK_DELETED_TREES=true`.
+ */
+export function guardDeletedTrees(): void {
+    if (deletedTreesGuarded) return
+    deletedTreesGuarded = true
+
+    // eslint-disable-next-line @typescript-eslint/unbound-method
+    const deleteTree = Tree.prototype.delete
+    Tree.prototype.delete = function (this: MaybeDeletedTree): void {
+        // deleting a tree twice would free its memory twice
+        if (this[DELETED]) return
+        this[DELETED] = true
+        deleteTree.call(this)
+    }
+
+    guardAccessors(Tree.prototype, (tree: Tree) => tree)
+    guardAccessors(Node.prototype, (node: Node) => node.tree)
+    // the tree of a cursor is not part of the declared API, unchecked if it goes away
+    guardAccessors(TreeCursor.prototype, cursor => (cursor as unknown as {tree?: Tree}).tree)
+}
+
+function guardAccessors<T extends object>(
+    prototype: T,
+    treeOf: (self: T) => Tree | undefined,
+): void {
+    const check = (self: T): void => {
+        if ((treeOf(self) as MaybeDeletedTree | undefined)?.[DELETED]) {
+            throw new Error("Tree has been deleted")
+        }
+    }
+
+    for (const [name, descriptor] of Object.entries(Object.getOwnPropertyDescriptors(prototype))) {
+        // trees and cursors still have to be deletable, and `tree` is what is checked
+        if (name === "constructor" || name === "delete" || name === "tree") continue
+
+        const get = descriptor.get
+        const value: unknown = descriptor.value
+        if (get !== undefined) {
+            descriptor.get = function (this: T): unknown {
+                check(this)
+                return Reflect.apply(get, this, []) as unknown
+            }
+        } else if (typeof value === "function") {
+            descriptor.value = function (this: T, ...args: unknown[]): unknown {
+                check(this)
+                return Reflect.apply(value, this, args) as unknown
+            }
+        } else {
+            continue
+        }
+        Object.defineProperty(prototype, name, descriptor)
+    }
 }
 
 export function createTactParser(): Parser {
+    if (nativeTactBinding) {
+        return asWebTreeSitter<Parser>(new nativeTactBinding.Parser())
+    }
+
     const parser = new Parser()
     parser.setLanguage(tactLanguage)
     return parser
 }
 
+/**
+ * Text to parse: either the whole string, or a callback that reads it chunk by
+ * chunk from an index on, so a document kept in pieces is never joined just to
+ * be reparsed.
+ */
+export type TactParseInput = string | ParseCallback
+
+/** Input for parsing `source`, a rope is read chunk by chunk. */
+export function tactParseInput(source: string | Rope): TactParseInput {
+    return typeof source === "string" ? source : (index: number) => source.chunkAt(index)
+}
+
+/**
+ * Parses `sources` in parallel with the native batch parser, or returns `undefined`
+ * when the native addon, or its batch parser, is not available.
+ */
+export function tactParseBatch():
+    | ((sources: readonly string[], options?: {timeoutMicros?: number}) => Promise<(Tree | null)[]>)
+    | undefined {
+    const parseBatch = nativeTactBinding?.parseBatch
+    if (parseBatch === undefined) {
+        return undefined
+    }
+    return async (sources, options) =>
+        asWebTreeSitter<(Tree | null)[]>(await parseBatch(sources, options))
+}
+
 export function createTlbParser(): Parser {
     const parser = new Parser()
     parser.setLanguage(tlbLanguage)
     return parser
 }
+
+/**
+ * Reuses parsers instead of creating one per parse, as creating a parser is not
+ * cheap and, with WASM, grows the heap. A parser is reset when it is returned, so
+ * a cancelled parse is never resumed by the next user. At most `maxIdle` parsers
+ * are kept, others are deleted.
+ */
+export class ParserPool {
+    private readonly idle: Parser[] = []
+    private created: number = 0
+    private deleted: number = 0
+    private inUse: number = 0
+
+    public constructor(
+        private readonly create: () => Parser,
+        private readonly maxIdle: number,
+    ) {}
+
+    public acquire(): Parser {
+        const parser = this.idle.pop() ?? this.newParser()
+        this.inUse++
+        return parser
+    }
+
+    public release(parser: Parser): void {
+        this.inUse--
+        parser.reset()
+        if (this.idle.length < this.maxIdle) {
+            this.idle.push(parser)
+            return
+        }
+        parser.delete()
+        this.deleted++
+    }
+
+    /** Runs `action` with a parser from the pool, the parser must not escape it. */
+    public use<T>(action: (parser: Parser) => T): T {
+        const parser = this.acquire()
+        try {
+            return action(parser)
+        } finally {
+            this.release(parser)
+        }
+    }
+
+    public stats(): ParserPoolStats {
+        return {
+            alive: this.created - this.deleted,
+            inUse: this.inUse,
+            idle: this.idle.length,
+            created: this.created,
+        }
+    }
+
+    private newParser(): Parser {
+        this.created++
+        return this.create()
+    }
+}
+
+const MAX_IDLE_PARSERS = 4
+
+export const tactParsers = new ParserPool(createTactParser, MAX_IDLE_PARSERS)
+export const tlbParsers = new ParserPool(createTlbParser, MAX_IDLE_PARSERS)
+
+/**
+ * Time a single Tact file may take to parse before it is given up on, so one
+ * pathological file cannot stall indexing or the handling of edits.
+ */
+export const TACT_PARSE_TIMEOUT_MS = Number(process.env["TACT_LS_PARSE_TIMEOUT_MS"] ?? 5000)
+
+/**
+ * Options for parsing Tact with {@link TACT_PARSE_TIMEOUT_MS}; the parse returns `null`
+ * when it runs out of time. The native parser checks the deadline itself instead
+ * of calling back into JS.
+ */
+export function tactParseOptions(): ParseOptions {
+    if (nativeTactBinding) {
+        const options: ParseOptions & {timeoutMicros: number} = {
+            timeoutMicros: TACT_PARSE_TIMEOUT_MS * 1000,
+        }
+        return options
+    }
+
+    const deadline = performance.now() + TACT_PARSE_TIMEOUT_MS
+    return {
+        progressCallback: () => performance.now() > deadline,
+    }
+}
@@ -0,0 +1,84 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {Parser, Language} from "web-tree-sitter"
+import {existsSync} from "node:fs"
+import * as path from "node:path"
+import {guardDeletedTrees} from "@server/parser"
+import {File, retainForRequest, retainingFiles} from "./File"
+
+// Runs once the WASM grammar is built (`yarn grammar:tact:wasm`), as it is in CI.
+const grammarWasmPath = path.join(
+    __dirname,
+    "../languages/tact/tree-sitter-tact/tree-sitter-tact.wasm",
+)
+const runtimeWasmPath = path.join(
+    __dirname,
+    "../../../node_modules/web-tree-sitter/tree-sitter.wasm",
+)
+const describeWasm = [grammarWasmPath, runtimeWasmPath].every(file => existsSync(file))
+    ? describe
+    : describe.skip
+
+const SOURCE = "contract Foo {\n    a: Int = 1;\n}\n"
+
+describeWasm("File", () => {
+    let parser: Parser
+
+    beforeAll(async () => {
+        await Parser.init({locateFile: () => runtimeWasmPath})
+        guardDeletedTrees()
+        parser = new Parser()
+        parser.setLanguage(await Language.load(grammarWasmPath))
+    })
+
+    function parseFile(): File {
+        const tree = parser.parse(SOURCE)
+        if (!tree) throw new Error("parse failed")
+        return new File("file:///foo.tact", tree, SOURCE)
+    }
+
+    it("should delete the tree with the last reference", () => {
+        const file = parseFile()
+        const node = file.rootNode.firstChild
+        if (!node) throw new Error("no contract")
+
+        file.retain()
+        expect(file.release()).toBe(false)
+        expect(node.type).toBe("contract")
+
+        expect(file.release()).toBe(true)
+        expect(file.release()).toBe(false)
+        expect(() => file.rootNode).toThrow("Tree has been deleted")
+    })
+
+    it("should throw when nodes and cursors of a released file are read", () => {
+        const file = parseFile()
+        const node = file.rootNode.firstChild
+        const cursor = file.tree.walk()
+        if (!node) throw new Error("no contract")
+        file.release()
+
+        expect(() => node.type).toThrow("Tree has been deleted")
+        expect(() => node.text).toThrow("Tree has been deleted")
+        expect(() => node.children).toThrow("Tree has been deleted")
+        expect(() => node.parent).toThrow("Tree has been deleted")
+        expect(() => cursor.gotoFirstChild()).toThrow("Tree has been deleted")
+        // what the node kept from its creation is not in WASM memory
+        expect(node.startIndex).toBe(0)
+        cursor.delete()
+    })
+
+    it("should keep files alive until the request using them finishes", async () => {
+        const file = parseFile()
+        let node = file.rootNode
+
+        await retainingFiles(() => {
+            node = retainForRequest(file).rootNode
+            // replaced or evicted by the cache in the middle of the request
+            file.release()
+            expect(node.namedChildCount).toBe(1)
+        })()
+
+        expect(() => node.namedChildCount).toThrow("Tree has been deleted")
+    })
+})
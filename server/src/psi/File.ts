@@ -1,16 +1,104 @@
 //  SPDX-License-Identifier: MIT
 //  Copyright © 2025 TON Studio
 import * as path from "node:path"
-import type {Node as SyntaxNode, Tree} from "web-tree-sitter"
+import type {Node as SyntaxNode, Range, Tree} from "web-tree-sitter"
 import {fileURLToPath} from "node:url"
+import {LineIndex, TextLines} from "@server/utils/LineIndex"
+import {Rope} from "@server/utils/Rope"
+import {AsyncLocalStorage} from "node:async_hooks"
+
+// Files retained by the request in progress, see `retainingFiles`.
+const requestFiles: AsyncLocalStorage<Set<File>> = new AsyncLocalStorage()
 
 export class File {
+    private static trees: number = 0
+
+    /**
+     * Number of the tree among all trees parsed by the server. Node ids are only
+     * unique among the nodes of live trees, so they identify a node together with
+     * the generation of its tree.
+     */
+    public readonly generation: number = ++File.trees
+
+    private lineIndex: TextLines | null = null
+    private references: number = 1
+
     public constructor(
         public readonly uri: string,
         public readonly tree: Tree,
-        public readonly content: string,
+        /**
+         * Text of the file. Files of open documents keep the document's rope, so
+         * their text is only flattened into a string if `content` is used.
+         */
+        public readonly source: string | Rope,
+        /**
+         * Ranges whose syntactic structure changed since the previous version of the
+         * file, when it was reparsed incrementally, or `undefined` if it was parsed
+         * from scratch.
+         */
+        public readonly changedRanges: readonly Range[] | undefined = undefined,
+        /**
+         * Version of the open document the file was parsed from, or `undefined` if
+         * it was read from disk.
+         */
+        public readonly version: number | undefined = undefined,
     ) {}
 
+    public get content(): string {
+        return typeof this.source === "string" ? this.source : this.source.toString()
+    }
+
+    public get contentLength(): number {
+        return this.source.length
+    }
+
+    public slice(start: number, end?: number): string {
+        return this.source.slice(start, end)
+    }
+
+    /** Lines of the file, for converting between offsets and positions. */
+    public get lines(): TextLines {
+        this.lineIndex ??= this.source instanceof Rope ? this.source : LineIndex.of(this.source)
+        return this.lineIndex
+    }
+
+    /** Text of `line` without its line break. */
+    public lineText(line: number): string {
+        if (line < 0 || line >= this.lines.lineCount) return ""
+        const text = this.slice(this.lines.lineStart(line), this.lines.lineEnd(line))
+        return text.endsWith("\r") ? text.slice(0, -1) : text
+    }
+
+    /**
+     * Takes another reference to the tree of the file, so it is not deleted
+     * before the matching `release()`. Whoever creates a file owns the first one.
+     */
+    public retain(): this {
+        if (this.references === 0) {
+            throw new Error(`Tree of ${this.uri} is already deleted`)
+        }
+        this.references++
+        return this
+    }
+
+    /**
+     * Drops a reference to the tree of the file, the last one deletes it. Nodes of
+     * a deleted tree throw when read, see `guardDeletedTrees`.
+     * Returns whether the tree was deleted.
+     */
+    public release(): boolean {
+        if (this.references === 0) return false
+        this.references--
+        if (this.references > 0) return false
+        this.tree.delete()
+        return true
+    }
+
+    /** Whether anyone besides the owner of the file holds a reference to its tree. */
+    public get shared(): boolean {
+        return this.references > 1
+    }
+
     public get rootNode(): SyntaxNode {
         return this.tree.rootNode
     }
@@ -23,3 +111,41 @@ export class File {
         return path.basename(this.path, ".tact")
     }
 }
+
+/**
+ * Keeps `file` alive until the request in progress finishes, see
+ * `retainingFiles`. Outside of a request, whoever keeps nodes of the file
+ * around must take its own reference with `File.retain`.
+ */
+export function retainForRequest<T extends File>(file: T): T {
+    const files = requestFiles.getStore()
+    if (files !== undefined && !files.has(file)) {
+        files.add(file.retain())
+    }
+    return file
+}
+
+/**
+ * Wraps a request handler so every file it resolves into, see
+ * `retainForRequest`, stays alive until the handler finishes, even if the file
+ * is replaced or evicted in the meantime.
+ */
+export function retainingFiles<P extends unknown[], R>(
+    handler: (...args: P) => R,
+): (...args: P) => Promise<Awaited<R>> {
+    return async (...args: P): Promise<Awaited<R>> => {
+        // nested handlers share the files of the outer one
+        if (requestFiles.getStore() !== undefined) {
+            return handler(...args)
+        }
+
+        const files: Set<File> = new Set()
+        try {
+            return await requestFiles.run(files, async () => handler(...args))
+        } finally {
+            for (const file of files) {
+                file.release()
+            }
+        }
+    }
+}
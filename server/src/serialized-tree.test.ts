@@ -0,0 +1,119 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {SerializedTree} from "./serialized-tree"
+
+interface TestNode {
+    readonly symbol: number
+    readonly field?: number
+    readonly flags?: number
+    readonly start: number
+    readonly end: number
+    readonly descendants: number
+}
+
+// Writes a tree the way `ts_tact_tree_serialize` does.
+function serialize(symbols: string[], fields: string[], nodes: TestNode[]): Uint8Array {
+    const names = [...symbols, ...fields].map(name => new TextEncoder().encode(name))
+    const namesSize = names.reduce((size, name) => size + 2 + name.length, 0)
+    const nodesOffset = (24 + namesSize + 3) & ~3
+    const data = new Uint8Array(nodesOffset + nodes.length * 16)
+    const view = new DataView(data.buffer)
+
+    data.set(new TextEncoder().encode("TSTB"))
+    view.setUint16(4, 1, true)
+    view.setUint16(6, 1, true)
+    view.setBigUint64(8, 42n, true)
+    view.setUint32(16, nodes.length, true)
+    view.setUint16(20, symbols.length, true)
+    view.setUint16(22, fields.length, true)
+
+    let offset = 24
+    for (const name of names) {
+        view.setUint16(offset, name.length, true)
+        data.set(name, offset + 2)
+        offset += 2 + name.length
+    }
+
+    offset = nodesOffset
+    for (const node of nodes) {
+        view.setUint16(offset, node.symbol, true)
+        view.setUint8(offset + 2, node.field ?? 0)
+        view.setUint8(offset + 3, node.flags ?? 1)
+        view.setUint32(offset + 4, node.start, true)
+        view.setUint32(offset + 8, node.end, true)
+        view.setUint32(offset + 12, node.descendants, true)
+        offset += 16
+    }
+    return data
+}
+
+// contract Foo {}
+const SOURCE = "contract Foo {}"
+const DATA = serialize(
+    ["source_file", "contract", "contract", "type_identifier", "contract_body", "{", "}"],
+    ["name", "body"],
+    [
+        {symbol: 0, start: 0, end: 15, descendants: 6},
+        {symbol: 1, start: 0, end: 15, descendants: 5},
+        {symbol: 2, flags: 0, start: 0, end: 8, descendants: 0},
+        {symbol: 3, field: 1, start: 9, end: 12, descendants: 0},
+        {symbol: 4, field: 2, start: 13, end: 15, descendants: 2},
+        {symbol: 5, flags: 0, start: 13, end: 14, descendants: 0},
+        {symbol: 6, flags: 0, start: 14, end: 15, descendants: 0},
+    ],
+)
+
+describe("SerializedTree", () => {
+    it("should read the header", () => {
+        const tree = SerializedTree.read(DATA)
+        expect(tree.sourceHash).toBe(42n)
+        expect(tree.isUtf16).toBe(true)
+        expect(tree.nodeCount).toBe(7)
+    })
+
+    it("should navigate nodes", () => {
+        const root = SerializedTree.read(DATA).rootNode
+        const contract = root?.firstChild
+        expect(contract?.type).toBe("contract")
+        expect(contract?.children.map(child => child.type)).toEqual([
+            "contract",
+            "type_identifier",
+            "contract_body",
+        ])
+        expect(contract?.namedChildren.length).toBe(2)
+        expect(contract?.childForFieldName("name")?.text(SOURCE)).toBe("Foo")
+        expect(contract?.childForFieldName("body")?.parent?.index).toBe(contract?.index)
+        expect(contract?.nextSibling).toBeNull()
+    })
+
+    it("should visit nodes in preorder", () => {
+        const tree = SerializedTree.read(DATA)
+        const visited: string[] = []
+        tree.visit(0, node => {
+            visited.push(node.type)
+            return node.type !== "contract_body"
+        })
+        expect(visited).toEqual([
+            "source_file",
+            "contract",
+            "contract",
+            "type_identifier",
+            "contract_body",
+        ])
+    })
+
+    it("should reject malformed data", () => {
+        expect(() => SerializedTree.read(DATA.subarray(0, DATA.length - 1))).toThrow()
+        expect(() => SerializedTree.read(new Uint8Array(32))).toThrow()
+
+        const overlapping = serialize(
+            ["a"],
+            [],
+            [
+                {symbol: 0, start: 0, end: 1, descendants: 1},
+                {symbol: 0, start: 0, end: 1, descendants: 1},
+            ],
+        )
+        expect(() => SerializedTree.read(overlapping)).toThrow()
+    })
+})
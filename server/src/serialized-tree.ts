@@ -0,0 +1,301 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+
+/**
+ * Reader for syntax trees serialized by `ts_tact_tree_serialize`, see
+ * `tree-sitter-tact/bindings/c/tree-sitter-tact-serialize.h` for the format.
+ *
+ * Nodes are decoded once into flat typed arrays in preorder, so walking a tree
+ * doesn't allocate anything but the {@link SerializedNode} views handed out.
+ */
+
+export const SERIALIZED_TREE_VERSION = 1
+
+const MAGIC = "TSTB"
+const HEADER_SIZE = 24
+const NODE_SIZE = 16
+const FLAG_UTF16 = 1
+
+const NODE_NAMED = 1
+const NODE_MISSING = 2
+const NODE_EXTRA = 4
+const NODE_ERROR = 8
+const NODE_HAS_ERROR = 16
+
+export class SerializedTree {
+    private parents: Int32Array | null = null
+
+    private constructor(
+        public readonly sourceHash: bigint,
+        /** Whether indices are UTF-16 code units, like in `web-tree-sitter`, rather than bytes. */
+        public readonly isUtf16: boolean,
+        private readonly symbolNames: readonly string[],
+        private readonly fieldNames: readonly string[],
+        private readonly symbols: Uint16Array,
+        private readonly fields: Uint8Array,
+        private readonly flags: Uint8Array,
+        private readonly starts: Uint32Array,
+        private readonly ends: Uint32Array,
+        private readonly descendants: Uint32Array,
+    ) {}
+
+    /**
+     * Decodes a serialized tree, throws if `data` is not a well-formed tree of
+     * {@link SERIALIZED_TREE_VERSION}.
+     */
+    public static read(data: Uint8Array): SerializedTree {
+        const view = new DataView(data.buffer, data.byteOffset, data.byteLength)
+        const magic = String.fromCharCode(...data.subarray(0, 4))
+        if (data.byteLength < HEADER_SIZE || magic !== MAGIC) {
+            throw new Error("Not a serialized Tact syntax tree")
+        }
+
+        const version = view.getUint16(4, true)
+        if (version !== SERIALIZED_TREE_VERSION) {
+            throw new Error(`Unsupported serialized tree version ${version}`)
+        }
+
+        const flags = view.getUint16(6, true)
+        const sourceHash = view.getBigUint64(8, true)
+        const nodeCount = view.getUint32(16, true)
+        const symbolCount = view.getUint16(20, true)
+        const fieldCount = view.getUint16(22, true)
+        if (fieldCount > 0xff) {
+            throw new Error("Malformed serialized tree: too many fields")
+        }
+
+        const decoder = new TextDecoder()
+        const names: string[] = []
+        let offset = HEADER_SIZE
+        for (let i = 0; i < symbolCount + fieldCount; i++) {
+            if (offset + 2 > data.byteLength) {
+                throw new Error("Malformed serialized tree: truncated names")
+            }
+            const length = view.getUint16(offset, true)
+            if (offset + 2 + length > data.byteLength) {
+                throw new Error("Malformed serialized tree: truncated names")
+            }
+            names.push(decoder.decode(data.subarray(offset + 2, offset + 2 + length)))
+            offset += 2 + length
+        }
+
+        offset = (offset + 3) & ~3
+        if (data.byteLength - offset !== nodeCount * NODE_SIZE) {
+            throw new Error("Malformed serialized tree: unexpected size")
+        }
+
+        const tree = new SerializedTree(
+            sourceHash,
+            (flags & FLAG_UTF16) !== 0,
+            names.slice(0, symbolCount),
+            names.slice(symbolCount),
+            new Uint16Array(nodeCount),
+            new Uint8Array(nodeCount),
+            new Uint8Array(nodeCount),
+            new Uint32Array(nodeCount),
+            new Uint32Array(nodeCount),
+            new Uint32Array(nodeCount),
+        )
+
+        for (let i = 0; i < nodeCount; i++, offset += NODE_SIZE) {
+            tree.symbols[i] = view.getUint16(offset, true)
+            tree.fields[i] = view.getUint8(offset + 2)
+            tree.flags[i] = view.getUint8(offset + 3)
+            tree.starts[i] = view.getUint32(offset + 4, true)
+            tree.ends[i] = view.getUint32(offset + 8, true)
+            tree.descendants[i] = view.getUint32(offset + 12, true)
+        }
+
+        tree.validate()
+        return tree
+    }
+
+    public get nodeCount(): number {
+        return this.symbols.length
+    }
+
+    public get rootNode(): SerializedNode | null {
+        return this.nodeCount > 0 ? new SerializedNode(this, 0) : null
+    }
+
+    public node(index: number): SerializedNode {
+        return new SerializedNode(this, index)
+    }
+
+    public type(index: number): string {
+        return this.symbolNames[this.symbols[index]]
+    }
+
+    public fieldName(index: number): string | null {
+        const field = this.fields[index]
+        return field === 0 ? null : this.fieldNames[field - 1]
+    }
+
+    public nodeFlags(index: number): number {
+        return this.flags[index]
+    }
+
+    public startIndex(index: number): number {
+        return this.starts[index]
+    }
+
+    public endIndex(index: number): number {
+        return this.ends[index]
+    }
+
+    public descendantCount(index: number): number {
+        return this.descendants[index]
+    }
+
+    public firstChild(index: number): number {
+        return this.descendants[index] > 0 ? index + 1 : -1
+    }
+
+    public nextSibling(index: number): number {
+        const parent = this.parent(index)
+        if (parent === -1) return -1
+        const next = index + this.descendants[index] + 1
+        return next <= parent + this.descendants[parent] ? next : -1
+    }
+
+    public parent(index: number): number {
+        this.parents ??= this.computeParents()
+        return this.parents[index]
+    }
+
+    /**
+     * Visits `index` and its descendants in preorder, like `RecursiveVisitor`:
+     * returning `false` from `cb` skips the children of a node, `"stop"` ends the walk.
+     */
+    public visit(index: number, cb: (node: SerializedNode) => boolean | "stop"): void {
+        const last = index + this.descendants[index]
+        let current = index
+        while (current <= last) {
+            const result = cb(new SerializedNode(this, current))
+            if (result === "stop") return
+            current += result ? 1 : this.descendants[current] + 1
+        }
+    }
+
+    private computeParents(): Int32Array {
+        const parents = new Int32Array(this.nodeCount)
+        const stack: number[] = []
+        for (let i = 0; i < this.nodeCount; i++) {
+            while (stack.length > 0) {
+                const top = stack[stack.length - 1]
+                if (top + this.descendants[top] >= i) break
+                stack.pop()
+            }
+            parents[i] = stack.length > 0 ? stack[stack.length - 1] : -1
+            stack.push(i)
+        }
+        return parents
+    }
+
+    // Every node's descendants must fit into its parent's, and there must be a single root.
+    private validate(): void {
+        const ends: number[] = []
+        for (let i = 0; i < this.nodeCount; i++) {
+            const last = i + this.descendants[i]
+            while (ends.length > 0 && ends[ends.length - 1] < i) {
+                ends.pop()
+            }
+            if (
+                (i > 0 && ends.length === 0) ||
+                (ends.length > 0 && last > ends[ends.length - 1]) ||
+                last >= this.nodeCount ||
+                this.symbols[i] >= this.symbolNames.length ||
+                this.fields[i] > this.fieldNames.length ||
+                this.starts[i] > this.ends[i]
+            ) {
+                throw new Error(`Malformed serialized tree: invalid node ${i}`)
+            }
+            ends.push(last)
+        }
+    }
+}
+
+/**
+ * A view of a single node of a {@link SerializedTree}, with the subset of the
+ * `web-tree-sitter` node API that doesn't need the source text or positions.
+ */
+export class SerializedNode {
+    public constructor(
+        public readonly tree: SerializedTree,
+        public readonly index: number,
+    ) {}
+
+    public get type(): string {
+        return this.tree.type(this.index)
+    }
+
+    public get fieldName(): string | null {
+        return this.tree.fieldName(this.index)
+    }
+
+    public get isNamed(): boolean {
+        return (this.tree.nodeFlags(this.index) & NODE_NAMED) !== 0
+    }
+
+    public get isMissing(): boolean {
+        return (this.tree.nodeFlags(this.index) & NODE_MISSING) !== 0
+    }
+
+    public get isExtra(): boolean {
+        return (this.tree.nodeFlags(this.index) & NODE_EXTRA) !== 0
+    }
+
+    public get isError(): boolean {
+        return (this.tree.nodeFlags(this.index) & NODE_ERROR) !== 0
+    }
+
+    public get hasError(): boolean {
+        return (this.tree.nodeFlags(this.index) & NODE_HAS_ERROR) !== 0
+    }
+
+    public get startIndex(): number {
+        return this.tree.startIndex(this.index)
+    }
+
+    public get endIndex(): number {
+        return this.tree.endIndex(this.index)
+    }
+
+    public get parent(): SerializedNode | null {
+        return this.at(this.tree.parent(this.index))
+    }
+
+    public get firstChild(): SerializedNode | null {
+        return this.at(this.tree.firstChild(this.index))
+    }
+
+    public get nextSibling(): SerializedNode | null {
+        return this.at(this.tree.nextSibling(this.index))
+    }
+
+    public get children(): SerializedNode[] {
+        const result: SerializedNode[] = []
+        for (let child = this.tree.firstChild(this.index); child !== -1; ) {
+            result.push(new SerializedNode(this.tree, child))
+            child = this.tree.nextSibling(child)
+        }
+        return result
+    }
+
+    public get namedChildren(): SerializedNode[] {
+        return this.children.filter(child => child.isNamed)
+    }
+
+    public childForFieldName(name: string): SerializedNode | null {
+        return this.children.find(child => child.fieldName === name) ?? null
+    }
+
+    /** Text of the node in `source`, the text a tree with UTF-16 indices was parsed from. */
+    public text(source: string): string {
+        return source.slice(this.startIndex, this.endIndex)
+    }
+
+    private at(index: number): SerializedNode | null {
+        return index === -1 ? null : new SerializedNode(this.tree, index)
+    }
+}
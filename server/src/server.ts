@@ -1,8 +1,8 @@
 //  SPDX-License-Identifier: MIT
 //  Copyright © 2025 TON Studio
 import {connection} from "./connection"
-import {DocumentStore} from "./document-store"
-import {initParser} from "./parser"
+import {DocumentStore, RopeDocument} from "./document-store"
+import {initParser, tactParsers, tlbParsers} from "./parser"
 import {asParserPoint} from "@server/utils/position"
 import {TypeInferer} from "./languages/tact/TypeInferer"
 import {index, IndexRoot} from "@server/languages/tact/indexes"
@@ -22,12 +22,16 @@ import {
     SearchByTypeParams,
     SearchByTypeRequest,
     SearchByTypeResponse,
+    ParserStatsRequest,
+    ParserStatsResponse,
     SetToolchainVersionNotification,
     SetToolchainVersionParams,
 } from "@shared/shared-msgtypes"
 import {Logger} from "@server/utils/logger"
 import {CACHE} from "./languages/tact/cache"
 import {IndexingRoot, IndexingRootKind} from "./indexing-root"
+import {IndexingPool} from "@server/indexing-pool"
+import type {IndexingWorkerData} from "@server/indexing-pool"
 import {clearDocumentSettings, getDocumentSettings, TactSettings} from "@server/settings/settings"
 import {WorkspaceEdit} from "vscode-languageserver-types"
 import type {Node as SyntaxNode} from "web-tree-sitter"
@@ -47,14 +51,20 @@ import {
     findTactFile,
     isTactFile,
     PARSED_FILES_CACHE,
+    editTactFile,
     reparseTactFile,
+    setPendingChangesFlusher,
+    setParseTimeoutReporter,
+    parseTimeoutDiagnostic,
 } from "@server/files"
+import {ANALYSIS_DELAY_MS, AnalysisScheduler} from "@server/analysis-scheduler"
 import {provideTactDocumentation} from "@server/languages/tact/documentation"
 import {
     provideTactDefinition,
     provideTactTypeDefinition,
 } from "@server/languages/tact/find-definitions"
-import {File} from "@server/psi/File"
+import {File, retainForRequest, retainingFiles} from "@server/psi/File"
+import type {TactFile} from "@server/languages/tact/psi/TactFile"
 import {
     provideTactCompletion,
     provideTactCompletionResolve,
@@ -103,7 +113,7 @@ async function processPendingEvents(): Promise<void> {
     console.info(`Processing ${pendingFileEvents.length} pending file events`)
 
     for (const event of pendingFileEvents) {
-        await handleFileOpen(event, true)
+        await retainingFiles(handleFileOpen)(event, true)
     }
 
     pendingFileEvents = []
@@ -121,7 +131,20 @@ async function handleFileOpen(
     }
 
     if (isTactFile(uri, event)) {
-        const file = await findTactFile(uri)
+        // Parse the text of the document rather than the file on disk, so changes
+        // made to this version can be applied to the tree incrementally.
+        const document = event.document
+        const cached = PARSED_FILES_CACHE.peek(uri)
+        let file: TactFile
+        if (document instanceof RopeDocument && cached?.version === undefined) {
+            // the file indexed from disk may differ from the document
+            if (index.findFile(uri)) {
+                index.fileChanged(uri)
+            }
+            file = reparseTactFile(uri, document.text, document.version)
+        } else {
+            file = await findTactFile(uri)
+        }
         index.addFile(uri, file)
 
         if (initializationFinished) {
@@ -195,6 +218,23 @@ function findStubs(): string | null {
     return path.join(__dirname, "stubs")
 }
 
+/**
+ * Parser locations for indexing workers, set in `onInitialize`.
+ */
+let indexingWorkerData: IndexingWorkerData | null = null
+
+function createIndexingPool(): IndexingPool | null {
+    if (indexingWorkerData === null || process.env["TACT_LS_DISABLE_INDEXING_WORKERS"] === "true") {
+        return null
+    }
+    try {
+        return IndexingPool.create(`${__dirname}/indexing-worker.js`, indexingWorkerData)
+    } catch (error) {
+        console.warn("Cannot start indexing workers:", error)
+        return null
+    }
+}
+
 async function initialize(): Promise<void> {
     if (!workspaceFolders || workspaceFolders.length === 0 || initialized) {
         // use fallback later, see `initializeFallback`
@@ -242,32 +282,49 @@ async function initialize(): Promise<void> {
         }
     }
 
-    const stdlibPath = await findStdlib(settings, rootDir)
-    if (stdlibPath !== null) {
-        reporter.report(50, "Indexing: (1/3) Standard Library")
-        const stdlibUri = filePathToUri(stdlibPath)
-        index.withStdlibRoot(new IndexRoot("stdlib", stdlibUri))
-
-        const stdlibRoot = new IndexingRoot(stdlibUri, IndexingRootKind.Stdlib)
-        await stdlibRoot.index()
+    const pool = createIndexingPool()
+    if (pool) {
+        console.info(`Indexing on ${pool.size} workers`)
     }
 
-    setProjectStdlibPath(stdlibPath)
+    // reports progress of indexing a root between `from` and `to` percent
+    const progress =
+        (from: number, to: number, message: string) =>
+        (indexed: number, total: number): void => {
+            const percentage = from + Math.floor(((to - from) * indexed) / Math.max(total, 1))
+            reporter.report(percentage, `${message} (${indexed}/${total})`)
+        }
 
-    reporter.report(55, "Indexing: (2/3) Stubs")
-    const stubsPath = findStubs()
-    if (stubsPath !== null) {
-        const stubsUri = filePathToUri(stubsPath)
-        index.withStubsRoot(new IndexRoot("stubs", stubsUri))
+    try {
+        const stdlibPath = await findStdlib(settings, rootDir)
+        if (stdlibPath !== null) {
+            reporter.report(50, "Indexing: (1/3) Standard Library")
+            const stdlibUri = filePathToUri(stdlibPath)
+            index.withStdlibRoot(new IndexRoot("stdlib", stdlibUri))
+
+            const stdlibRoot = new IndexingRoot(stdlibUri, IndexingRootKind.Stdlib)
+            await stdlibRoot.index(pool, progress(50, 55, "Indexing: (1/3) Standard Library"))
+        }
 
-        const stubsRoot = new IndexingRoot(stubsUri, IndexingRootKind.Stdlib)
-        await stubsRoot.index()
-    }
+        setProjectStdlibPath(stdlibPath)
+
+        reporter.report(55, "Indexing: (2/3) Stubs")
+        const stubsPath = findStubs()
+        if (stubsPath !== null) {
+            const stubsUri = filePathToUri(stubsPath)
+            index.withStubsRoot(new IndexRoot("stubs", stubsUri))
+
+            const stubsRoot = new IndexingRoot(stubsUri, IndexingRootKind.Stdlib)
+            await stubsRoot.index(null)
+        }
 
-    reporter.report(80, "Indexing: (3/3) Workspace")
-    index.withRoots([new IndexRoot("workspace", rootUri)])
-    const workspaceRoot = new IndexingRoot(rootUri, IndexingRootKind.Workspace)
-    await workspaceRoot.index()
+        reporter.report(60, "Indexing: (3/3) Workspace")
+        index.withRoots([new IndexRoot("workspace", rootUri)])
+        const workspaceRoot = new IndexingRoot(rootUri, IndexingRootKind.Workspace)
+        await workspaceRoot.index(pool, progress(60, 100, "Indexing: (3/3) Workspace"))
+    } finally {
+        await pool?.terminate()
+    }
 
     reporter.report(100, "Ready")
 
@@ -354,84 +411,130 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
     const treeSitterUri = opts?.treeSitterWasmUri ?? `${__dirname}/tree-sitter.wasm`
     const tactLangUri = opts?.tactLangWasmUri ?? `${__dirname}/tree-sitter-tact.wasm`
     const tlbLangUri = opts?.tlbLangWasmUri ?? `${__dirname}/tree-sitter-tlb.wasm`
-    await initParser(treeSitterUri, tactLangUri, tlbLangUri)
+    const tactNativeBindingPath =
+        opts?.tactLangNativeBindingPath ?? `${__dirname}/tree_sitter_tact_binding.node`
+    await initParser(treeSitterUri, tactLangUri, tlbLangUri, tactNativeBindingPath)
+    indexingWorkerData = {treeSitterUri, tactLangUri, tlbLangUri, tactNativeBindingPath}
 
     const documents = new DocumentStore(connection)
 
-    documents.onDidOpen(async event => {
-        const uri = event.document.uri
-        console.info("open:", uri)
-
-        if (!initialized) {
-            await initializeFallback(uri)
-        }
+    documents.onDidOpen(
+        retainingFiles(async event => {
+            const uri = event.document.uri
+            console.info("open:", uri)
+            PARSED_FILES_CACHE.opened(uri)
 
-        await handleFileOpen(event, false)
-    })
+            if (!initialized) {
+                await initializeFallback(uri)
+            }
 
-    documents.onDidChangeContent(async event => {
-        if (event.document.version === 1) {
-            return
-        }
+            await handleFileOpen(event, false)
+        }),
+    )
 
-        const uri = event.document.uri
-        console.info("changed:", uri)
+    const analysis = new AnalysisScheduler(
+        ANALYSIS_DELAY_MS,
+        uri => {
+            const document = documents.get(uri)
+            if (!document) return
 
-        if (isTactFile(uri, event)) {
             index.fileChanged(uri)
-            const file = reparseTactFile(uri, event.document.getText())
+            const file = editTactFile(
+                uri,
+                document.text,
+                document.version,
+                documents.takeChanges(uri),
+            )
             index.addFile(uri, file, false)
-
-            if (initializationFinished) {
-                await runInspections(uri, file, false) // linters require saved files, see onDidSave
+        },
+        retainingFiles(async (uri, version, token) => {
+            const file = PARSED_FILES_CACHE.peek(uri)
+            if (initializationFinished && file) {
+                // linters require saved files, see onDidSave
+                await runInspections(uri, retainForRequest(file), false, token, version)
             }
-        }
+        }),
+    )
+    setPendingChangesFlusher(uri => {
+        analysis.flush(uri)
+    })
+    setParseTimeoutReporter((uri, timedOut) => {
+        void connection.sendDiagnostics({
+            uri,
+            diagnostics: timedOut ? [parseTimeoutDiagnostic()] : [],
+        })
     })
 
-    documents.onDidSave(async event => {
+    documents.onDidClose(event => {
+        analysis.closed(event.document.uri)
+        PARSED_FILES_CACHE.closed(event.document.uri)
+    })
+
+    documents.onDidChangeContent(event => {
         const uri = event.document.uri
-        if (isTactFile(uri, event)) {
-            if (initializationFinished) {
-                const file = await findTactFile(uri)
-                await runInspections(uri, file, true)
-            }
+        if (event.document.version === 1 || !isTactFile(uri, event)) {
+            documents.takeChanges(uri)
+            return
         }
-    })
 
-    // eslint-disable-next-line @typescript-eslint/no-misused-promises
-    connection.onDidChangeWatchedFiles(async (params: DidChangeWatchedFilesParams) => {
-        for (const change of params.changes) {
-            const uri = change.uri
-            if (!isTactFile(uri)) continue
+        console.info("changed:", uri)
+        analysis.changed(uri, event.document.version)
+    })
 
-            if (change.type === FileChangeType.Created) {
-                console.info(`Find external create of ${uri}`)
-                const file = await findTactFile(uri)
-                index.addFile(uri, file)
-                continue
+    documents.onDidSave(
+        retainingFiles(async event => {
+            const uri = event.document.uri
+            if (isTactFile(uri, event)) {
+                if (initializationFinished) {
+                    const file = await findTactFile(uri)
+                    await runInspections(
+                        uri,
+                        file,
+                        true,
+                        analysis.token(uri),
+                        event.document.version,
+                    )
+                }
             }
+        }),
+    )
 
-            if (!PARSED_FILES_CACHE.has(uri)) {
-                // we don't care about non-parsed files
-                continue
-            }
+    connection.onDidChangeWatchedFiles(
+        // eslint-disable-next-line @typescript-eslint/no-misused-promises
+        retainingFiles(async (params: DidChangeWatchedFilesParams) => {
+            for (const change of params.changes) {
+                const uri = change.uri
+                if (!isTactFile(uri)) continue
+
+                if (change.type === FileChangeType.Created) {
+                    console.info(`Find external create of ${uri}`)
+                    const file = await findTactFile(uri)
+                    index.addFile(uri, file)
+                    continue
+                }
 
-            if (change.type === FileChangeType.Changed) {
-                console.info(`Find external change of ${uri}`)
-                index.fileChanged(uri)
-                const file = await findTactFile(uri, true)
-                index.addFile(uri, file, false)
-            }
+                if (!PARSED_FILES_CACHE.has(uri)) {
+                    // we don't care about non-parsed files
+                    continue
+                }
 
-            if (change.type === FileChangeType.Deleted) {
-                console.info(`Find external delete of ${uri}`)
-                index.removeFile(uri)
+                if (change.type === FileChangeType.Changed) {
+                    console.info(`Find external change of ${uri}`)
+                    index.fileChanged(uri)
+                    const file = await findTactFile(uri, true)
+                    index.addFile(uri, file, false)
+                }
+
+                if (change.type === FileChangeType.Deleted) {
+                    console.info(`Find external delete of ${uri}`)
+                    index.removeFile(uri)
+                }
             }
-        }
-    })
+        }),
+    )
 
-    connection.onRequest("workspace/willRenameFiles", processFileRenaming)
-    connection.onNotification("workspace/didRenameFiles", onFileRenamed)
+    connection.onRequest("workspace/willRenameFiles", retainingFiles(processFileRenaming))
+    connection.onNotification("workspace/didRenameFiles", retainingFiles(onFileRenamed))
 
     // eslint-disable-next-line @typescript-eslint/no-misused-promises
     connection.onDidChangeConfiguration(async () => {
@@ -492,48 +595,55 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
         return null
     }
 
-    connection.onRequest(lsp.HoverRequest.type, provideDocumentation)
+    connection.onRequest(lsp.HoverRequest.type, retainingFiles(provideDocumentation))
 
     connection.onRequest(
         lsp.DefinitionRequest.type,
-        async (params: lsp.DefinitionParams): Promise<lsp.Location[] | lsp.LocationLink[]> => {
-            const uri = params.textDocument.uri
+        retainingFiles(
+            async (params: lsp.DefinitionParams): Promise<lsp.Location[] | lsp.LocationLink[]> => {
+                const uri = params.textDocument.uri
 
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
-                const hoverNode = nodeAtPosition(params, file)
-                if (!hoverNode) return []
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
+                    const hoverNode = nodeAtPosition(params, file)
+                    if (!hoverNode) return []
 
-                return provideTactDefinition(hoverNode, file)
-            }
+                    return provideTactDefinition(hoverNode, file)
+                }
 
-            return []
-        },
+                return []
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.TypeDefinitionRequest.type,
-        async (
-            params: lsp.TypeDefinitionParams,
-        ): Promise<lsp.Definition | lsp.DefinitionLink[]> => {
-            const uri = params.textDocument.uri
-
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
-                const hoverNode = nodeAtPosition(params, file)
-                if (!hoverNode) return []
-
-                return provideTactTypeDefinition(hoverNode, file)
-            }
+        retainingFiles(
+            async (
+                params: lsp.TypeDefinitionParams,
+            ): Promise<lsp.Definition | lsp.DefinitionLink[]> => {
+                const uri = params.textDocument.uri
+
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
+                    const hoverNode = nodeAtPosition(params, file)
+                    if (!hoverNode) return []
+
+                    return provideTactTypeDefinition(hoverNode, file)
+                }
 
-            return []
-        },
+                return []
+            },
+        ),
     )
 
-    connection.onRequest(lsp.CompletionResolveRequest.type, provideTactCompletionResolve)
+    connection.onRequest(
+        lsp.CompletionResolveRequest.type,
+        retainingFiles(provideTactCompletionResolve),
+    )
     connection.onRequest(
         lsp.CompletionRequest.type,
-        async (params: lsp.CompletionParams): Promise<lsp.CompletionItem[]> => {
+        retainingFiles(async (params: lsp.CompletionParams): Promise<lsp.CompletionItem[]> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -542,12 +652,12 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return []
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.InlayHintRequest.type,
-        async (params: lsp.InlayHintParams): Promise<lsp.InlayHint[] | null> => {
+        retainingFiles(async (params: lsp.InlayHintParams): Promise<lsp.InlayHint[] | null> => {
             const uri = params.textDocument.uri
             const settings = await getDocumentSettings(uri)
             if (settings.hints.disable || !initializationFinished) {
@@ -560,30 +670,32 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return null
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.ImplementationRequest.type,
-        async (
-            params: lsp.ImplementationParams,
-        ): Promise<lsp.Definition | lsp.LocationLink[] | null> => {
-            const uri = params.textDocument.uri
-
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
-                const elementNode = nodeAtPosition(params, file)
-                if (!elementNode) return []
-                return provideTactImplementations(elementNode, file)
-            }
+        retainingFiles(
+            async (
+                params: lsp.ImplementationParams,
+            ): Promise<lsp.Definition | lsp.LocationLink[] | null> => {
+                const uri = params.textDocument.uri
+
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
+                    const elementNode = nodeAtPosition(params, file)
+                    if (!elementNode) return []
+                    return provideTactImplementations(elementNode, file)
+                }
 
-            return null
-        },
+                return null
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.RenameRequest.type,
-        async (params: lsp.RenameParams): Promise<WorkspaceEdit | null> => {
+        retainingFiles(async (params: lsp.RenameParams): Promise<WorkspaceEdit | null> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -592,49 +704,55 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return null
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.PrepareRenameRequest.type,
-        async (params: lsp.PrepareRenameParams): Promise<lsp.PrepareRenameResult | null> => {
-            const uri = params.textDocument.uri
+        retainingFiles(
+            async (params: lsp.PrepareRenameParams): Promise<lsp.PrepareRenameResult | null> => {
+                const uri = params.textDocument.uri
 
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
 
-                const result = provideTactRenamePrepare(params, file)
-                if (typeof result === "string") {
-                    showErrorMessage(result)
-                    return null
-                }
+                    const result = provideTactRenamePrepare(params, file)
+                    if (typeof result === "string") {
+                        showErrorMessage(result)
+                        return null
+                    }
 
-                return result
-            }
+                    return result
+                }
 
-            return null
-        },
+                return null
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.DocumentHighlightRequest.type,
-        async (params: lsp.DocumentHighlightParams): Promise<lsp.DocumentHighlight[] | null> => {
-            const uri = params.textDocument.uri
-
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
-                const node = nodeAtPosition(params, file)
-                if (!node) return null
-                return provideTactDocumentHighlight(node, file)
-            }
+        retainingFiles(
+            async (
+                params: lsp.DocumentHighlightParams,
+            ): Promise<lsp.DocumentHighlight[] | null> => {
+                const uri = params.textDocument.uri
+
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
+                    const node = nodeAtPosition(params, file)
+                    if (!node) return null
+                    return provideTactDocumentHighlight(node, file)
+                }
 
-            return null
-        },
+                return null
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.ReferencesRequest.type,
-        async (params: lsp.ReferenceParams): Promise<lsp.Location[] | null> => {
+        retainingFiles(async (params: lsp.ReferenceParams): Promise<lsp.Location[] | null> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -645,54 +763,60 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return null
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.SignatureHelpRequest.type,
-        async (params: lsp.SignatureHelpParams): Promise<lsp.SignatureHelp | null> => {
-            const uri = params.textDocument.uri
+        retainingFiles(
+            async (params: lsp.SignatureHelpParams): Promise<lsp.SignatureHelp | null> => {
+                const uri = params.textDocument.uri
 
-            if (isTactFile(uri)) {
-                return provideTactSignatureInfo(params)
-            }
+                if (isTactFile(uri)) {
+                    return provideTactSignatureInfo(params)
+                }
 
-            return null
-        },
+                return null
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.FoldingRangeRequest.type,
-        async (params: lsp.FoldingRangeParams): Promise<lsp.FoldingRange[] | null> => {
-            const uri = params.textDocument.uri
+        retainingFiles(
+            async (params: lsp.FoldingRangeParams): Promise<lsp.FoldingRange[] | null> => {
+                const uri = params.textDocument.uri
 
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
-                return provideTactFoldingRanges(file)
-            }
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
+                    return provideTactFoldingRanges(file)
+                }
 
-            return null
-        },
+                return null
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.SemanticTokensRequest.type,
-        async (params: lsp.SemanticTokensParams): Promise<lsp.SemanticTokens | null> => {
-            const uri = params.textDocument.uri
-            const settings = await getDocumentSettings(uri)
+        retainingFiles(
+            async (params: lsp.SemanticTokensParams): Promise<lsp.SemanticTokens | null> => {
+                const uri = params.textDocument.uri
+                const settings = await getDocumentSettings(uri)
 
-            if (isTactFile(uri)) {
-                const file = await findTactFile(uri)
-                return provideTactSemanticTokens(file, settings.highlighting)
-            }
+                if (isTactFile(uri)) {
+                    const file = await findTactFile(uri)
+                    return provideTactSemanticTokens(file, settings.highlighting)
+                }
 
-            return null
-        },
+                return null
+            },
+        ),
     )
 
     connection.onRequest(
         lsp.CodeLensRequest.type,
-        async (params: lsp.CodeLensParams): Promise<lsp.CodeLens[] | null> => {
+        retainingFiles(async (params: lsp.CodeLensParams): Promise<lsp.CodeLens[] | null> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -702,19 +826,19 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return null
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.ExecuteCommandRequest.type,
-        async (params: lsp.ExecuteCommandParams): Promise<string | null> => {
+        retainingFiles(async (params: lsp.ExecuteCommandParams): Promise<string | null> => {
             return provideExecuteTactCommand(params)
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.CodeActionRequest.type,
-        async (params: lsp.CodeActionParams): Promise<lsp.CodeAction[] | null> => {
+        retainingFiles(async (params: lsp.CodeActionParams): Promise<lsp.CodeAction[] | null> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -723,12 +847,12 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return null
-        },
+        }),
     )
 
     connection.onRequest(
         lsp.DocumentSymbolRequest.type,
-        async (params: lsp.DocumentSymbolParams): Promise<lsp.DocumentSymbol[]> => {
+        retainingFiles(async (params: lsp.DocumentSymbolParams): Promise<lsp.DocumentSymbol[]> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -737,60 +861,61 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return []
-        },
+        }),
     )
 
-    connection.onRequest(lsp.WorkspaceSymbolRequest.type, provideTactWorkspaceSymbols)
+    connection.onRequest(
+        lsp.WorkspaceSymbolRequest.type,
+        retainingFiles(provideTactWorkspaceSymbols),
+    )
 
     connection.onRequest(
         lsp.DocumentFormattingRequest.type,
-        async (params: lsp.DocumentFormattingParams): Promise<lsp.TextEdit[] | null> => {
-            const uri = params.textDocument.uri
+        retainingFiles(
+            async (params: lsp.DocumentFormattingParams): Promise<lsp.TextEdit[] | null> => {
+                const uri = params.textDocument.uri
 
-            const file = await findTactFile(uri)
-            const formatted = formatCode(file.content)
+                const file = await findTactFile(uri)
+                const formatted = formatCode(file.content)
 
-            if (formatted.$ === "FormattedCode") {
-                if (formatted.code === file.content) {
-                    // already formatted
-                    return null
-                }
+                if (formatted.$ === "FormattedCode") {
+                    if (formatted.code === file.content) {
+                        // already formatted
+                        return null
+                    }
 
-                const lines = file.content.split("\n")
-                return [
-                    {
-                        range: {
-                            start: {
-                                line: 0,
-                                character: 0,
-                            },
-                            end: {
-                                line: lines.length,
-                                character: (lines.at(-1) ?? "").length,
+                    return [
+                        {
+                            range: {
+                                start: {
+                                    line: 0,
+                                    character: 0,
+                                },
+                                end: file.lines.positionAt(file.contentLength),
                             },
+                            newText: formatted.code,
                         },
-                        newText: formatted.code,
-                    },
-                ]
-            }
+                    ]
+                }
 
-            if (formatted.message === "cannot parse code") {
-                showErrorMessage(`Cannot format file: ${formatted.message}`)
-                return null
-            }
+                if (formatted.message === "cannot parse code") {
+                    showErrorMessage(`Cannot format file: ${formatted.message}`)
+                    return null
+                }
 
-            showErrorMessage(
-                `Cannot format file: ${formatted.message}, please open a new issue with the file content: https://github.com/tact-lang/tact-language-server/issues`,
-            )
-            return null
-        },
+                showErrorMessage(
+                    `Cannot format file: ${formatted.message}, please open a new issue with the file content: https://github.com/tact-lang/tact-language-server/issues`,
+                )
+                return null
+            },
+        ),
     )
 
     // Custom LSP requests
 
     connection.onRequest(
         TypeAtPositionRequest,
-        async (params: TypeAtPositionParams): Promise<TypeAtPositionResponse> => {
+        retainingFiles(async (params: TypeAtPositionParams): Promise<TypeAtPositionResponse> => {
             const uri = params.textDocument.uri
 
             if (isTactFile(uri)) {
@@ -799,15 +924,18 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
             }
 
             return {type: null, range: null}
-        },
+        }),
     )
 
-    connection.onRequest(DocumentationAtPositionRequest, provideDocumentation)
-    connection.onRequest(GasConsumptionForSelectionRequest, provideSelectionGasConsumption)
+    connection.onRequest(DocumentationAtPositionRequest, retainingFiles(provideDocumentation))
+    connection.onRequest(
+        GasConsumptionForSelectionRequest,
+        retainingFiles(provideSelectionGasConsumption),
+    )
 
     connection.onRequest(
         SearchByTypeRequest,
-        (params: SearchByTypeParams): SearchByTypeResponse => {
+        retainingFiles((params: SearchByTypeParams): SearchByTypeResponse => {
             try {
                 const results = TypeBasedSearch.search(params.query)
                 return {
@@ -821,7 +949,15 @@ connection.onInitialize(async (initParams: lsp.InitializeParams): Promise<lsp.In
                     error: error instanceof Error ? error.message : "Unknown error",
                 }
             }
-        },
+        }),
+    )
+
+    connection.onRequest(
+        ParserStatsRequest,
+        (): ParserStatsResponse => ({
+            tact: tactParsers.stats(),
+            tlb: tlbParsers.stats(),
+        }),
     )
 
     // eslint-disable-next-line @typescript-eslint/unbound-method
@@ -0,0 +1,50 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {LineIndex} from "./LineIndex"
+
+describe("LineIndex", () => {
+    const text = "fun foo() {\r\n    let a = \"✓𝄞\";\n}\n"
+    const index = LineIndex.of(text)
+
+    it("should find line starts", () => {
+        expect(index.lineCount).toBe(4)
+        expect(index.lineStart(1)).toBe(13)
+        expect(index.lineEnd(0)).toBe(12)
+        expect(index.lineEnd(3)).toBe(text.length)
+    })
+
+    it("should convert positions to offsets", () => {
+        expect(index.offsetAt({line: 0, character: 4})).toBe(4)
+        expect(index.offsetAt({line: 1, character: 13})).toBe(text.indexOf("✓"))
+        // a surrogate pair is two code units
+        expect(index.offsetAt({line: 1, character: 16})).toBe(text.indexOf('";'))
+        expect(index.offsetAt({line: 2, character: 0})).toBe(text.indexOf("}"))
+    })
+
+    it("should clamp positions", () => {
+        expect(index.offsetAt({line: 0, character: 100})).toBe(12)
+        expect(index.offsetAt({line: -1, character: 0})).toBe(0)
+        expect(index.offsetAt({line: 10, character: 0})).toBe(text.length)
+    })
+
+    it("should convert offsets to positions", () => {
+        expect(index.positionAt(0)).toEqual({line: 0, character: 0})
+        expect(index.positionAt(12)).toEqual({line: 0, character: 12})
+        expect(index.positionAt(13)).toEqual({line: 1, character: 0})
+        expect(index.positionAt(text.length)).toEqual({line: 3, character: 0})
+        expect(index.positionAt(text.length + 10)).toEqual({line: 3, character: 0})
+    })
+
+    it("should round-trip every offset", () => {
+        for (let offset = 0; offset <= text.length; offset++) {
+            expect(index.offsetAt(index.positionAt(offset))).toBe(offset)
+        }
+    })
+
+    it("should handle empty text", () => {
+        const empty = LineIndex.of("")
+        expect(empty.lineCount).toBe(1)
+        expect(empty.offsetAt({line: 0, character: 5})).toBe(0)
+        expect(empty.positionAt(3)).toEqual({line: 0, character: 0})
+    })
+})
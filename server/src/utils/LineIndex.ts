@@ -0,0 +1,80 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import type * as lsp from "vscode-languageserver"
+
+/** Conversions between offsets and positions in a text, see {@link LineIndex}. */
+export interface TextLines {
+    readonly lineCount: number
+    lineStart(line: number): number
+    lineEnd(line: number): number
+    offsetAt(position: lsp.Position): number
+    positionAt(offset: number): lsp.Position
+}
+
+/**
+ * Start offsets of the lines of a text, for converting between offsets and
+ * positions in O(log n).
+ *
+ * Offsets and characters are UTF-16 code units, as in JS strings, LSP positions
+ * and `web-tree-sitter` points. Like tree-sitter, only `\n` ends a line, so a
+ * `\r` before it stays part of the line.
+ */
+export class LineIndex implements TextLines {
+    private constructor(
+        private readonly length: number,
+        private readonly lineStarts: Uint32Array,
+    ) {}
+
+    public static of(text: string): LineIndex {
+        const starts: number[] = [0]
+        for (let i = text.indexOf("\n"); i !== -1; i = text.indexOf("\n", i + 1)) {
+            starts.push(i + 1)
+        }
+        return new LineIndex(text.length, Uint32Array.from(starts))
+    }
+
+    public get lineCount(): number {
+        return this.lineStarts.length
+    }
+
+    public lineStart(line: number): number {
+        return this.lineStarts[line]
+    }
+
+    /** Offset of the `\n` ending `line`, or of the end of the text for the last line. */
+    public lineEnd(line: number): number {
+        return line + 1 < this.lineStarts.length ? this.lineStarts[line + 1] - 1 : this.length
+    }
+
+    /**
+     * Offset of `position`. Positions past the end of their line are clamped to it,
+     * positions before or after the text to its start or end.
+     */
+    public offsetAt(position: lsp.Position): number {
+        if (position.line < 0) return 0
+        if (position.line >= this.lineStarts.length) return this.length
+
+        const start = this.lineStarts[position.line]
+        const character = Math.max(position.character, 0)
+        return Math.min(start + character, this.lineEnd(position.line))
+    }
+
+    /** Position of `offset`, clamped to the text. */
+    public positionAt(offset: number): lsp.Position {
+        const clamped = Math.max(0, Math.min(offset, this.length))
+
+        // the last line starting at or before `clamped`
+        let low = 0
+        let high = this.lineStarts.length - 1
+        while (low < high) {
+            const mid = (low + high + 1) >>> 1
+            if (this.lineStarts[mid] <= clamped) {
+                low = mid
+            } else {
+                high = mid - 1
+            }
+        }
+
+        return {line: low, character: clamped - this.lineStarts[low]}
+    }
+}
@@ -0,0 +1,85 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import {Rope} from "./Rope"
+import {LineIndex} from "./LineIndex"
+
+// Deterministic pseudo-random numbers, so failures can be reproduced.
+function random(seed: number): (max: number) => number {
+    let state = seed
+    return max => {
+        state = (state * 1_103_515_245 + 12_345) % 2_147_483_648
+        return state % max
+    }
+}
+
+function randomText(next: (max: number) => number, length: number): string {
+    const alphabet = "abc \n✓𝄞{}"
+    let text = ""
+    while (text.length < length) {
+        text += alphabet[next(alphabet.length)]
+    }
+    return text
+}
+
+describe("Rope", () => {
+    it("should match string edits", () => {
+        const next = random(42)
+        let expected = randomText(next, 5000)
+        let rope = Rope.fromString(expected)
+
+        for (let i = 0; i < 2000; i++) {
+            const start = next(expected.length + 1)
+            const end = start + next(Math.min(expected.length - start, 3000) + 1)
+            const text = randomText(next, next(5) === 0 ? next(4000) : next(10))
+
+            expected = expected.slice(0, start) + text + expected.slice(end)
+            rope = rope.replace(start, end, text)
+            expect(rope.length).toBe(expected.length)
+        }
+
+        expect(rope.toString()).toBe(expected)
+        expect(rope.slice(100, 2100)).toBe(expected.slice(100, 2100))
+        expect([...rope.chunks()].join("")).toBe(expected)
+    })
+
+    it("should keep previous versions intact", () => {
+        const first = Rope.fromString("a".repeat(10_000))
+        const second = first.replace(5000, 5001, "b\nc")
+        expect(first.toString()).toBe("a".repeat(10_000))
+        expect(second.slice(4999, 5004)).toBe("ab\nca")
+    })
+
+    it("should convert positions like LineIndex", () => {
+        const next = random(7)
+        let text = randomText(next, 3000)
+        let rope = Rope.fromString(text)
+        for (let i = 0; i < 100; i++) {
+            const start = next(text.length + 1)
+            const inserted = randomText(next, next(50))
+            text = text.slice(0, start) + inserted + text.slice(start)
+            rope = rope.replace(start, start, inserted)
+        }
+
+        const lines = LineIndex.of(text)
+        expect(rope.lineCount).toBe(lines.lineCount)
+        for (let offset = 0; offset <= text.length; offset += 7) {
+            const position = lines.positionAt(offset)
+            expect(rope.positionAt(offset)).toEqual(position)
+            expect(rope.offsetAt(position)).toBe(offset)
+            expect(rope.offsetAt({...position, character: position.character + 1000})).toBe(
+                lines.offsetAt({...position, character: position.character + 1000}),
+            )
+        }
+    })
+
+    it("should read chunks from any index", () => {
+        const text = "x".repeat(3000)
+        const rope = Rope.fromString(text).replace(10, 20, "y")
+        let read = ""
+        for (let chunk = rope.chunkAt(0); chunk !== ""; chunk = rope.chunkAt(read.length)) {
+            read += chunk
+        }
+        expect(read).toBe(rope.toString())
+        expect(rope.chunkAt(rope.length)).toBe("")
+    })
+})
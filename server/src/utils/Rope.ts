@@ -0,0 +1,263 @@
+//  SPDX-License-Identifier: MIT
+//  Copyright © 2025 TON Studio
+import type * as lsp from "vscode-languageserver"
+import type {TextLines} from "@server/utils/LineIndex"
+
+// Leaves are split when they grow past twice this size.
+const LEAF_SIZE = 1024
+
+/**
+ * Node of a rope, a leaf with `text` or a branch with both children. Nodes are
+ * never modified, edits copy the path to the changed leaf, so every version of
+ * a document shares all unchanged nodes with the previous one.
+ */
+interface RopeNode {
+    readonly left: RopeNode | null
+    readonly right: RopeNode | null
+    readonly text: string
+    readonly length: number
+    readonly newlines: number
+    readonly height: number
+}
+
+function leaf(text: string): RopeNode {
+    let newlines = 0
+    for (let i = text.indexOf("\n"); i !== -1; i = text.indexOf("\n", i + 1)) {
+        newlines++
+    }
+    return {left: null, right: null, text, length: text.length, newlines, height: 0}
+}
+
+function branch(left: RopeNode, right: RopeNode): RopeNode {
+    return {
+        left,
+        right,
+        text: "",
+        length: left.length + right.length,
+        newlines: left.newlines + right.newlines,
+        height: Math.max(left.height, right.height) + 1,
+    }
+}
+
+function build(text: string, start: number, end: number): RopeNode {
+    if (end - start <= LEAF_SIZE) {
+        return leaf(text.slice(start, end))
+    }
+    const leaves = Math.ceil((end - start) / LEAF_SIZE)
+    const middle = start + Math.ceil(leaves / 2) * LEAF_SIZE
+    return branch(build(text, start, middle), build(text, middle, end))
+}
+
+// Restores the AVL invariant of a node whose children differ in height by at most 2.
+function balance(left: RopeNode, right: RopeNode): RopeNode {
+    if (left.height > right.height + 1 && left.left && left.right) {
+        if (left.left.height >= left.right.height) {
+            return branch(left.left, branch(left.right, right))
+        }
+        if (left.right.left && left.right.right) {
+            return branch(branch(left.left, left.right.left), branch(left.right.right, right))
+        }
+    }
+    if (right.height > left.height + 1 && right.left && right.right) {
+        if (right.right.height >= right.left.height) {
+            return branch(branch(left, right.left), right.right)
+        }
+        if (right.left.left && right.left.right) {
+            return branch(branch(left, right.left.left), branch(right.left.right, right.right))
+        }
+    }
+    return branch(left, right)
+}
+
+// Concatenates two balanced trees in O(|height difference|).
+function join(left: RopeNode, right: RopeNode): RopeNode {
+    if (left.length === 0) return right
+    if (right.length === 0) return left
+    if (left.height === 0 && right.height === 0 && left.length + right.length <= LEAF_SIZE) {
+        return leaf(left.text + right.text)
+    }
+    if (left.height > right.height + 1 && left.left && left.right) {
+        return balance(left.left, join(left.right, right))
+    }
+    if (right.height > left.height + 1 && right.left && right.right) {
+        return balance(join(left, right.left), right.right)
+    }
+    return branch(left, right)
+}
+
+function prefix(node: RopeNode, index: number): RopeNode {
+    if (index >= node.length) return node
+    if (!node.left || !node.right) return leaf(node.text.slice(0, index))
+    if (index <= node.left.length) return prefix(node.left, index)
+    return join(node.left, prefix(node.right, index - node.left.length))
+}
+
+function suffix(node: RopeNode, index: number): RopeNode {
+    if (index <= 0) return node
+    if (!node.left || !node.right) return leaf(node.text.slice(index))
+    if (index >= node.left.length) return suffix(node.right, index - node.left.length)
+    return join(suffix(node.left, index), node.right)
+}
+
+function replace(node: RopeNode, start: number, end: number, text: string): RopeNode {
+    if (!node.left || !node.right) {
+        const newText = node.text.slice(0, start) + text + node.text.slice(end)
+        return newText.length <= LEAF_SIZE * 2 ? leaf(newText) : build(newText, 0, newText.length)
+    }
+
+    const leftLength = node.left.length
+    if (end <= leftLength) {
+        return join(replace(node.left, start, end, text), node.right)
+    }
+    if (start >= leftLength) {
+        return join(node.left, replace(node.right, start - leftLength, end - leftLength, text))
+    }
+    const middle = build(text, 0, text.length)
+    return join(join(prefix(node.left, start), middle), suffix(node.right, end - leftLength))
+}
+
+/**
+ * Immutable text stored as a balanced tree of chunks, so edits and conversions
+ * between offsets and positions take O(log n) however large the text is. The
+ * flat string is only built by {@link toString}, and then kept.
+ *
+ * Offsets and characters are UTF-16 code units and only `\n` ends a line, like
+ * in {@link LineIndex}.
+ */
+export class Rope implements TextLines {
+    private flat: string | null = null
+
+    private constructor(private readonly root: RopeNode) {}
+
+    public static fromString(text: string): Rope {
+        const rope = new Rope(build(text, 0, text.length))
+        rope.flat = text
+        return rope
+    }
+
+    public get length(): number {
+        return this.root.length
+    }
+
+    public get lineCount(): number {
+        return this.root.newlines + 1
+    }
+
+    /** Returns a new rope with the text between `start` and `end` replaced with `text`. */
+    public replace(start: number, end: number, text: string): Rope {
+        const from = Math.max(0, Math.min(start, this.length))
+        const to = Math.max(from, Math.min(end, this.length))
+        return new Rope(replace(this.root, from, to, text))
+    }
+
+    /**
+     * The text from `index` to the end of the chunk containing it, or an empty
+     * string at the end of the text. Suitable as a tree-sitter read callback.
+     */
+    public chunkAt(index: number): string {
+        if (index >= this.length) return ""
+        let node = this.root
+        let offset = Math.max(index, 0)
+        while (node.left && node.right) {
+            if (offset < node.left.length) {
+                node = node.left
+            } else {
+                offset -= node.left.length
+                node = node.right
+            }
+        }
+        return node.text.slice(offset)
+    }
+
+    /** Chunks of the text in order. */
+    public *chunks(): Generator<string> {
+        const stack: RopeNode[] = [this.root]
+        for (let node = stack.pop(); node !== undefined; node = stack.pop()) {
+            if (node.left && node.right) {
+                stack.push(node.right, node.left)
+            } else if (node.length > 0) {
+                yield node.text
+            }
+        }
+    }
+
+    public slice(start: number, end: number = this.length): string {
+        if (this.flat !== null) return this.flat.slice(start, end)
+
+        let result = ""
+        for (let index = Math.max(start, 0); index < Math.min(end, this.length); ) {
+            const chunk = this.chunkAt(index).slice(0, end - index)
+            result += chunk
+            index += chunk.length
+        }
+        return result
+    }
+
+    /** Offset of the start of `line`, or the end of the text past the last line. */
+    public lineStart(line: number): number {
+        if (line <= 0) return 0
+        if (line > this.root.newlines) return this.length
+
+        let node = this.root
+        let newlines = line
+        let offset = 0
+        while (node.left && node.right) {
+            if (newlines <= node.left.newlines) {
+                node = node.left
+            } else {
+                newlines -= node.left.newlines
+                offset += node.left.length
+                node = node.right
+            }
+        }
+
+        let index = -1
+        for (let i = 0; i < newlines; i++) {
+            index = node.text.indexOf("\n", index + 1)
+        }
+        return offset + index + 1
+    }
+
+    /** Offset of the `\n` ending `line`, or of the end of the text for the last line. */
+    public lineEnd(line: number): number {
+        return line < this.root.newlines ? this.lineStart(line + 1) - 1 : this.length
+    }
+
+    /** Offset of `position`, clamped like {@link LineIndex.offsetAt}. */
+    public offsetAt(position: lsp.Position): number {
+        if (position.line < 0) return 0
+        if (position.line > this.root.newlines) return this.length
+
+        const start = this.lineStart(position.line)
+        return Math.min(start + Math.max(position.character, 0), this.lineEnd(position.line))
+    }
+
+    /** Position of `offset`, clamped to the text. */
+    public positionAt(offset: number): lsp.Position {
+        const target = Math.max(0, Math.min(offset, this.length))
+
+        let node = this.root
+        let index = target
+        let line = 0
+        while (node.left && node.right) {
+            if (index < node.left.length) {
+                node = node.left
+            } else {
+                index -= node.left.length
+                line += node.left.newlines
+                node = node.right
+            }
+        }
+        for (let i = node.text.indexOf("\n"); i !== -1 && i < index; ) {
+            line++
+            i = node.text.indexOf("\n", i + 1)
+        }
+
+        return {line, character: target - this.lineStart(line)}
+    }
+
+    public toString(): string {
+        this.flat ??= [...this.chunks()].join("")
+        return this.flat
+    }
+}
@@ -12,4 +12,6 @@ export interface ClientOptions {
     readonly treeSitterWasmUri: string
     readonly tactLangWasmUri: string
     readonly tlbLangWasmUri: string
+    /** Path to the native `tree-sitter-tact` addon, preferred over the WASM parser when present */
+    readonly tactLangNativeBindingPath?: string
 }
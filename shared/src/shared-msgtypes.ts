@@ -7,6 +7,7 @@ export const DocumentationAtPositionRequest = "tact/executeHoverProvider"
 export const SetToolchainVersionNotification = "tact/setToolchainVersion"
 export const GasConsumptionForSelectionRequest = "tact/executeGetGasConsumptionForSelection"
 export const SearchByTypeRequest = "tact/searchByType"
+export const ParserStatsRequest = "tact/getParserStats"
 
 export interface TypeAtPositionParams {
     readonly textDocument: {
@@ -77,3 +78,17 @@ export interface SearchByTypeResponse {
     readonly results: TypeSearchResult[]
     readonly error: string | null
 }
+
+export interface ParserPoolStats {
+    /** Parsers created and not deleted yet, idle or in use. */
+    readonly alive: number
+    readonly inUse: number
+    readonly idle: number
+    /** Parsers created since startup, a steadily growing number means the pool is too small. */
+    readonly created: number
+}
+
+export interface ParserStatsResponse {
+    readonly tact: ParserPoolStats
+    readonly tlb: ParserPoolStats
+}
@@ -17,6 +17,7 @@ const config = {
 
     entry: {
         server: "./server/src/server.ts",
+        "indexing-worker": "./server/src/indexing-worker.ts",
         client: "./client/src/extension.ts",
     }, // the entry point of this extension, 📖 -> https://webpack.js.org/configuration/entry-context/
     output: {
@@ -69,6 +70,11 @@ const config = {
                     from: "./server/src/languages/tact/tree-sitter-tact/tree-sitter-tact.wasm",
                     to: distDir,
                 },
+                {
+                    from: "./server/src/languages/tact/tree-sitter-tact/build/Release/tree_sitter_tact_binding.node",
+                    to: distDir,
+                    noErrorOnMissing: true,
+                },
                 {
                     from: "./server/src/languages/tlb/tree-sitter-tlb/tree-sitter-tlb.wasm",
                     to: distDir,